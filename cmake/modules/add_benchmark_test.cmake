@@ -0,0 +1,11 @@
+# SPDX-FileCopyrightText: 2026 agent <agent@local>
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Adds a test whose benchmarks are run by hand, with the same arguments as ecm_add_test().
+#
+# The test functions whose name starts with "benchmark" are skipped when the test runs as part
+# of the test suite, see KALENDAR_SKIP_BENCHMARKS() in src/lib/benchmarkhelper.h.
+function(add_benchmark_test)
+    ecm_add_test(${ARGN} TEST_NAME_VAR _test_name)
+    set_tests_properties(${_test_name} PROPERTIES ENVIRONMENT "KALENDAR_SKIP_BENCHMARKS=1")
+endfunction()
@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "attendeecontactresolver.h"
+#include "kalendar_calendar_debug.h"
+
+#include <Akonadi/ItemFetchScope>
+#include <Akonadi/ItemSearchJob>
+#include <Akonadi/Monitor>
+#include <Akonadi/SearchQuery>
+#include <KContacts/Addressee>
+
+AttendeeContactResolver::AttendeeContactResolver(QObject *parent)
+    : QObject(parent)
+    , m_monitor(new Akonadi::Monitor(this))
+{
+    m_monitor->setObjectName(QStringLiteral("AttendeeContactResolverMonitor"));
+    m_monitor->setMimeTypeMonitored(KContacts::Addressee::mimeType());
+    m_monitor->itemFetchScope().fetchFullPayload();
+
+    const auto contactChanged = [this](const Akonadi::Item &item) {
+        QSet<QString> changedEmails;
+        updateContact(item, changedEmails);
+        if (!changedEmails.isEmpty()) {
+            Q_EMIT resolved(changedEmails.values());
+        }
+    };
+    connect(m_monitor, &Akonadi::Monitor::itemAdded, this, contactChanged);
+    connect(m_monitor, &Akonadi::Monitor::itemChanged, this, contactChanged);
+    connect(m_monitor, &Akonadi::Monitor::itemRemoved, this, [this](const Akonadi::Item &item) {
+        QSet<QString> changedEmails;
+        removeContact(item.id(), changedEmails);
+        if (!changedEmails.isEmpty()) {
+            Q_EMIT resolved(changedEmails.values());
+        }
+    });
+}
+
+AttendeeContactResolver *AttendeeContactResolver::instance()
+{
+    static auto resolver = new AttendeeContactResolver;
+    return resolver;
+}
+
+QString AttendeeContactResolver::normalizedEmail(const QString &email)
+{
+    return email.trimmed().toLower();
+}
+
+bool AttendeeContactResolver::isResolved(const QString &email) const
+{
+    return m_contactIds.contains(normalizedEmail(email));
+}
+
+QVector<Akonadi::Item::Id> AttendeeContactResolver::contactIds(const QString &email) const
+{
+    return m_contactIds.value(normalizedEmail(email));
+}
+
+void AttendeeContactResolver::resolve(const QStringList &emails)
+{
+    QStringList unresolvedEmails;
+    for (const auto &email : emails) {
+        const auto normalized = normalizedEmail(email);
+        if (normalized.isEmpty() || m_contactIds.contains(normalized) || m_pending.contains(normalized)) {
+            continue;
+        }
+        m_pending.insert(normalized);
+        unresolvedEmails << normalized;
+    }
+    if (unresolvedEmails.isEmpty()) {
+        return;
+    }
+
+    Akonadi::SearchQuery query(Akonadi::SearchTerm::RelOr);
+    for (const auto &email : std::as_const(unresolvedEmails)) {
+        query.addTerm(Akonadi::ContactSearchTerm(Akonadi::ContactSearchTerm::Email, email, Akonadi::SearchTerm::CondEqual));
+    }
+
+    auto job = new Akonadi::ItemSearchJob(query, this);
+    job->setMimeTypes({KContacts::Addressee::mimeType()});
+    job->fetchScope().fetchFullPayload();
+    connect(job, &Akonadi::ItemSearchJob::result, this, [this, job, unresolvedEmails]() {
+        for (const auto &email : unresolvedEmails) {
+            m_pending.remove(email);
+        }
+        if (job->error()) {
+            // Not remembered, so the next resolve() tries again
+            qCWarning(KALENDAR_CALENDAR_LOG) << "Error searching contacts of attendees:" << job->errorString();
+            return;
+        }
+
+        QSet<QString> changedEmails;
+        for (const auto &email : unresolvedEmails) {
+            m_contactIds.insert(email, {});
+            changedEmails.insert(email);
+        }
+        const auto items = job->items();
+        for (const auto &item : items) {
+            updateContact(item, changedEmails);
+        }
+        Q_EMIT resolved(changedEmails.values());
+    });
+}
+
+void AttendeeContactResolver::updateContact(const Akonadi::Item &item, QSet<QString> &changedEmails)
+{
+    // Only the addresses we were asked about are tracked
+    QStringList emails;
+    if (item.hasPayload<KContacts::Addressee>()) {
+        const auto contactEmails = item.payload<KContacts::Addressee>().emails();
+        for (const auto &email : contactEmails) {
+            const auto normalized = normalizedEmail(email);
+            if (m_contactIds.contains(normalized) && !emails.contains(normalized)) {
+                emails << normalized;
+            }
+        }
+    }
+
+    const auto previousEmails = m_resolvedEmailsOfContact.value(item.id());
+    for (const auto &email : previousEmails) {
+        if (!emails.contains(email)) {
+            m_contactIds[email].removeAll(item.id());
+            changedEmails.insert(email);
+        }
+    }
+    for (const auto &email : std::as_const(emails)) {
+        if (!previousEmails.contains(email)) {
+            m_contactIds[email].append(item.id());
+            changedEmails.insert(email);
+        }
+    }
+
+    if (emails.isEmpty()) {
+        m_resolvedEmailsOfContact.remove(item.id());
+    } else {
+        m_resolvedEmailsOfContact.insert(item.id(), emails);
+    }
+}
+
+void AttendeeContactResolver::removeContact(Akonadi::Item::Id id, QSet<QString> &changedEmails)
+{
+    const auto emails = m_resolvedEmailsOfContact.take(id);
+    for (const auto &email : emails) {
+        m_contactIds[email].removeAll(id);
+        changedEmails.insert(email);
+    }
+}
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <Akonadi/Item>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QVector>
+
+namespace Akonadi
+{
+class Monitor;
+}
+
+/**
+ * Resolves attendee email addresses to the ids of the contacts having them.
+ *
+ * Addresses are looked up with a single search per batch and remembered for all incidences.
+ * The results follow changes to the contacts, resolved() is emitted with the addresses whose
+ * contacts changed.
+ */
+class AttendeeContactResolver : public QObject
+{
+    Q_OBJECT
+public:
+    static AttendeeContactResolver *instance();
+
+    /// Searches the contacts for the @p emails which aren't resolved or being resolved yet
+    void resolve(const QStringList &emails);
+
+    bool isResolved(const QString &email) const;
+    /// The contacts having @p email, empty if none do or it isn't resolved yet
+    QVector<Akonadi::Item::Id> contactIds(const QString &email) const;
+
+    static QString normalizedEmail(const QString &email);
+
+Q_SIGNALS:
+    void resolved(const QStringList &emails);
+
+private:
+    explicit AttendeeContactResolver(QObject *parent = nullptr);
+
+    void updateContact(const Akonadi::Item &item, QSet<QString> &changedEmails);
+    void removeContact(Akonadi::Item::Id id, QSet<QString> &changedEmails);
+
+    Akonadi::Monitor *const m_monitor;
+    QHash<QString, QVector<Akonadi::Item::Id>> m_contactIds;
+    QHash<Akonadi::Item::Id, QStringList> m_resolvedEmailsOfContact;
+    QSet<QString> m_pending;
+};
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include <conflictdetector.h>
+#include <intervalindex.h>
+
+#include <KCalendarCore/Event>
+#include <KCalendarCore/MemoryCalendar>
+#include <QRandomGenerator>
+#include <QSignalSpy>
+#include <QTest>
+
+class ConflictDetectorTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    const QDateTime m_start = QDateTime(QDate(2022, 3, 7), QTime(0, 0), Qt::UTC);
+
+    QDateTime at(int day, int hour, int minute = 0) const
+    {
+        return m_start.addDays(day).addSecs(hour * 3600 + minute * 60);
+    }
+
+    KCalendarCore::Event::Ptr createEvent(const QString &summary, const QDateTime &start, int minutes) const
+    {
+        KCalendarCore::Event::Ptr event(new KCalendarCore::Event);
+        event->setUid(summary);
+        event->setSummary(summary);
+        event->setDtStart(start);
+        event->setDtEnd(start.addSecs(minutes * 60));
+        return event;
+    }
+
+    static QStringList summaries(const QVector<ConflictDetector::Conflict> &conflicts)
+    {
+        QStringList summaries;
+        for (const auto &conflict : conflicts) {
+            summaries << conflict.incidence->summary();
+        }
+        return summaries;
+    }
+
+private Q_SLOTS:
+    void testIntervalIndex_data()
+    {
+        QTest::addColumn<int>("count");
+
+        // Complete and incomplete trees, and more levels than traversed in order
+        QTest::newRow("empty") << 0;
+        QTest::newRow("one") << 1;
+        QTest::newRow("small") << 7;
+        QTest::newRow("complete") << 255;
+        QTest::newRow("incomplete") << 1000;
+    }
+
+    void testIntervalIndex()
+    {
+        QFETCH(int, count);
+
+        QRandomGenerator random(count);
+        QVector<std::pair<qint64, qint64>> intervals;
+        IntervalIndex index;
+        for (int i = 0; i < count; ++i) {
+            const qint64 start = random.bounded(10000);
+            // Mostly short ones, a few long ones
+            const qint64 end = start + (i % 50 == 0 ? random.bounded(5000) : random.bounded(100));
+            intervals.append({start, end});
+            index.add(start, end, i);
+        }
+        index.build();
+        QCOMPARE(index.count(), count);
+
+        for (int query = 0; query < 200; ++query) {
+            const qint64 start = random.bounded(10500) - 250;
+            const qint64 end = start + 1 + random.bounded(300);
+
+            QVector<int> expected;
+            for (int i = 0; i < count; ++i) {
+                if (intervals.at(i).first < end && start < intervals.at(i).second) {
+                    expected.append(i);
+                }
+            }
+            auto values = index.overlapping(start, end);
+            std::sort(values.begin(), values.end());
+            QCOMPARE(values, expected);
+        }
+    }
+
+    void testConflicts()
+    {
+        KCalendarCore::MemoryCalendar::Ptr calendar(new KCalendarCore::MemoryCalendar(QTimeZone::utc()));
+        calendar->addEvent(createEvent(QStringLiteral("Standup"), at(0, 9), 15));
+        calendar->addEvent(createEvent(QStringLiteral("Review"), at(0, 10), 60));
+        auto transparent = createEvent(QStringLiteral("Reminder"), at(0, 10), 60);
+        transparent->setTransparency(KCalendarCore::Event::Transparent);
+        calendar->addEvent(transparent);
+        auto weekly = createEvent(QStringLiteral("Weekly"), at(0, 14), 60);
+        weekly->recurrence()->setWeekly(1);
+        calendar->addEvent(weekly);
+
+        ConflictDetector detector;
+        detector.setSourceCalendar(calendar);
+
+        QCOMPARE(summaries(detector.conflicts(at(0, 9), at(0, 11))), (QStringList{QStringLiteral("Standup"), QStringLiteral("Review")}));
+        // Touching isn't overlapping
+        QVERIFY(!detector.hasConflicts(at(0, 9, 15), at(0, 10)));
+        QVERIFY(detector.hasConflicts(at(0, 9, 14), at(0, 10)));
+        QVERIFY(!detector.hasConflicts(at(0, 10), at(0, 11), {}, QStringLiteral("Review")));
+        QVERIFY(!detector.hasConflicts(at(0, 10), at(0, 11), {42}));
+
+        // Occurrences far from the indexed weeks
+        QVERIFY(detector.hasConflicts(at(7 * 30, 14, 30), at(7 * 30, 16)));
+        QVERIFY(!detector.hasConflicts(at(7 * 30 + 1, 14, 30), at(7 * 30 + 1, 16)));
+
+        QSignalSpy conflictsChanged(&detector, &ConflictDetector::conflictsChanged);
+        calendar->addEvent(createEvent(QStringLiteral("Lunch"), at(0, 12), 60));
+        QCOMPARE(conflictsChanged.count(), 1);
+        QCOMPARE(summaries(detector.conflicts(at(0, 11), at(0, 13))), QStringList{QStringLiteral("Lunch")});
+    }
+};
+
+QTEST_MAIN(ConflictDetectorTest)
+#include "conflictdetectortest.moc"
@@ -1,7 +1,9 @@
 // SPDX-FileCopyrightText: 2022 Claudio Cambra <claudio.cambra@gmail.com>
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
 // SPDX-License-Identifier: LGPL-2.0-or-later
 
 #include <filter.h>
+#include <tagregistry.h>
 
 #include <QSignalSpy>
 #include <QTest>
@@ -43,6 +45,32 @@ private Q_SLOTS:
         QCOMPARE(nameChanged.count(), 1);
         QCOMPARE(filter.name(), m_testName);
     }
+
+    void testTagIds()
+    {
+        Filter filter;
+        filter.toggleFilterTag(QStringLiteral("tag-1"));
+        QCOMPARE(filter.tagIds(), TagRegistry::instance()->intern(QStringList{QStringLiteral("tag-1")}));
+        filter.removeTag(QStringLiteral("tag-1"));
+        QVERIFY(filter.tagIds().isEmpty());
+    }
+
+    void testRenamedTag()
+    {
+        Akonadi::Tag tag(QStringLiteral("holidays"));
+        tag.setId(42);
+        TagRegistry::instance()->setAkonadiTag(tag);
+
+        Filter filter;
+        filter.setTags({QStringLiteral("holidays"), QStringLiteral("work")});
+
+        tag.setName(QStringLiteral("vacation"));
+        TagRegistry::instance()->setAkonadiTag(tag);
+        // The incidences still have the old name in their categories
+        QCOMPARE(filter.tags(), (QStringList{QStringLiteral("holidays"), QStringLiteral("work"), QStringLiteral("vacation")}));
+        QCOMPARE(filter.tagIds(),
+                 TagRegistry::instance()->intern(QStringList{QStringLiteral("holidays"), QStringLiteral("work"), QStringLiteral("vacation")}));
+    }
 };
 
 QTEST_MAIN(FilterTest)
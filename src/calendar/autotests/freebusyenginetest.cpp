@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include <busybitmap.h>
+#include <freebusyengine.h>
+
+#include <KCalendarCore/Event>
+#include <KCalendarCore/MemoryCalendar>
+#include <QSignalSpy>
+#include <QTest>
+
+class FreeBusyEngineTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    const QDateTime m_start = QDateTime(QDate(2022, 3, 7), QTime(0, 0), Qt::UTC);
+
+    QDateTime at(int day, int hour, int minute = 0) const
+    {
+        return m_start.addDays(day).addSecs(hour * 3600 + minute * 60);
+    }
+
+    KCalendarCore::Event::Ptr createEvent(const QDateTime &start, int minutes, const QStringList &attendees = {}) const
+    {
+        KCalendarCore::Event::Ptr event(new KCalendarCore::Event);
+        event->setDtStart(start);
+        event->setDtEnd(start.addSecs(minutes * 60));
+        for (const auto &email : attendees) {
+            event->addAttendee(KCalendarCore::Attendee(QString(), email));
+        }
+        return event;
+    }
+
+private Q_SLOTS:
+    void testBitmap()
+    {
+        BusyBitmap bitmap(m_start, m_start.addDays(1), 15);
+        QCOMPARE(bitmap.slotCount(), 96);
+        QVERIFY(!bitmap.isBusy(0));
+
+        // Partly covered slots are busy
+        bitmap.markBusy(at(0, 9, 10), at(0, 10, 5));
+        QVERIFY(!bitmap.isBusy(35));
+        QVERIFY(bitmap.isBusy(36));
+        QVERIFY(bitmap.isBusy(40));
+        QVERIFY(!bitmap.isBusy(41));
+        QVERIFY(bitmap.isFree(at(0, 8), at(0, 9)));
+        QVERIFY(!bitmap.isFree(at(0, 8), at(0, 9, 30)));
+
+        // Outside of the bitmap
+        bitmap.markBusy(at(-1, 0), at(0, 1));
+        bitmap.markBusy(at(0, 23, 30), at(2, 0));
+        QVERIFY(bitmap.isBusy(0));
+        QVERIFY(bitmap.isBusy(3));
+        QVERIFY(!bitmap.isBusy(4));
+        QVERIFY(bitmap.isBusy(95));
+
+        BusyBitmap other(m_start, m_start.addDays(1), 15);
+        other.markBusy(at(0, 12), at(0, 13));
+        bitmap |= other;
+        QVERIFY(bitmap.isBusy(48));
+        QVERIFY(!other.isBusy(40));
+    }
+
+    void testFreeSlots()
+    {
+        // Over several words, with runs crossing word boundaries
+        BusyBitmap bitmap(m_start, m_start.addDays(7), 5);
+        bitmap.markBusy(m_start, at(0, 8));
+        bitmap.markBusy(at(0, 9), at(0, 18));
+        bitmap.markBusy(at(0, 18, 30), at(1, 8));
+
+        const auto slots = bitmap.freeSlots(60, 3);
+        QCOMPARE(slots.size(), 3);
+        QCOMPARE(slots.at(0).start, at(0, 8));
+        QCOMPARE(slots.at(0).end, at(0, 9));
+        // The half hour in between is too short
+        QCOMPARE(slots.at(1).start, at(1, 8));
+        QCOMPARE(slots.at(2).start, at(1, 9));
+
+        BusyBitmap busy(m_start, m_start.addDays(1), 15);
+        busy.markBusy(m_start, at(1, 0));
+        QVERIFY(busy.freeSlots(15, 1).isEmpty());
+
+        // Up to the end of the bitmap, but not further
+        BusyBitmap free(m_start, at(0, 2), 15);
+        QCOMPARE(free.freeSlots(60, 5).size(), 2);
+    }
+
+    void testCalendar()
+    {
+        KCalendarCore::MemoryCalendar::Ptr calendar(new KCalendarCore::MemoryCalendar(QTimeZone::utc()));
+        calendar->addEvent(createEvent(at(0, 0), 9 * 60, {QStringLiteral("alice@example.org")}));
+        calendar->addEvent(createEvent(at(0, 10), 60, {QStringLiteral("Bob@Example.org")}));
+        auto transparent = createEvent(at(0, 11), 60);
+        transparent->setTransparency(KCalendarCore::Event::Transparent);
+        calendar->addEvent(transparent);
+
+        FreeBusyEngine engine;
+        engine.setStart(m_start);
+        engine.setDays(1);
+        engine.setSourceCalendar(calendar);
+
+        auto slots = engine.findFreeSlots({QStringLiteral("bob@example.org")}, 60, 2, false);
+        QCOMPARE(slots.size(), 2);
+        QCOMPARE(slots.at(0).toMap().value(QStringLiteral("start")).toDateTime(), at(0, 0));
+        QCOMPARE(slots.at(1).toMap().value(QStringLiteral("start")).toDateTime(), at(0, 1));
+
+        slots = engine.findFreeSlots({QStringLiteral("alice@example.org"), QStringLiteral("bob@example.org")}, 60, 1, false);
+        QCOMPARE(slots.constFirst().toMap().value(QStringLiteral("start")).toDateTime(), at(0, 9));
+
+        // Our own calendars, the transparent event doesn't count
+        slots = engine.findFreeSlots({}, 120, 1);
+        QCOMPARE(slots.constFirst().toMap().value(QStringLiteral("start")).toDateTime(), at(0, 11));
+
+        QSignalSpy busyTimesChanged(&engine, &FreeBusyEngine::busyTimesChanged);
+        calendar->addEvent(createEvent(at(0, 11), 60));
+        QCOMPARE(busyTimesChanged.count(), 1);
+        slots = engine.findFreeSlots({}, 120, 1);
+        QCOMPARE(slots.constFirst().toMap().value(QStringLiteral("start")).toDateTime(), at(0, 12));
+    }
+
+    void testEditedIncidence()
+    {
+        KCalendarCore::MemoryCalendar::Ptr calendar(new KCalendarCore::MemoryCalendar(QTimeZone::utc()));
+        calendar->addEvent(createEvent(at(0, 0), 9 * 60));
+        auto edited = createEvent(at(0, 9), 60, {QStringLiteral("alice@example.org")});
+        // Skipped, there is no address to look its busy times up by
+        edited->addAttendee(KCalendarCore::Attendee(QStringLiteral("Bob"), QString()));
+        calendar->addEvent(edited);
+
+        FreeBusyEngine engine;
+        engine.setStart(m_start);
+        engine.setDays(1);
+        engine.setSourceCalendar(calendar);
+
+        // The edited incidence doesn't keep its attendees or us busy
+        auto slots = engine.findFreeSlotsForIncidence(edited, 1);
+        QCOMPARE(slots.constFirst().toMap().value(QStringLiteral("start")).toDateTime(), at(0, 9));
+
+        // Only while looking for its own slots
+        slots = engine.findFreeSlots({QStringLiteral("alice@example.org")}, 60, 1);
+        QCOMPARE(slots.constFirst().toMap().value(QStringLiteral("start")).toDateTime(), at(0, 10));
+        QVERIFY(!engine.busyBitmap(QStringLiteral("alice@example.org")).isFree(at(0, 9), at(0, 10)));
+    }
+
+    void testFreeBusyData()
+    {
+        const QString data = QStringLiteral(
+            "BEGIN:VCALENDAR\r\n"
+            "VERSION:2.0\r\n"
+            "PRODID:-//Example//EN\r\n"
+            "BEGIN:VFREEBUSY\r\n"
+            "ORGANIZER:mailto:carol@example.org\r\n"
+            "DTSTART:20220307T000000Z\r\n"
+            "DTEND:20220308T000000Z\r\n"
+            "FREEBUSY:20220307T080000Z/20220307T120000Z\r\n"
+            "END:VFREEBUSY\r\n"
+            "BEGIN:VFREEBUSY\r\n"
+            "ORGANIZER:mailto:dave@example.org\r\n"
+            "DTSTART:20220307T000000Z\r\n"
+            "DTEND:20220308T000000Z\r\n"
+            "FREEBUSY:20220307T000000Z/PT13H\r\n"
+            "END:VFREEBUSY\r\n"
+            "END:VCALENDAR\r\n");
+
+        FreeBusyEngine engine;
+        engine.setStart(m_start);
+        engine.setDays(1);
+        QCOMPARE(engine.loadFreeBusy(data), 2);
+
+        QVERIFY(!engine.busyBitmap(QStringLiteral("carol@example.org")).isFree(at(0, 8), at(0, 12)));
+        QVERIFY(engine.busyBitmap(QStringLiteral("carol@example.org")).isFree(at(0, 12), at(0, 13)));
+        const auto slots = engine.findFreeSlots({QStringLiteral("carol@example.org"), QStringLiteral("dave@example.org")}, 30, 1);
+        QCOMPARE(slots.constFirst().toMap().value(QStringLiteral("start")).toDateTime(), at(0, 13));
+
+        engine.clearFreeBusy();
+        QVERIFY(engine.busyBitmap(QStringLiteral("carol@example.org")).isFree(at(0, 8), at(0, 12)));
+    }
+};
+
+QTEST_MAIN(FreeBusyEngineTest)
+#include "freebusyenginetest.moc"
@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include <icalendarreader.h>
+
+#include <KCalendarCore/Event>
+#include <QBuffer>
+#include <QTemporaryFile>
+#include <QTest>
+
+class ICalendarReaderTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QByteArray header()
+    {
+        return QByteArrayLiteral(
+            "BEGIN:VCALENDAR\r\n"
+            "VERSION:2.0\r\n"
+            "PRODID:-//Example//Legacy export//EN\r\n"
+            "BEGIN:VTIMEZONE\r\n"
+            "TZID:Custom/Zone\r\n"
+            "BEGIN:STANDARD\r\n"
+            "DTSTART:19700101T000000\r\n"
+            "TZOFFSETFROM:+0300\r\n"
+            "TZOFFSETTO:+0300\r\n"
+            "END:STANDARD\r\n"
+            "END:VTIMEZONE\r\n");
+    }
+
+    static QByteArray event(int i)
+    {
+        return QStringLiteral(
+                   "BEGIN:VEVENT\r\n"
+                   "UID:event-%1\r\n"
+                   "DTSTAMP:20220301T000000Z\r\n"
+                   "DTSTART;TZID=Custom/Zone:20220301T100000\r\n"
+                   "DTEND;TZID=Custom/Zone:20220301T110000\r\n"
+                   "SUMMARY:Event %1 with a summary long enough to be folded over two lines by\r\n"
+                   "  the writer\r\n"
+                   "BEGIN:VALARM\r\n"
+                   "ACTION:DISPLAY\r\n"
+                   "TRIGGER:-PT15M\r\n"
+                   "END:VALARM\r\n"
+                   "END:VEVENT\r\n")
+            .arg(i)
+            .toUtf8();
+    }
+
+    static QByteArray todo(int i)
+    {
+        return QStringLiteral(
+                   "BEGIN:VTODO\r\n"
+                   "UID:todo-%1\r\n"
+                   "DTSTAMP:20220301T000000Z\r\n"
+                   "SUMMARY:Task %1\r\n"
+                   "END:VTODO\r\n")
+            .arg(i)
+            .toUtf8();
+    }
+
+private Q_SLOTS:
+    void testBatches()
+    {
+        QByteArray data = header();
+        for (int i = 0; i < 5; ++i) {
+            data += event(i);
+        }
+        data += todo(0);
+        data += "END:VCALENDAR\r\n";
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+
+        ICalendarReader reader(&buffer);
+        auto incidences = reader.read(2);
+        QCOMPARE(incidences.count(), 2);
+        QVERIFY(!reader.atEnd());
+
+        incidences = reader.read(10);
+        QCOMPARE(incidences.count(), 4);
+        QCOMPARE(reader.read(10).count(), 0);
+        QVERIFY(reader.atEnd());
+        QCOMPARE(reader.position(), data.size());
+        QCOMPARE(reader.skippedCount(), 0);
+    }
+
+    void testContents()
+    {
+        QByteArray data = header() + event(7) + "END:VCALENDAR\r\n";
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+
+        ICalendarReader reader(&buffer);
+        const auto incidences = reader.read(10);
+        QCOMPARE(incidences.count(), 1);
+        const auto incidence = incidences.constFirst();
+        QCOMPARE(incidence->uid(), QStringLiteral("event-7"));
+        QCOMPARE(incidence->summary(), QStringLiteral("Event 7 with a summary long enough to be folded over two lines by the writer"));
+        QCOMPARE(incidence->alarms().count(), 1);
+        // The time zone of the first batch is known to the later ones too
+        QCOMPARE(incidence->dtStart().toUTC(), QDateTime(QDate(2022, 3, 1), QTime(7, 0), Qt::UTC));
+    }
+
+    void testByteOrderMark()
+    {
+        QByteArray data = "\xEF\xBB\xBF" + header() + event(0) + todo(1) + "END:VCALENDAR\r\n";
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+
+        ICalendarReader reader(&buffer);
+        const auto incidences = reader.read(10);
+        QCOMPARE(incidences.count(), 2);
+        QCOMPARE(incidences.at(0)->uid(), QStringLiteral("event-0"));
+        QCOMPARE(incidences.at(1)->uid(), QStringLiteral("todo-1"));
+        QCOMPARE(reader.skippedCount(), 0);
+    }
+
+    void testBrokenBatch()
+    {
+        // Each broken component makes a batch of its own, the file goes on after them
+        QByteArray data = header();
+        for (int i = 0; i < 3; ++i) {
+            data += QStringLiteral("BEGIN:VEVENT\r\nUID:broken-%1\r\nBEGIN:VALARM\r\nEND:VEVENT\r\n").arg(i).toUtf8();
+        }
+        data += event(0) + "END:VCALENDAR\r\n";
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+
+        ICalendarReader reader(&buffer);
+        QStringList uids;
+        for (auto incidences = reader.read(1); !incidences.isEmpty(); incidences = reader.read(1)) {
+            for (const auto &incidence : std::as_const(incidences)) {
+                uids.append(incidence->uid());
+            }
+        }
+        QVERIFY(reader.atEnd());
+        QVERIFY(uids.contains(QStringLiteral("event-0")));
+    }
+
+    void testIncompleteComponent()
+    {
+        QByteArray data = header() + event(0) + "BEGIN:VEVENT\r\nUID:cut\r\n";
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+
+        ICalendarReader reader(&buffer);
+        QCOMPARE(reader.read(10).count(), 1);
+        QVERIFY(reader.atEnd());
+    }
+
+    void testLargeFile()
+    {
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        file.write(header());
+        for (int i = 0; i < 20000; ++i) {
+            file.write(i % 4 == 0 ? todo(i) : event(i));
+        }
+        file.write("END:VCALENDAR\r\n");
+        file.seek(0);
+
+        ICalendarReader reader(&file);
+        int count = 0;
+        for (auto incidences = reader.read(500); !incidences.isEmpty(); incidences = reader.read(500)) {
+            QVERIFY(incidences.count() <= 500);
+            count += incidences.count();
+        }
+        QCOMPARE(count, 20000);
+        QVERIFY(reader.atEnd());
+    }
+};
+
+QTEST_MAIN(ICalendarReaderTest)
+#include "icalendarreadertest.moc"
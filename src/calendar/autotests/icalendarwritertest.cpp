@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include <calendarexporter.h>
+#include <icalendarreader.h>
+#include <icalendarwriter.h>
+
+#include <KCalendarCore/Event>
+#include <KCalendarCore/Todo>
+#include <QBuffer>
+#include <QTest>
+
+class ICalendarWriterTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    static KCalendarCore::Event::Ptr createEvent(int i, const QTimeZone &timeZone = QTimeZone::utc())
+    {
+        KCalendarCore::Event::Ptr event(new KCalendarCore::Event);
+        event->setUid(QStringLiteral("event-%1").arg(i));
+        event->setSummary(QStringLiteral("Event %1").arg(i));
+        event->setDtStart(QDateTime(QDate(2022, 3, 1).addDays(i), QTime(10, 0), timeZone));
+        event->setDtEnd(event->dtStart().addSecs(3600));
+        return event;
+    }
+
+    static KCalendarCore::Event::Ptr createException(const KCalendarCore::Event::Ptr &master, int occurrence, const QDateTime &start)
+    {
+        KCalendarCore::Event::Ptr exception(new KCalendarCore::Event(*master));
+        exception->clearRecurrence();
+        exception->setRecurrenceId(master->dtStart().addDays(7 * occurrence));
+        exception->setDtStart(start);
+        exception->setDtEnd(start.addSecs(3600));
+        return exception;
+    }
+
+private Q_SLOTS:
+    void testRoundTrip()
+    {
+        const QTimeZone berlin("Europe/Berlin");
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+
+        ICalendarWriter writer(&buffer);
+        for (int batch = 0; batch < 3; ++batch) {
+            KCalendarCore::Incidence::List incidences;
+            for (int i = batch * 10; i < batch * 10 + 10; ++i) {
+                incidences << createEvent(i, berlin);
+            }
+            QVERIFY(writer.write(incidences));
+        }
+        KCalendarCore::Todo::Ptr todo(new KCalendarCore::Todo);
+        todo->setUid(QStringLiteral("todo"));
+        todo->setSummary(QStringLiteral("Task"));
+        QVERIFY(writer.write({todo}));
+        QVERIFY(writer.finish());
+        QCOMPARE(writer.count(), 31);
+
+        QVERIFY(data.startsWith("BEGIN:VCALENDAR\r\n"));
+        QVERIFY(data.endsWith("END:VCALENDAR\r\n"));
+        QCOMPARE(data.count("BEGIN:VCALENDAR"), 1);
+        // Every batch uses the same time zone, which is written once
+        QCOMPARE(data.count("BEGIN:VTIMEZONE"), 1);
+
+        buffer.close();
+        buffer.open(QIODevice::ReadOnly);
+        ICalendarReader reader(&buffer);
+        const auto incidences = reader.read(100);
+        QCOMPARE(incidences.count(), 31);
+        QCOMPARE(reader.skippedCount(), 0);
+        for (const auto &incidence : incidences) {
+            if (incidence->uid() == QLatin1String("event-5")) {
+                QCOMPARE(incidence->dtStart(), createEvent(5, berlin)->dtStart());
+                QCOMPARE(incidence->dtStart().timeZone(), berlin);
+            }
+        }
+    }
+
+    void testEmpty()
+    {
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+
+        ICalendarWriter writer(&buffer);
+        QVERIFY(writer.finish());
+        QVERIFY(data.startsWith("BEGIN:VCALENDAR\r\n"));
+        QVERIFY(data.endsWith("END:VCALENDAR\r\n"));
+    }
+
+    void testOccursWithin()
+    {
+        const QDateTime march(QDate(2022, 3, 1), QTime(0, 0), Qt::UTC);
+        const auto event = createEvent(0);
+        QVERIFY(CalendarExporter::occursWithin(event, {}, {}));
+        QVERIFY(CalendarExporter::occursWithin(event, march, march.addDays(1)));
+        QVERIFY(CalendarExporter::occursWithin(event, march.addSecs(10 * 3600 + 1800), {}));
+        QVERIFY(!CalendarExporter::occursWithin(event, march.addDays(1), {}));
+        QVERIFY(!CalendarExporter::occursWithin(event, {}, march.addSecs(10 * 3600)));
+
+        // Between two occurrences, and after the last one
+        const auto weekly = createEvent(0);
+        weekly->recurrence()->setWeekly(1);
+        weekly->recurrence()->setDuration(4);
+        QVERIFY(!CalendarExporter::occursWithin(weekly, march.addDays(2), march.addDays(5)));
+        QVERIFY(CalendarExporter::occursWithin(weekly, march.addDays(20), march.addDays(22)));
+        QVERIFY(!CalendarExporter::occursWithin(weekly, march.addDays(30), {}));
+
+        KCalendarCore::Todo::Ptr todo(new KCalendarCore::Todo);
+        QVERIFY(CalendarExporter::occursWithin(todo, {}, {}));
+        QVERIFY(!CalendarExporter::occursWithin(todo, march, {}));
+    }
+
+    void testRangeFilter()
+    {
+        const QDateTime april(QDate(2022, 4, 1), QTime(0, 0), Qt::UTC);
+        IncidenceRangeFilter filter(april, april.addDays(30));
+
+        QVERIFY(filter.add(createEvent(0)).isEmpty());
+        const auto inRange = createEvent(40);
+        QCOMPARE(filter.add(inRange), KCalendarCore::Incidence::List{inRange});
+
+        // Only an exception moved into the range occurs there, it is held until its master is met
+        auto weekly = createEvent(1);
+        weekly->recurrence()->setWeekly(1);
+        weekly->recurrence()->setDuration(4);
+        const auto moved = createException(weekly, 1, april.addDays(9));
+        const auto other = createException(weekly, 2, weekly->dtStart().addDays(15));
+        QVERIFY(filter.add(moved).isEmpty());
+        QCOMPARE(filter.heldExceptionCount(), 1);
+        QCOMPARE(filter.add(weekly), (KCalendarCore::Incidence::List{weekly, moved}));
+        // The other exceptions of an exported master follow it
+        QCOMPARE(filter.add(other), KCalendarCore::Incidence::List{other});
+        QCOMPARE(filter.heldExceptionCount(), 0);
+
+        // Never without their master
+        auto orphanMaster = createEvent(2);
+        orphanMaster->recurrence()->setWeekly(1);
+        QVERIFY(filter.add(createException(orphanMaster, 0, april.addDays(2))).isEmpty());
+        QCOMPARE(filter.heldExceptionCount(), 1);
+    }
+};
+
+QTEST_MAIN(ICalendarWriterTest)
+#include "icalendarwritertest.moc"
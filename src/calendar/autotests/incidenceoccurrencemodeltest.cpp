@@ -1,13 +1,18 @@
 // SPDX-FileCopyrightText: 2021 Claudio Cambra <claudio.cambra@gmail.com>
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
 // SPDX-License-Identifier: LGPL-2.0-or-later
 
+#include <models/hourlyincidencemodel.h>
 #include <models/incidenceoccurrencemodel.h>
+#include <models/multidayincidencemodel.h>
+#include <models/occurrencerecord.h>
 
 #include <Akonadi/IncidenceChanger>
 #include <KCalendarCore/Incidence>
 #include <KCheckableProxyModel>
 #include <KFormat>
 #include <QAbstractItemModelTester>
+#include <QBitArray>
 #include <QSignalSpy>
 #include <QTest>
 #include <akonadi/qtest_akonadi.h>
@@ -247,6 +252,13 @@ private Q_SLOTS:
 
         QVERIFY(index.data(IncidenceOccurrenceModel::IncidencePtr).canConvert<KCalendarCore::Incidence::Ptr>());
         QVERIFY(index.data(IncidenceOccurrenceModel::IncidenceOccurrence).canConvert<IncidenceOccurrenceModel::Occurrence>());
+
+        const auto record = index.data(IncidenceOccurrenceModel::Record).value<OccurrenceRecord>();
+        QCOMPARE(record.text(), index.data(IncidenceOccurrenceModel::Summary).toString());
+        QCOMPARE(record.startTime(), index.data(IncidenceOccurrenceModel::StartTime).toDateTime());
+        QCOMPARE(record.durationString(), index.data(IncidenceOccurrenceModel::DurationString).toString());
+        QCOMPARE(record.incidenceTypeStr(), index.data(IncidenceOccurrenceModel::IncidenceTypeStr).toString());
+        QCOMPARE(record.isReadOnly(), index.data(IncidenceOccurrenceModel::IsReadOnly).toBool());
     }
 
     void testIncidenceAdded()
@@ -377,6 +389,100 @@ private Q_SLOTS:
         QVERIFY(!model.loading());
         QCOMPARE(model.rowCount(), m_expectedIncidenceCount + 1);
     }
+
+    void testCollectionLoadedLate()
+    {
+        resetCalendar();
+
+        // Set before its collection is populated, so the collection is added once it is
+        Akonadi::ETMCalendar::Ptr calendar(new Akonadi::ETMCalendar);
+        QSignalSpy collectionsAdded(calendar.data(), &Akonadi::ETMCalendar::collectionsAdded);
+
+        IncidenceOccurrenceModel model;
+        QAbstractItemModelTester modelTester(&model);
+        model.setStart(m_now.date());
+        model.setLength(m_testModelLength);
+        model.setCalendar(calendar);
+
+        QVERIFY(collectionsAdded.wait(10000));
+        checkAllItems(calendar->checkableProxyModel());
+
+        // Neither the one-off event out of the period nor the todos without dates are added
+        QTRY_COMPARE_WITH_TIMEOUT(model.rowCount(), m_expectedIncidenceCount, 10000);
+        QTRY_VERIFY_WITH_TIMEOUT(!model.loading(), 10000);
+        QCOMPARE(model.rowCount(), m_expectedIncidenceCount);
+        for (int row = 0; row < model.rowCount(); ++row) {
+            QCOMPARE(model.index(row, 0).data(IncidenceOccurrenceModel::Summary).toString(), QStringLiteral("Test event"));
+        }
+    }
+
+    void testHourlyLayout()
+    {
+        resetCalendar();
+
+        IncidenceOccurrenceModel model;
+        QVERIFY(standardSetupModel(model));
+
+        HourlyIncidenceModel hourlyModel;
+        hourlyModel.setModel(&model);
+        QCOMPARE(hourlyModel.rowCount(), m_testModelLength);
+        const int periodsPerDay = (24 * 60) / hourlyModel.periodLength();
+
+        // Each day has the all-day occurrence of the day and the one of the day before
+        for (int row = 0; row < hourlyModel.rowCount(); ++row) {
+            const auto day = m_now.date().addDays(row);
+            const auto incidences = hourlyModel.index(row, 0).data(HourlyIncidenceModel::IncidencesRole).toList();
+            QCOMPARE(incidences.count(), 2);
+
+            for (const auto &incidence : incidences) {
+                const auto record = incidence.value<OccurrenceRecord>();
+                QVERIFY(record.allDay());
+                QCOMPARE(record.starts(), 0.0);
+                if (record.startTime().date() == day) {
+                    QCOMPARE(record.duration(), double(periodsPerDay));
+                } else {
+                    QCOMPARE(record.startTime().date(), day.addDays(-1));
+                }
+            }
+        }
+    }
+
+    void testMultiDayLayout()
+    {
+        resetCalendar();
+
+        IncidenceOccurrenceModel model;
+        QVERIFY(standardSetupModel(model));
+
+        MultiDayIncidenceModel multiDayModel;
+        multiDayModel.setModel(&model);
+        multiDayModel.componentComplete();
+        QCOMPARE(multiDayModel.rowCount(), 1);
+
+        const auto lines = multiDayModel.index(0, 0).data(MultiDayIncidenceModel::IncidencesRole).toList();
+        int recordCount = 0;
+        for (const auto &line : lines) {
+            QBitArray takenDays(m_testModelLength);
+            for (const auto &incidence : line.toList()) {
+                const auto record = incidence.value<OccurrenceRecord>();
+                ++recordCount;
+
+                // All-day occurrences are placed on their dates, cut to the week
+                const auto startDate = record.startTime().date();
+                const int expectedStart = qMax(m_now.date().daysTo(startDate), 0ll);
+                const int expectedDuration = qMin(m_now.date().daysTo(record.endTime().date()) + 1, qint64(m_testModelLength)) - expectedStart;
+                QCOMPARE(record.starts(), double(expectedStart));
+                QCOMPARE(record.duration(), double(expectedDuration));
+
+                // Occurrences on the same line don't overlap
+                for (int day = expectedStart; day < expectedStart + expectedDuration; ++day) {
+                    QVERIFY(!takenDays.testBit(day));
+                    takenDays.setBit(day);
+                }
+            }
+        }
+        QCOMPARE(recordCount, m_expectedIncidenceCount);
+    }
 };
 
 QTEST_MAIN(IncidenceOccurrenceModelTest)
@@ -0,0 +1,303 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include <incidencesearchindex.h>
+
+#include <KCalendarCore/Event>
+#include <KCalendarCore/MemoryCalendar>
+#include <QDataStream>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+#include <benchmarkhelper.h>
+
+class IncidenceSearchIndexTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    static KCalendarCore::Event::Ptr createEvent(const QString &summary, const QDateTime &start, const QString &description = {})
+    {
+        KCalendarCore::Event::Ptr event(new KCalendarCore::Event);
+        event->setUid(summary);
+        event->setSummary(summary);
+        event->setDescription(description);
+        event->setDtStart(start);
+        event->setDtEnd(start.addSecs(3600));
+        event->setLastModified(QDateTime(QDate(2022, 1, 1), QTime(12, 0), Qt::UTC));
+        return event;
+    }
+
+    static KCalendarCore::MemoryCalendar::Ptr createCalendar()
+    {
+        KCalendarCore::MemoryCalendar::Ptr calendar(new KCalendarCore::MemoryCalendar(QTimeZone::utc()));
+        const QDateTime march(QDate(2022, 3, 1), QTime(10, 0), Qt::UTC);
+
+        calendar->addEvent(createEvent(QStringLiteral("Kalendar meeting"), march, QStringLiteral("Planning the next release")));
+        calendar->addEvent(createEvent(QStringLiteral("Dentist"), march.addDays(7), QStringLiteral("Bring the meeting notes")));
+
+        auto event = createEvent(QStringLiteral("Lunch"), march.addDays(14));
+        event->setLocation(QStringLiteral("Café Müller"));
+        event->setCategories({QStringLiteral("Food")});
+        event->addAttendee(KCalendarCore::Attendee(QStringLiteral("Claudio Cambra"), QStringLiteral("claudio.cambra@gmail.com")));
+        calendar->addEvent(event);
+
+        auto weekly = createEvent(QStringLiteral("Weekly sync"), march);
+        weekly->recurrence()->setWeekly(1);
+        weekly->recurrence()->setDuration(4);
+        calendar->addEvent(weekly);
+        return calendar;
+    }
+
+    static KCalendarCore::MemoryCalendar::Ptr createLargeCalendar(int count)
+    {
+        static const QStringList words{QStringLiteral("meeting"),
+                                       QStringLiteral("review"),
+                                       QStringLiteral("lunch"),
+                                       QStringLiteral("release"),
+                                       QStringLiteral("planning"),
+                                       QStringLiteral("dentist"),
+                                       QStringLiteral("conference"),
+                                       QStringLiteral("sprint")};
+        KCalendarCore::MemoryCalendar::Ptr calendar(new KCalendarCore::MemoryCalendar(QTimeZone::utc()));
+        const QDateTime start(QDate(2020, 1, 1), QTime(9, 0), Qt::UTC);
+        for (int i = 0; i < count; ++i) {
+            auto event = createEvent(QStringLiteral("%1 %2 %3").arg(words.at(i % words.size()), words.at(i / words.size() % words.size())).arg(i),
+                                     start.addSecs(i * 3600),
+                                     QStringLiteral("Notes about the %1").arg(words.at(i * 7 % words.size())));
+            calendar->addEvent(event);
+        }
+        return calendar;
+    }
+
+    static QStringList summaries(const QVector<IncidenceSearchIndex::Result> &results)
+    {
+        QStringList summaries;
+        for (const auto &result : results) {
+            summaries << result.summary;
+        }
+        return summaries;
+    }
+
+private Q_SLOTS:
+    void init()
+    {
+        KALENDAR_SKIP_BENCHMARKS();
+    }
+
+    void testSearch_data()
+    {
+        QTest::addColumn<QString>("text");
+        QTest::addColumn<QStringList>("summaries");
+
+        QTest::newRow("empty") << QString() << QStringList{};
+        // The summary weighs more than the description
+        QTest::newRow("fields") << QStringLiteral("meeting") << QStringList{QStringLiteral("Kalendar meeting"), QStringLiteral("Dentist")};
+        QTest::newRow("prefix") << QStringLiteral("dent") << QStringList{QStringLiteral("Dentist")};
+        QTest::newRow("case and diacritics") << QStringLiteral("MULLER") << QStringList{QStringLiteral("Lunch")};
+        QTest::newRow("category") << QStringLiteral("food") << QStringList{QStringLiteral("Lunch")};
+        QTest::newRow("attendee") << QStringLiteral("claudio.cambra@gmail.com") << QStringList{QStringLiteral("Lunch")};
+        QTest::newRow("all words") << QStringLiteral("meeting release") << QStringList{QStringLiteral("Kalendar meeting")};
+        QTest::newRow("no substring") << QStringLiteral("eeting") << QStringList{};
+    }
+
+    void testSearch()
+    {
+        QFETCH(QString, text);
+        QFETCH(QStringList, summaries);
+
+        IncidenceSearchIndex index;
+        index.setCalendar(createCalendar());
+        QCOMPARE(index.count(), 4);
+        QCOMPARE(IncidenceSearchIndexTest::summaries(index.search(text)), summaries);
+    }
+
+    void testDateRange()
+    {
+        IncidenceSearchIndex index;
+        index.setCalendar(createCalendar());
+        const QDateTime march(QDate(2022, 3, 1), QTime(0, 0), Qt::UTC);
+
+        QCOMPARE(summaries(index.search(QStringLiteral("meeting"), march.addDays(5), march.addDays(10))), QStringList{QStringLiteral("Dentist")});
+        QCOMPARE(summaries(index.search(QStringLiteral("meeting"), march.addDays(5))), QStringList{QStringLiteral("Dentist")});
+        QCOMPARE(summaries(index.search(QStringLiteral("meeting"), {}, march.addDays(5))), QStringList{QStringLiteral("Kalendar meeting")});
+
+        // Between two occurrences, and after the last one
+        QCOMPARE(summaries(index.search(QStringLiteral("weekly"), march.addDays(2), march.addDays(5))), QStringList{});
+        QCOMPARE(summaries(index.search(QStringLiteral("weekly"), march.addDays(20), march.addDays(22))), QStringList{QStringLiteral("Weekly sync")});
+        QCOMPARE(summaries(index.search(QStringLiteral("weekly"), march.addDays(30))), QStringList{});
+    }
+
+    void testUpdates()
+    {
+        IncidenceSearchIndex index;
+        const auto calendar = createCalendar();
+        index.setCalendar(calendar);
+        QSignalSpy changed(&index, &IncidenceSearchIndex::changed);
+
+        auto event = createEvent(QStringLiteral("Akademy"), QDateTime(QDate(2022, 10, 1), QTime(9, 0), Qt::UTC));
+        calendar->addEvent(event);
+        QCOMPARE(changed.count(), 1);
+        QCOMPARE(summaries(index.search(QStringLiteral("akademy"))), QStringList{QStringLiteral("Akademy")});
+
+        event->setSummary(QStringLiteral("Conference"));
+        QCOMPARE(summaries(index.search(QStringLiteral("akademy"))), QStringList{});
+        QCOMPARE(summaries(index.search(QStringLiteral("conf"))), QStringList{QStringLiteral("Conference")});
+
+        calendar->deleteEvent(event);
+        QCOMPARE(summaries(index.search(QStringLiteral("conf"))), QStringList{});
+        QCOMPARE(index.count(), 4);
+    }
+
+    void testManyRemovals()
+    {
+        IncidenceSearchIndex index;
+        const auto calendar = createLargeCalendar(1000);
+        index.setCalendar(calendar);
+        QCOMPARE(index.count(), 1000);
+
+        // Enough to purge the removed incidences from the postings, and reuse their place
+        const auto events = calendar->rawEvents();
+        for (int i = 0; i < 600; ++i) {
+            calendar->deleteEvent(events.at(i));
+        }
+        QCOMPARE(index.count(), 400);
+        // Other incidences start with the same words, but only one has all of them as whole words
+        for (int i = 0; i < events.size(); ++i) {
+            const auto results = summaries(index.search(events.at(i)->summary()));
+            if (i < 600) {
+                QVERIFY(!results.contains(events.at(i)->summary()));
+            } else {
+                QCOMPARE(results.value(0), events.at(i)->summary());
+            }
+        }
+
+        auto event = createEvent(QStringLiteral("Akademy"), QDateTime(QDate(2022, 10, 1), QTime(9, 0), Qt::UTC));
+        calendar->addEvent(event);
+        QCOMPARE(index.count(), 401);
+        QCOMPARE(summaries(index.search(QStringLiteral("akademy"))), QStringList{QStringLiteral("Akademy")});
+    }
+
+    void testPersistence()
+    {
+        QTemporaryDir directory;
+        const QString fileName = directory.filePath(QStringLiteral("index"));
+        {
+            IncidenceSearchIndex index(fileName);
+            index.setCalendar(createCalendar());
+            QVERIFY(index.save());
+        }
+
+        // Searchable before the calendar is loaded
+        IncidenceSearchIndex index(fileName);
+        QCOMPARE(index.count(), 4);
+        QCOMPARE(summaries(index.search(QStringLiteral("lunch"))), QStringList{QStringLiteral("Lunch")});
+
+        // What isn't in the calendar anymore is dropped
+        auto calendar = createCalendar();
+        calendar->deleteEvent(calendar->events(KCalendarCore::EventSortSummary).constFirst());
+        index.setCalendar(calendar);
+        QCOMPARE(index.count(), 3);
+        QCOMPARE(summaries(index.search(QStringLiteral("dentist"))), QStringList{});
+    }
+
+    void testCorruptFile()
+    {
+        QTemporaryDir directory;
+        const QString fileName = directory.filePath(QStringLiteral("index"));
+        {
+            IncidenceSearchIndex index(fileName);
+            index.setCalendar(createCalendar());
+            QVERIFY(index.save());
+        }
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.resize(file.size() / 2));
+        file.close();
+
+        // Nothing of the part read before the error is kept
+        IncidenceSearchIndex index(fileName);
+        QCOMPARE(index.count(), 0);
+        QVERIFY(index.search(QStringLiteral("meeting")).isEmpty());
+
+        index.setCalendar(createCalendar());
+        QCOMPARE(index.count(), 4);
+        QCOMPARE(summaries(index.search(QStringLiteral("lunch"))), QStringList{QStringLiteral("Lunch")});
+    }
+
+    void testHugeCount()
+    {
+        QTemporaryDir directory;
+        const QString fileName = directory.filePath(QStringLiteral("index"));
+        {
+            IncidenceSearchIndex index(fileName);
+            index.setCalendar(createCalendar());
+            QVERIFY(index.save());
+        }
+
+        // The document count follows the magic number and the version
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.seek(2 * sizeof(quint32)));
+        QDataStream stream(&file);
+        stream << quint32(0xffffffff);
+        file.close();
+
+        // Read as corrupted, without allocating for the count
+        IncidenceSearchIndex index(fileName);
+        QCOMPARE(index.count(), 0);
+        index.setCalendar(createCalendar());
+        QCOMPARE(index.count(), 4);
+    }
+
+    void benchmarkBuild()
+    {
+        const auto calendar = createLargeCalendar(100000);
+        QBENCHMARK {
+            IncidenceSearchIndex index;
+            index.setCalendar(calendar);
+        }
+    }
+
+    void benchmarkSearch_data()
+    {
+        QTest::addColumn<QString>("text");
+
+        QTest::newRow("single character") << QStringLiteral("m");
+        QTest::newRow("prefix") << QStringLiteral("meet");
+        QTest::newRow("two words") << QStringLiteral("meeting rev");
+        QTest::newRow("description") << QStringLiteral("notes about");
+    }
+
+    // Expected to stay within a few milliseconds
+    void benchmarkSearch()
+    {
+        QFETCH(QString, text);
+
+        IncidenceSearchIndex index;
+        index.setCalendar(createLargeCalendar(100000));
+        QBENCHMARK {
+            index.search(text, {}, {}, 50);
+        }
+    }
+
+    void benchmarkRemove()
+    {
+        IncidenceSearchIndex index;
+        const auto calendar = createLargeCalendar(100000);
+        index.setCalendar(calendar);
+        const auto events = calendar->rawEvents();
+
+        // A tenth of the incidences, one at a time
+        QBENCHMARK_ONCE {
+            for (int i = 0; i < 10000; ++i) {
+                calendar->deleteEvent(events.at(i));
+            }
+        }
+        QCOMPARE(index.count(), 90000);
+    }
+};
+
+QTEST_MAIN(IncidenceSearchIndexTest)
+#include "incidencesearchindextest.moc"
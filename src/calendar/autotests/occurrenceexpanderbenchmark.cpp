@@ -0,0 +1,209 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include <occurrenceexpander.h>
+
+#include <KCalendarCore/Event>
+#include <KCalendarCore/ICalFormat>
+#include <KCalendarCore/MemoryCalendar>
+#include <KCalendarCore/OccurrenceIterator>
+#include <QTest>
+#include <benchmarkhelper.h>
+
+using namespace KCalendarCore;
+
+class OccurrenceExpanderBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    static Event::Ptr createEvent(const QString &uid, const QDateTime &start, const QString &rule, bool allDay = false)
+    {
+        Event::Ptr event(new Event);
+        event->setUid(uid);
+        event->setSummary(uid);
+        event->setDtStart(start);
+        event->setDtEnd(allDay ? start : start.addSecs(15 * 60));
+        event->setAllDay(allDay);
+
+        auto recurrenceRule = new RecurrenceRule;
+        ICalFormat().fromString(recurrenceRule, rule);
+        recurrenceRule->setStartDt(start);
+        recurrenceRule->setAllDay(allDay);
+        event->recurrence()->addRRule(recurrenceRule);
+        return event;
+    }
+
+    static QDateTime berlin(const QDate &date, const QTime &time = QTime(9, 0))
+    {
+        return QDateTime(date, time, QTimeZone("Europe/Berlin"));
+    }
+
+    // Stand-ups recurring since 2012, with some exceptions, and a few incidences the fast path doesn't handle
+    static MemoryCalendar::Ptr createCalendar(int seriesCount)
+    {
+        MemoryCalendar::Ptr calendar(new MemoryCalendar(QTimeZone("Europe/Berlin")));
+        for (int i = 0; i < seriesCount; ++i) {
+            const auto start = berlin(QDate(2012, 1, 2).addDays(i % 5), QTime(8 + i % 8, 0));
+            const auto event = createEvent(QStringLiteral("series-%1").arg(i), start, QStringLiteral("FREQ=WEEKLY"));
+            // Moved, canceled and excluded occurrences in March 2026
+            event->recurrence()->addExDate(start.date().addDays(7 * 742));
+            calendar->addEvent(event);
+
+            Event::Ptr moved(event->clone());
+            moved->setRecurrenceId(start.addDays(7 * 740));
+            moved->setDtStart(moved->recurrenceId().addSecs(3600));
+            moved->setDtEnd(moved->dtStart().addSecs(15 * 60));
+            moved->clearRecurrence();
+            calendar->addEvent(moved);
+            Event::Ptr canceled(event->clone());
+            canceled->setRecurrenceId(start.addDays(7 * 741));
+            canceled->setStatus(Incidence::StatusCanceled);
+            canceled->clearRecurrence();
+            calendar->addEvent(canceled);
+        }
+        calendar->addEvent(createEvent(QStringLiteral("last sunday"), berlin(QDate(2012, 1, 29)), QStringLiteral("FREQ=MONTHLY;BYDAY=-1SU")));
+        Event::Ptr single(new Event);
+        single->setUid(QStringLiteral("single"));
+        single->setDtStart(berlin(QDate(2026, 3, 4)));
+        single->setDtEnd(berlin(QDate(2026, 3, 4), QTime(10, 0)));
+        calendar->addEvent(single);
+        return calendar;
+    }
+
+    template<typename Iterator>
+    static QStringList occurrences(Iterator &iterator)
+    {
+        QStringList occurrences;
+        while (iterator.hasNext()) {
+            iterator.next();
+            occurrences << iterator.incidence()->instanceIdentifier() + QLatin1Char(' ') + iterator.occurrenceStartDate().toUTC().toString(Qt::ISODate);
+        }
+        occurrences.sort();
+        return occurrences;
+    }
+
+private Q_SLOTS:
+    void init()
+    {
+        KALENDAR_SKIP_BENCHMARKS();
+    }
+
+    void testSameTimes_data()
+    {
+        QTest::addColumn<QDateTime>("start");
+        QTest::addColumn<QString>("rule");
+        QTest::addColumn<bool>("allDay");
+        QTest::addColumn<bool>("simple");
+
+        const auto monday = berlin(QDate(2012, 1, 2));
+        QTest::newRow("daily") << monday << QStringLiteral("FREQ=DAILY") << false << true;
+        QTest::newRow("every third day, count") << monday << QStringLiteral("FREQ=DAILY;INTERVAL=3;COUNT=1500") << false << true;
+        QTest::newRow("daily, until") << monday << QStringLiteral("FREQ=DAILY;UNTIL=20260310T080000Z") << false << true;
+        QTest::newRow("weekly") << monday << QStringLiteral("FREQ=WEEKLY") << false << true;
+        QTest::newRow("weekly, days, count") << monday << QStringLiteral("FREQ=WEEKLY;BYDAY=MO,WE,FR;COUNT=2100") << false << true;
+        QTest::newRow("biweekly, days") << berlin(QDate(2012, 1, 4)) << QStringLiteral("FREQ=WEEKLY;INTERVAL=2;BYDAY=MO,WE,SU") << false << true;
+        QTest::newRow("biweekly, week start") << berlin(QDate(2012, 1, 4)) << QStringLiteral("FREQ=WEEKLY;INTERVAL=2;BYDAY=TU,WE,SU;WKST=SU") << false << true;
+        QTest::newRow("weekly, until") << monday << QStringLiteral("FREQ=WEEKLY;UNTIL=20260316T080000Z") << false << true;
+        QTest::newRow("monthly") << berlin(QDate(2012, 1, 15)) << QStringLiteral("FREQ=MONTHLY") << false << true;
+        QTest::newRow("monthly, day") << berlin(QDate(2012, 1, 15)) << QStringLiteral("FREQ=MONTHLY;BYMONTHDAY=15;COUNT=175") << false << true;
+        QTest::newRow("monthly, 31st") << berlin(QDate(2012, 1, 31)) << QStringLiteral("FREQ=MONTHLY;BYMONTHDAY=31") << false << true;
+        QTest::newRow("quarterly") << berlin(QDate(2012, 2, 10)) << QStringLiteral("FREQ=MONTHLY;INTERVAL=3;UNTIL=20261231T000000Z") << false << true;
+        QTest::newRow("start not matching") << monday << QStringLiteral("FREQ=WEEKLY;BYDAY=TU") << false << false;
+        QTest::newRow("monthly by weekday") << monday << QStringLiteral("FREQ=MONTHLY;BYDAY=1MO") << false << false;
+        QTest::newRow("31st counted") << berlin(QDate(2012, 1, 31)) << QStringLiteral("FREQ=MONTHLY;COUNT=100") << false << false;
+        QTest::newRow("yearly") << monday << QStringLiteral("FREQ=YEARLY") << false << false;
+
+        // All day occurrences start at midnight, so only the excluded date applies to them, not the excluded time
+        const auto mondayDate = berlin(QDate(2012, 1, 2), QTime(0, 0));
+        QTest::newRow("all day, daily") << mondayDate << QStringLiteral("FREQ=DAILY") << true << true;
+        QTest::newRow("all day, weekly") << mondayDate << QStringLiteral("FREQ=WEEKLY") << true << true;
+        QTest::newRow("all day, weekly, days, count") << mondayDate << QStringLiteral("FREQ=WEEKLY;BYDAY=MO,WE,FR;COUNT=2100") << true << true;
+        QTest::newRow("all day, monthly") << berlin(QDate(2012, 1, 15), QTime(0, 0)) << QStringLiteral("FREQ=MONTHLY") << true << true;
+        QTest::newRow("all day, monthly, 31st") << berlin(QDate(2012, 1, 31), QTime(0, 0)) << QStringLiteral("FREQ=MONTHLY;BYMONTHDAY=31") << true << true;
+    }
+
+    void testSameTimes()
+    {
+        QFETCH(QDateTime, start);
+        QFETCH(QString, rule);
+        QFETCH(bool, allDay);
+        QFETCH(bool, simple);
+
+        auto event = createEvent(QStringLiteral("event"), start, rule, allDay);
+        event->recurrence()->addExDate(QDate(2026, 3, 11));
+        event->recurrence()->addExDateTime(berlin(QDate(2026, 3, 13)));
+        const auto recurrence = event->recurrence();
+        QCOMPARE(OccurrenceExpander::isSimple(recurrence), simple);
+
+        const QVector<std::pair<QDateTime, QDateTime>> ranges = {
+            {berlin(QDate(2011, 1, 1)), berlin(QDate(2011, 12, 31))},
+            {berlin(QDate(2011, 12, 1)), berlin(QDate(2012, 2, 15))},
+            {berlin(QDate(2026, 3, 2), QTime(0, 0)), berlin(QDate(2026, 4, 12), QTime(23, 59))},
+            // Bounds on an occurrence, and around a daylight saving time change
+            {berlin(QDate(2026, 3, 16)), berlin(QDate(2026, 3, 16))},
+            {QDateTime(QDate(2026, 3, 28), QTime(0, 0), Qt::UTC), QDateTime(QDate(2026, 3, 30), QTime(12, 0), Qt::UTC)},
+            {berlin(QDate(2030, 6, 1)), berlin(QDate(2031, 6, 1))},
+        };
+        for (const auto &range : ranges) {
+            QCOMPARE(OccurrenceExpander::timesInInterval(recurrence, range.first, range.second), recurrence->timesInInterval(range.first, range.second));
+        }
+    }
+
+    void testSameOccurrences()
+    {
+        const auto calendar = createCalendar(20);
+        const auto start = berlin(QDate(2026, 3, 1), QTime(0, 0));
+        const auto end = berlin(QDate(2026, 4, 1), QTime(0, 0));
+
+        OccurrenceIterator iterator(*calendar, start, end);
+        OccurrenceExpander expander(*calendar, start, end);
+        const auto expected = occurrences(iterator);
+        QVERIFY(expected.count() > 40);
+        QCOMPARE(occurrences(expander), expected);
+    }
+
+    void benchmarkExpansion_data()
+    {
+        QTest::addColumn<int>("seriesCount");
+        QTest::addColumn<bool>("fast");
+
+        for (const int seriesCount : {10, 100, 1000}) {
+            QTest::addRow("OccurrenceIterator, %d series", seriesCount) << seriesCount << false;
+            QTest::addRow("OccurrenceExpander, %d series", seriesCount) << seriesCount << true;
+        }
+    }
+
+    // A month in 2026 of weekly series started in 2012
+    void benchmarkExpansion()
+    {
+        QFETCH(int, seriesCount);
+        QFETCH(bool, fast);
+
+        const auto calendar = createCalendar(seriesCount);
+        const auto start = berlin(QDate(2026, 3, 1), QTime(0, 0));
+        const auto end = berlin(QDate(2026, 4, 1), QTime(0, 0));
+        int count = 0;
+        if (fast) {
+            QBENCHMARK {
+                OccurrenceExpander expander(*calendar, start, end);
+                while (expander.hasNext()) {
+                    expander.next();
+                    ++count;
+                }
+            }
+        } else {
+            QBENCHMARK {
+                OccurrenceIterator iterator(*calendar, start, end);
+                while (iterator.hasNext()) {
+                    iterator.next();
+                    ++count;
+                }
+            }
+        }
+        QVERIFY(count > 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(OccurrenceExpanderBenchmark)
+#include "occurrenceexpanderbenchmark.moc"
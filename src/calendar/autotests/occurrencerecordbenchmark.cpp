@@ -0,0 +1,299 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include <models/occurrencerecord.h>
+
+#include <KCalendarCore/Event>
+#include <KCalendarCore/Todo>
+#include <KCheckableProxyModel>
+#include <KFormat>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QSignalSpy>
+#include <QTest>
+#include <akonadi/qtest_akonadi.h>
+#include <benchmarkhelper.h>
+#include <memory>
+
+using namespace KCalendarCore;
+
+// Binds the properties the delegates of the views read
+static const char delegateSource[] = R"(
+import QtQml 2.15
+
+QtObject {
+    property var modelData
+
+    readonly property string text: modelData.text
+    readonly property string description: modelData.description
+    readonly property string location: modelData.location
+    readonly property date startTime: modelData.startTime
+    readonly property date endTime: modelData.endTime
+    readonly property bool allDay: modelData.allDay
+    readonly property bool todoCompleted: modelData.todoCompleted
+    readonly property int priority: modelData.priority
+    readonly property string durationString: modelData.durationString
+    readonly property bool recurs: modelData.recurs
+    readonly property bool hasReminders: modelData.hasReminders
+    readonly property bool isOverdue: modelData.isOverdue
+    readonly property bool isReadOnly: modelData.isReadOnly
+    readonly property var color: modelData.color
+    readonly property var collectionId: modelData.collectionId
+    readonly property string incidenceId: modelData.incidenceId
+    readonly property int incidenceType: modelData.incidenceType
+    readonly property string incidenceTypeStr: modelData.incidenceTypeStr
+    readonly property string incidenceTypeIcon: modelData.incidenceTypeIcon
+    readonly property real starts: modelData.starts
+    readonly property real duration: modelData.duration
+}
+)";
+
+class OccurrenceRecordBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QVector<IncidenceOccurrenceModel::Occurrence> createOccurrences(int count)
+    {
+        QVector<IncidenceOccurrenceModel::Occurrence> occurrences;
+        for (int i = 0; i < count; ++i) {
+            const QDateTime start(QDate(2022, 3, 1).addDays(i % 7), QTime(8 + i % 10, 0), Qt::UTC);
+            Incidence::Ptr incidence;
+            if (i % 3 == 0) {
+                Todo::Ptr todo(new Todo);
+                todo->setDtDue(start.addSecs(1800));
+                todo->setCompleted(i % 2 == 0);
+                incidence = todo;
+            } else {
+                Event::Ptr event(new Event);
+                event->setDtStart(start);
+                event->setDtEnd(start.addSecs(3600));
+                incidence = event;
+            }
+            incidence->setUid(QStringLiteral("incidence-%1").arg(i));
+            incidence->setSummary(QStringLiteral("Incidence %1").arg(i));
+            incidence->setLocation(QStringLiteral("Room %1").arg(i % 5));
+            incidence->setPriority(i % 10);
+            if (i % 4 == 0) {
+                incidence->newAlarm();
+            }
+
+            IncidenceOccurrenceModel::Occurrence occurrence{start, start.addSecs(3600), incidence, QColor(Qt::darkCyan), 1, false};
+            occurrences.append(occurrence);
+        }
+        return occurrences;
+    }
+
+    // The role map of a record, to compare the bindings of both
+    static QVariantMap toMap(const OccurrenceRecord &record)
+    {
+        return QVariantMap{
+            {QStringLiteral("text"), record.text()},
+            {QStringLiteral("description"), record.description()},
+            {QStringLiteral("location"), record.location()},
+            {QStringLiteral("startTime"), record.startTime()},
+            {QStringLiteral("endTime"), record.endTime()},
+            {QStringLiteral("allDay"), record.allDay()},
+            {QStringLiteral("todoCompleted"), record.todoCompleted()},
+            {QStringLiteral("priority"), record.priority()},
+            {QStringLiteral("starts"), record.starts()},
+            {QStringLiteral("duration"), record.duration()},
+            {QStringLiteral("durationString"), record.durationString()},
+            {QStringLiteral("recurs"), record.recurs()},
+            {QStringLiteral("hasReminders"), record.hasReminders()},
+            {QStringLiteral("isOverdue"), record.isOverdue()},
+            {QStringLiteral("isReadOnly"), record.isReadOnly()},
+            {QStringLiteral("color"), record.color()},
+            {QStringLiteral("collectionId"), record.collectionId()},
+            {QStringLiteral("incidenceId"), record.incidenceId()},
+            {QStringLiteral("incidenceType"), record.incidenceType()},
+            {QStringLiteral("incidenceTypeStr"), record.incidenceTypeStr()},
+            {QStringLiteral("incidenceTypeIcon"), record.incidenceTypeIcon()},
+            {QStringLiteral("incidencePtr"), QVariant::fromValue(record.incidencePtr())},
+            {QStringLiteral("incidenceOccurrence"), QVariant::fromValue(record.incidenceOccurrence())},
+        };
+    }
+
+    static OccurrenceRecord positioned(OccurrenceRecord record, int index)
+    {
+        record.setStarts(index % 7);
+        record.setDuration(1);
+        return record;
+    }
+
+    // What the layout models put in their lists before, reading each role from the model
+    static QVariantMap roleMap(const QModelIndex &idx, int index)
+    {
+        return QVariantMap{
+            {QStringLiteral("text"), idx.data(IncidenceOccurrenceModel::Summary)},
+            {QStringLiteral("description"), idx.data(IncidenceOccurrenceModel::Description)},
+            {QStringLiteral("location"), idx.data(IncidenceOccurrenceModel::Location)},
+            {QStringLiteral("startTime"), idx.data(IncidenceOccurrenceModel::StartTime)},
+            {QStringLiteral("endTime"), idx.data(IncidenceOccurrenceModel::EndTime)},
+            {QStringLiteral("allDay"), idx.data(IncidenceOccurrenceModel::AllDay)},
+            {QStringLiteral("todoCompleted"), idx.data(IncidenceOccurrenceModel::TodoCompleted)},
+            {QStringLiteral("priority"), idx.data(IncidenceOccurrenceModel::Priority)},
+            {QStringLiteral("starts"), index % 7},
+            {QStringLiteral("duration"), 1},
+            {QStringLiteral("durationString"), idx.data(IncidenceOccurrenceModel::DurationString)},
+            {QStringLiteral("recurs"), idx.data(IncidenceOccurrenceModel::Recurs)},
+            {QStringLiteral("hasReminders"), idx.data(IncidenceOccurrenceModel::HasReminders)},
+            {QStringLiteral("isOverdue"), idx.data(IncidenceOccurrenceModel::IsOverdue)},
+            {QStringLiteral("isReadOnly"), idx.data(IncidenceOccurrenceModel::IsReadOnly)},
+            {QStringLiteral("color"), idx.data(IncidenceOccurrenceModel::Color)},
+            {QStringLiteral("collectionId"), idx.data(IncidenceOccurrenceModel::CollectionId)},
+            {QStringLiteral("incidenceId"), idx.data(IncidenceOccurrenceModel::IncidenceId)},
+            {QStringLiteral("incidenceType"), idx.data(IncidenceOccurrenceModel::IncidenceType)},
+            {QStringLiteral("incidenceTypeStr"), idx.data(IncidenceOccurrenceModel::IncidenceTypeStr)},
+            {QStringLiteral("incidenceTypeIcon"), idx.data(IncidenceOccurrenceModel::IncidenceTypeIcon)},
+            {QStringLiteral("incidencePtr"), idx.data(IncidenceOccurrenceModel::IncidencePtr)},
+            {QStringLiteral("incidenceOccurrence"), idx.data(IncidenceOccurrenceModel::IncidenceOccurrence)},
+        };
+    }
+
+    static void checkAllItems(KCheckableProxyModel *model, const QModelIndex &parent = QModelIndex())
+    {
+        const int rowCount = model->rowCount(parent);
+        for (int row = 0; row < rowCount; ++row) {
+            QModelIndex index = model->index(row, 0, parent);
+            model->setData(index, Qt::Checked, Qt::CheckStateRole);
+
+            if (model->rowCount(index) > 0) {
+                checkAllItems(model, index);
+            }
+        }
+    }
+
+    // The benchmarks read the test calendar of the isolated Akonadi environment
+    bool loadCalendar()
+    {
+        if (m_calendar) {
+            return true;
+        }
+
+        m_calendar.reset(new Akonadi::ETMCalendar);
+        QSignalSpy collectionsAdded(m_calendar.data(), &Akonadi::ETMCalendar::collectionsAdded);
+        if (!collectionsAdded.wait(10000)) {
+            return false;
+        }
+        QSignalSpy calendarChanged(m_calendar.data(), &Akonadi::ETMCalendar::calendarChanged);
+        if (!calendarChanged.wait(10000)) {
+            return false;
+        }
+        checkAllItems(m_calendar->checkableProxyModel());
+        return !m_calendar->isLoading();
+    }
+
+    QQmlEngine m_engine;
+    Akonadi::ETMCalendar::Ptr m_calendar;
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        qRegisterMetaType<OccurrenceRecord>();
+    }
+
+    void init()
+    {
+        // The benchmarks need the isolated Akonadi environment:
+        // akonaditest -c autotests/unittestenv/config.xml occurrencerecordbenchmark
+        KALENDAR_SKIP_BENCHMARKS();
+    }
+
+    void testRecord()
+    {
+        const auto occurrences = createOccurrences(3);
+        const OccurrenceRecord todo(occurrences.at(0), true, KFormat());
+        QCOMPARE(todo.text(), QStringLiteral("Incidence 0"));
+        QCOMPARE(todo.incidenceType(), int(Incidence::TypeTodo));
+        QCOMPARE(todo.incidenceTypeStr(), QStringLiteral("Task"));
+        QVERIFY(todo.todoCompleted());
+        QVERIFY(todo.hasReminders());
+        QVERIFY(todo.isReadOnly());
+
+        const OccurrenceRecord event(occurrences.at(1), false, KFormat());
+        QCOMPARE(event.incidenceType(), int(Incidence::TypeEvent));
+        QVERIFY(!event.todoCompleted());
+        QVERIFY(!event.isOverdue());
+        QVERIFY(!event.durationString().isEmpty());
+
+        // Copies share the formatted strings, not the position
+        auto copy = event;
+        copy.setStarts(3);
+        QCOMPARE(copy.durationString(), event.durationString());
+        QCOMPARE(event.starts(), 0.0);
+        QCOMPARE(copy.starts(), 3.0);
+    }
+
+    void testSameBindings()
+    {
+        QQmlComponent component(&m_engine);
+        component.setData(delegateSource, QUrl());
+        QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+        const auto occurrences = createOccurrences(6);
+        for (int i = 0; i < occurrences.count(); ++i) {
+            const auto record = positioned(OccurrenceRecord(occurrences.at(i), i % 2, KFormat()), i);
+            std::unique_ptr<QObject> fromMap(component.createWithInitialProperties({{QStringLiteral("modelData"), toMap(record)}}));
+            std::unique_ptr<QObject> fromRecord(component.createWithInitialProperties({{QStringLiteral("modelData"), QVariant::fromValue(record)}}));
+            QVERIFY(fromMap && fromRecord);
+
+            const auto metaObject = fromMap->metaObject();
+            for (int property = metaObject->propertyOffset(); property < metaObject->propertyCount(); ++property) {
+                const char *name = metaObject->property(property).name();
+                if (qstrcmp(name, "modelData") == 0) {
+                    continue;
+                }
+                QCOMPARE(fromRecord->property(name), fromMap->property(name));
+            }
+        }
+    }
+
+    void benchmarkDelegates_data()
+    {
+        QTest::addColumn<int>("days");
+        QTest::addColumn<bool>("records");
+
+        // The test calendar has an all-day event every day
+        for (const int days : {100, 1000}) {
+            QTest::addRow("roles, %d days", days) << days << false;
+            QTest::addRow("records, %d days", days) << days << true;
+        }
+    }
+
+    // Reading the occurrences from the model and creating their delegates, as the layout models do each time they lay out
+    void benchmarkDelegates()
+    {
+        QFETCH(int, days);
+        QFETCH(bool, records);
+
+        AkonadiTest::checkTestIsIsolated();
+        QVERIFY(loadCalendar());
+
+        QQmlComponent component(&m_engine);
+        component.setData(delegateSource, QUrl());
+        QVERIFY(component.isReady());
+
+        IncidenceOccurrenceModel model;
+        QSignalSpy loadingChanged(&model, &IncidenceOccurrenceModel::loadingChanged);
+        model.setStart(QDate(2022, 1, 10));
+        model.setLength(days);
+        model.setCalendar(m_calendar);
+        QVERIFY(loadingChanged.wait(10000));
+        QVERIFY(!model.loading());
+        QVERIFY(model.rowCount() > days);
+
+        QBENCHMARK {
+            for (int row = 0; row < model.rowCount(); ++row) {
+                const auto idx = model.index(row, 0);
+                const QVariant modelData =
+                    records ? QVariant::fromValue(positioned(idx.data(IncidenceOccurrenceModel::Record).value<OccurrenceRecord>(), row)) : roleMap(idx, row);
+                std::unique_ptr<QObject> delegate(component.createWithInitialProperties({{QStringLiteral("modelData"), modelData}}));
+                QVERIFY(delegate);
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(OccurrenceRecordBenchmark)
+#include "occurrencerecordbenchmark.moc"
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include <timezonecache.h>
+
+#include <QTest>
+
+class TimeZoneCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testConversions_data()
+    {
+        QTest::addColumn<QByteArray>("timeZone");
+
+        QTest::newRow("utc") << QByteArrayLiteral("UTC");
+        QTest::newRow("daylight saving") << QByteArrayLiteral("Europe/Berlin");
+        QTest::newRow("southern hemisphere") << QByteArrayLiteral("Australia/Sydney");
+        // Half an hour offset, and half an hour of daylight saving
+        QTest::newRow("half hours") << QByteArrayLiteral("Australia/Lord_Howe");
+        QTest::newRow("west of utc") << QByteArrayLiteral("America/St_Johns");
+    }
+
+    void testConversions()
+    {
+        QFETCH(QByteArray, timeZone);
+
+        const QTimeZone zone(timeZone);
+        QVERIFY(zone.isValid());
+        const QDateTime from(QDate(2022, 1, 1), QTime(0, 0), Qt::UTC);
+        const QDateTime to(QDate(2023, 1, 1), QTime(0, 0), Qt::UTC);
+        const TimeZoneCache cache(zone, from, to);
+
+        // Every 7 hours and 13 minutes over two years, so within the window and around it
+        for (auto time = from.addYears(-1); time < to.addYears(1); time = time.addSecs(7 * 3600 + 13 * 60)) {
+            const qint64 secs = time.toSecsSinceEpoch();
+            const auto local = time.toTimeZone(zone);
+            QCOMPARE(cache.offsetFromUtc(secs), local.offsetFromUtc());
+            QCOMPARE(cache.localDate(secs), local.date());
+            QCOMPARE(cache.localMinuteOfDay(secs), local.time().hour() * 60 + local.time().minute());
+            QCOMPARE(cache.localDay(secs), TimeZoneCache::dayOf(local.date()));
+        }
+    }
+
+    void testTransitions()
+    {
+        const QTimeZone zone("Europe/Berlin");
+        const TimeZoneCache cache(zone, QDateTime(QDate(2022, 3, 1), QTime(0, 0), zone), QDateTime(QDate(2022, 11, 1), QTime(0, 0), zone));
+
+        // Summer time starts at 01:00 UTC, and ends at 01:00 UTC
+        const qint64 summerStart = QDateTime(QDate(2022, 3, 27), QTime(1, 0), Qt::UTC).toSecsSinceEpoch();
+        QCOMPARE(cache.offsetFromUtc(summerStart - 1), 3600);
+        QCOMPARE(cache.offsetFromUtc(summerStart), 7200);
+        QCOMPARE(cache.localMinuteOfDay(summerStart), 3 * 60);
+
+        const qint64 summerEnd = QDateTime(QDate(2022, 10, 30), QTime(1, 0), Qt::UTC).toSecsSinceEpoch();
+        QCOMPARE(cache.offsetFromUtc(summerEnd - 1), 7200);
+        QCOMPARE(cache.offsetFromUtc(summerEnd), 3600);
+        QCOMPARE(cache.localMinuteOfDay(summerEnd), 2 * 60);
+    }
+
+    void testBeforeEpoch()
+    {
+        const QDateTime time(QDate(1969, 12, 31), QTime(23, 30), Qt::UTC);
+        const TimeZoneCache cache(QTimeZone::utc(), time.addDays(-1), time.addDays(1));
+
+        QCOMPARE(cache.localDay(time.toSecsSinceEpoch()), -1);
+        QCOMPARE(cache.localDate(time.toSecsSinceEpoch()), time.date());
+        QCOMPARE(cache.localMinuteOfDay(time.toSecsSinceEpoch()), 23 * 60 + 30);
+    }
+};
+
+QTEST_MAIN(TimeZoneCacheTest)
+#include "timezonecachetest.moc"
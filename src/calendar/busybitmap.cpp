@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "busybitmap.h"
+
+#include <QtAlgorithms>
+
+#include <algorithm>
+
+namespace
+{
+constexpr int wordBits = 64;
+
+quint64 bitRange(int first, int count)
+{
+    return (count == wordBits ? ~quint64(0) : (quint64(1) << count) - 1) << first;
+}
+}
+
+BusyBitmap::BusyBitmap(const QDateTime &start, const QDateTime &end, int resolution)
+    : m_start(start)
+    , m_resolution(std::max(1, resolution))
+{
+    const qint64 seconds = std::max<qint64>(0, start.secsTo(end));
+    const qint64 slotSeconds = m_resolution * 60;
+    m_slotCount = int((seconds + slotSeconds - 1) / slotSeconds);
+    m_words.fill(0, (m_slotCount + wordBits - 1) / wordBits);
+
+    const int padding = m_words.size() * wordBits - m_slotCount;
+    if (padding > 0) {
+        m_words.last() = bitRange(wordBits - padding, padding);
+    }
+}
+
+bool BusyBitmap::isNull() const
+{
+    return m_slotCount == 0;
+}
+
+QDateTime BusyBitmap::start() const
+{
+    return m_start;
+}
+
+int BusyBitmap::resolution() const
+{
+    return m_resolution;
+}
+
+int BusyBitmap::slotCount() const
+{
+    return m_slotCount;
+}
+
+QDateTime BusyBitmap::slotStart(int slot) const
+{
+    return m_start.addSecs(qint64(slot) * m_resolution * 60);
+}
+
+int BusyBitmap::slotIndex(const QDateTime &dateTime, bool roundUp) const
+{
+    const qint64 seconds = m_start.secsTo(dateTime);
+    const qint64 slotSeconds = m_resolution * 60;
+    qint64 slot = seconds / slotSeconds;
+    if (seconds % slotSeconds != 0 && (seconds > 0) == roundUp) {
+        slot += seconds > 0 ? 1 : -1;
+    }
+    return int(std::clamp<qint64>(slot, 0, m_slotCount));
+}
+
+void BusyBitmap::markBusy(const QDateTime &from, const QDateTime &to)
+{
+    const int first = slotIndex(from, false);
+    const int last = slotIndex(to, true);
+    for (int slot = first; slot < last;) {
+        const int bit = slot % wordBits;
+        const int count = std::min(wordBits - bit, last - slot);
+        m_words[slot / wordBits] |= bitRange(bit, count);
+        slot += count;
+    }
+}
+
+bool BusyBitmap::isBusy(int slot) const
+{
+    Q_ASSERT(slot >= 0 && slot < m_slotCount);
+    return m_words.at(slot / wordBits) & (quint64(1) << (slot % wordBits));
+}
+
+bool BusyBitmap::isFree(const QDateTime &from, const QDateTime &to) const
+{
+    const int first = slotIndex(from, false);
+    const int last = slotIndex(to, true);
+    for (int slot = first; slot < last;) {
+        const int bit = slot % wordBits;
+        const int count = std::min(wordBits - bit, last - slot);
+        if (m_words.at(slot / wordBits) & bitRange(bit, count)) {
+            return false;
+        }
+        slot += count;
+    }
+    return true;
+}
+
+BusyBitmap &BusyBitmap::operator|=(const BusyBitmap &other)
+{
+    Q_ASSERT(other.m_start == m_start && other.m_resolution == m_resolution && other.m_slotCount == m_slotCount);
+    for (int i = 0; i < m_words.size(); ++i) {
+        m_words[i] |= other.m_words.at(i);
+    }
+    return *this;
+}
+
+QVector<BusyBitmap::Slot> BusyBitmap::freeSlots(int duration, int count) const
+{
+    QVector<Slot> slots;
+    const int slotsNeeded = std::max(1, (duration + m_resolution - 1) / m_resolution);
+
+    // Skips whole runs of free or busy slots with one bit count each
+    int freeRun = 0;
+    int slot = 0;
+    while (slot < m_slotCount && slots.size() < count) {
+        const int bit = slot % wordBits;
+        const quint64 word = m_words.at(slot / wordBits) >> bit;
+        const int freeBits = word == 0 ? wordBits - bit : qCountTrailingZeroBits(word);
+        freeRun += freeBits;
+        slot += freeBits;
+
+        while (freeRun >= slotsNeeded && slots.size() < count) {
+            const auto start = slotStart(slot - freeRun);
+            slots.append({start, start.addSecs(qint64(duration) * 60)});
+            freeRun -= slotsNeeded;
+        }
+
+        if (word != 0) {
+            // The zeros shifted in are ones once inverted, so this stops at the end of the word at the latest
+            slot += qCountTrailingZeroBits(~(word >> freeBits));
+            freeRun = 0;
+        }
+    }
+    return slots;
+}
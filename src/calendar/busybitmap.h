@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <QDateTime>
+#include <QVector>
+
+/**
+ * The busy times of a period, as one bit per slot of a few minutes.
+ *
+ * Bitmaps of the same period combine with whole word operations, so the common free time of
+ * many people over weeks only takes a few thousand operations.
+ */
+class BusyBitmap
+{
+public:
+    struct Slot {
+        QDateTime start;
+        QDateTime end;
+    };
+
+    BusyBitmap() = default;
+    /// A free bitmap from @p start to @p end, by slots of @p resolution minutes
+    BusyBitmap(const QDateTime &start, const QDateTime &end, int resolution);
+
+    bool isNull() const;
+    QDateTime start() const;
+    int resolution() const;
+    int slotCount() const;
+    QDateTime slotStart(int slot) const;
+
+    /// Marks the slots overlapping @p from to @p to busy
+    void markBusy(const QDateTime &from, const QDateTime &to);
+    bool isBusy(int slot) const;
+    /// Whether all the slots overlapping @p from to @p to are free
+    bool isFree(const QDateTime &from, const QDateTime &to) const;
+
+    /// Makes the slots busy when busy in @p other too, which must cover the same slots
+    BusyBitmap &operator|=(const BusyBitmap &other);
+
+    /**
+     * Returns up to @p count free slots of @p duration minutes, in order, each one starting
+     * where the previous one ends or later.
+     */
+    QVector<Slot> freeSlots(int duration, int count) const;
+
+private:
+    int slotIndex(const QDateTime &dateTime, bool roundUp) const;
+
+    QDateTime m_start;
+    int m_resolution = 15;
+    int m_slotCount = 0;
+    // Bit n of word n / 64 is slot n, the bits after the last slot are busy
+    QVector<quint64> m_words;
+};
@@ -0,0 +1,373 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "calendarexporter.h"
+#include "icalendarwriter.h"
+#include "kalendar_calendar_debug.h"
+
+#include <Akonadi/CollectionFetchJob>
+#include <Akonadi/CollectionFetchScope>
+#include <Akonadi/ItemFetchJob>
+#include <Akonadi/ItemFetchScope>
+#include <KCalendarCore/Event>
+#include <KCalendarCore/Journal>
+#include <KCalendarCore/Todo>
+#include <KLocalizedString>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <utility>
+
+// Items fetched and serialized at once
+static constexpr int exportBatchSize = 200;
+
+IncidenceRangeFilter::IncidenceRangeFilter(const QDateTime &from, const QDateTime &to)
+    : m_from(from)
+    , m_to(to)
+{
+}
+
+KCalendarCore::Incidence::List IncidenceRangeFilter::add(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    if (!incidence->recurs() && !incidence->hasRecurrenceId()) {
+        return CalendarExporter::occursWithin(incidence, m_from, m_to) ? KCalendarCore::Incidence::List{incidence} : KCalendarCore::Incidence::List{};
+    }
+
+    auto &series = m_series[incidence->uid()];
+    if (series.exported) {
+        return {incidence};
+    }
+    if (incidence->hasRecurrenceId()) {
+        series.exceptions.append(incidence);
+    } else {
+        series.master = incidence;
+    }
+    series.occurs = series.occurs || CalendarExporter::occursWithin(incidence, m_from, m_to);
+    if (!series.occurs || !series.master) {
+        return {};
+    }
+
+    KCalendarCore::Incidence::List incidences{series.master};
+    incidences += series.exceptions;
+    series.master.clear();
+    series.exceptions.clear();
+    series.exported = true;
+    return incidences;
+}
+
+int IncidenceRangeFilter::heldExceptionCount() const
+{
+    int count = 0;
+    for (const auto &series : m_series) {
+        count += series.exceptions.count();
+    }
+    return count;
+}
+
+CalendarExporter::CalendarExporter(QObject *parent)
+    : QObject(parent)
+    , m_writerContext(new QObject)
+{
+    m_writerThread.setObjectName(QStringLiteral("CalendarExporterWriter"));
+    m_writerContext->moveToThread(&m_writerThread);
+}
+
+CalendarExporter::~CalendarExporter()
+{
+    m_writerThread.quit();
+    m_writerThread.wait();
+    if (m_file) {
+        m_file->cancelWriting();
+    }
+}
+
+void CalendarExporter::exportToUrl(const QUrl &url, const QVariantList &collectionIds, const QDateTime &from, const QDateTime &to)
+{
+    if (m_running) {
+        return;
+    }
+    if (!url.isLocalFile()) {
+        m_errorMessage = i18n("Unable to write %1: only local files are supported", url.toDisplayString());
+        Q_EMIT errorMessageChanged();
+        Q_EMIT finished(false);
+        return;
+    }
+
+    Akonadi::Collection::List collections;
+    collections.reserve(collectionIds.count());
+    for (const auto &collectionId : collectionIds) {
+        collections.append(Akonadi::Collection(collectionId.toLongLong()));
+    }
+    exportToFile(url.toLocalFile(), collections, from, to);
+}
+
+void CalendarExporter::exportToFile(const QString &fileName, const Akonadi::Collection::List &collections, const QDateTime &from, const QDateTime &to)
+{
+    if (m_running) {
+        return;
+    }
+
+    m_file = std::make_unique<QSaveFile>(fileName);
+    if (!m_file->open(QIODevice::WriteOnly)) {
+        m_errorMessage = i18n("Unable to write %1: %2", fileName, m_file->errorString());
+        Q_EMIT errorMessageChanged();
+        m_file.reset();
+        Q_EMIT finished(false);
+        return;
+    }
+    m_writer = std::make_unique<ICalendarWriter>(m_file.get());
+    // Started on first use, as many exporters are created without ever being used
+    if (!m_writerThread.isRunning()) {
+        m_writerThread.start();
+    }
+    m_collections = collections;
+    m_rangeFilter.reset(from.isValid() || to.isValid() ? new IncidenceRangeFilter(from, to) : nullptr);
+    m_pendingItems.clear();
+    m_fetchedIncidences.clear();
+    m_fetching = false;
+    m_batchFetched = false;
+    m_writing = false;
+    m_writeFailed = false;
+    m_deferredErrorMessage.clear();
+
+    m_running = true;
+    m_totalCount = -1;
+    m_processedCount = 0;
+    m_exportedCount = 0;
+    m_errorMessage.clear();
+    m_timer.start();
+    Q_EMIT runningChanged();
+    Q_EMIT errorMessageChanged();
+    Q_EMIT progressChanged();
+
+    if (m_collections.isEmpty()) {
+        fetchCollections();
+    } else {
+        listItems();
+    }
+}
+
+void CalendarExporter::fetchCollections()
+{
+    const QStringList mimeTypes = {
+        KCalendarCore::Event::eventMimeType(),
+        KCalendarCore::Todo::todoMimeType(),
+        KCalendarCore::Journal::journalMimeType(),
+    };
+    auto job = new Akonadi::CollectionFetchJob(Akonadi::Collection::root(), Akonadi::CollectionFetchJob::Recursive, this);
+    job->fetchScope().setContentMimeTypes(mimeTypes);
+    connect(job, &KJob::result, this, [this, job, mimeTypes]() {
+        if (job->error()) {
+            qCWarning(KALENDAR_CALENDAR_LOG) << "Error fetching the calendars to export:" << job->errorString();
+            finish(i18n("Unable to find the calendars: %1", job->errorString()));
+            return;
+        }
+        const auto collections = job->collections();
+        for (const auto &collection : collections) {
+            const auto contentMimeTypes = collection.contentMimeTypes();
+            if (std::any_of(mimeTypes.cbegin(), mimeTypes.cend(), [&contentMimeTypes](const QString &mimeType) {
+                    return contentMimeTypes.contains(mimeType);
+                })) {
+                m_collections.append(collection);
+            }
+        }
+        listItems();
+    });
+}
+
+void CalendarExporter::listItems()
+{
+    if (m_collections.isEmpty()) {
+        m_totalCount = m_pendingItems.count();
+        pump();
+        return;
+    }
+
+    // Listing the items without their payload is cheap, even for large calendars
+    auto job = new Akonadi::ItemFetchJob(m_collections.takeFirst(), this);
+    job->fetchScope().setFetchModificationTime(false);
+    job->setDeliveryOption(Akonadi::ItemFetchJob::EmitItemsInBatches);
+    connect(job, &Akonadi::ItemFetchJob::itemsReceived, this, [this](const Akonadi::Item::List &items) {
+        m_pendingItems += items;
+    });
+    connect(job, &KJob::result, this, [this](KJob *job) {
+        if (job->error()) {
+            qCWarning(KALENDAR_CALENDAR_LOG) << "Error listing the items to export:" << job->errorString();
+            finish(i18n("Unable to read the calendar: %1", job->errorString()));
+            return;
+        }
+        listItems();
+    });
+}
+
+void CalendarExporter::fetchNextBatch()
+{
+    const int count = std::min<int>(exportBatchSize, m_pendingItems.count());
+    const Akonadi::Item::List items = m_pendingItems.mid(0, count);
+    m_pendingItems.remove(0, count);
+    m_fetching = true;
+
+    auto job = new Akonadi::ItemFetchJob(items, this);
+    job->fetchScope().fetchFullPayload();
+    connect(job, &KJob::result, this, [this, job, count]() {
+        m_fetching = false;
+        if (job->error()) {
+            qCWarning(KALENDAR_CALENDAR_LOG) << "Error fetching the items to export:" << job->errorString();
+            finish(i18n("Unable to read the calendar: %1", job->errorString()));
+            return;
+        }
+
+        const auto items = job->items();
+        for (const auto &item : items) {
+            if (!item.hasPayload<KCalendarCore::Incidence::Ptr>()) {
+                continue;
+            }
+            const auto incidence = item.payload<KCalendarCore::Incidence::Ptr>();
+            if (m_rangeFilter) {
+                m_fetchedIncidences += m_rangeFilter->add(incidence);
+            } else {
+                m_fetchedIncidences.append(incidence);
+            }
+        }
+        m_processedCount += count;
+        m_batchFetched = true;
+        pump();
+    });
+}
+
+void CalendarExporter::pump()
+{
+    if (!m_running) {
+        return;
+    }
+    if (!m_deferredErrorMessage.isEmpty()) {
+        finish(std::exchange(m_deferredErrorMessage, {}));
+        return;
+    }
+    if (m_writeFailed) {
+        finish(i18n("Unable to write the calendar: %1", m_file->errorString()));
+        return;
+    }
+
+    if (m_batchFetched && !m_writing) {
+        // The incidences are only used by the writer thread from now on
+        const KCalendarCore::Incidence::List incidences = std::move(m_fetchedIncidences);
+        m_fetchedIncidences.clear();
+        m_batchFetched = false;
+        m_writing = true;
+
+        auto writer = m_writer.get();
+        QMetaObject::invokeMethod(m_writerContext.get(), [this, writer, incidences]() {
+            const bool success = writer->write(incidences);
+            QMetaObject::invokeMethod(
+                this,
+                [this, success, count = incidences.count()]() {
+                    m_writing = false;
+                    m_writeFailed = !success;
+                    m_exportedCount += count;
+                    Q_EMIT progressChanged();
+                    pump();
+                },
+                Qt::QueuedConnection);
+        });
+    }
+
+    // Fetching the next batch while the previous one is written, but no further ahead
+    if (!m_fetching && !m_batchFetched && !m_pendingItems.isEmpty()) {
+        fetchNextBatch();
+    }
+
+    if (!m_fetching && !m_batchFetched && !m_writing && m_pendingItems.isEmpty()) {
+        if (m_rangeFilter && m_rangeFilter->heldExceptionCount() > 0) {
+            qCDebug(KALENDAR_CALENDAR_LOG) << "Skipped" << m_rangeFilter->heldExceptionCount() << "exceptions whose recurring incidence isn't exported";
+        }
+        if (!m_writer->finish() || !m_file->commit()) {
+            finish(i18n("Unable to write the calendar: %1", m_file->errorString()));
+            return;
+        }
+        finish();
+    }
+}
+
+void CalendarExporter::finish(const QString &errorMessage)
+{
+    if (!m_running) {
+        return;
+    }
+
+    if (m_writing) {
+        // The file can't go away while the writer thread uses it, pump() finishes once it is done
+        if (m_deferredErrorMessage.isEmpty()) {
+            m_deferredErrorMessage = errorMessage;
+        }
+        return;
+    }
+
+    if (m_file && !errorMessage.isEmpty()) {
+        m_file->cancelWriting();
+    }
+    m_writer.reset();
+    m_file.reset();
+    m_rangeFilter.reset();
+    m_pendingItems.clear();
+    m_fetchedIncidences.clear();
+
+    qCDebug(KALENDAR_CALENDAR_LOG) << "Exported" << m_exportedCount << "incidences in" << m_timer.elapsed() << "ms";
+    m_running = false;
+    m_errorMessage = errorMessage;
+    Q_EMIT errorMessageChanged();
+    Q_EMIT progressChanged();
+    Q_EMIT runningChanged();
+    Q_EMIT finished(errorMessage.isEmpty());
+}
+
+bool CalendarExporter::occursWithin(const KCalendarCore::Incidence::Ptr &incidence, const QDateTime &from, const QDateTime &to)
+{
+    if (!from.isValid() && !to.isValid()) {
+        return true;
+    }
+    const auto start = incidence->dateTime(KCalendarCore::Incidence::RoleDisplayStart);
+    if (!start.isValid() || (to.isValid() && start >= to)) {
+        return false;
+    }
+    const auto end = incidence->dateTime(KCalendarCore::Incidence::RoleDisplayEnd);
+    const qint64 duration = end.isValid() ? std::max<qint64>(0, start.secsTo(end)) : 0;
+    if (!from.isValid()) {
+        return true;
+    }
+    if (!incidence->recurs()) {
+        return start.addSecs(duration) >= from;
+    }
+
+    const auto next = incidence->recurrence()->getNextDateTime(from.addSecs(-duration - 1));
+    return next.isValid() && (!to.isValid() || next < to);
+}
+
+bool CalendarExporter::running() const
+{
+    return m_running;
+}
+
+qreal CalendarExporter::progress() const
+{
+    if (!m_running) {
+        return m_errorMessage.isEmpty() && m_timer.isValid() ? 1 : 0;
+    }
+    return m_totalCount > 0 ? qreal(m_processedCount) / m_totalCount : -1;
+}
+
+int CalendarExporter::exportedCount() const
+{
+    return m_exportedCount;
+}
+
+qreal CalendarExporter::incidencesPerSecond() const
+{
+    const qint64 elapsed = m_timer.isValid() ? m_timer.elapsed() : 0;
+    return elapsed > 0 ? m_exportedCount * 1000.0 / elapsed : 0;
+}
+
+QString CalendarExporter::errorMessage() const
+{
+    return m_errorMessage;
+}
@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <Akonadi/Collection>
+#include <Akonadi/Item>
+#include <KCalendarCore/Incidence>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QThread>
+#include <QUrl>
+
+#include <memory>
+
+class ICalendarWriter;
+class QSaveFile;
+
+/**
+ * Chooses the incidences of a date range export, one at a time.
+ *
+ * A recurring incidence and its exceptions are written together if any of them occurs within the
+ * range, so no exception is written without its master, and no occurrence the master would
+ * generate in place of a moved one. They are held until the master is met, and exceptions whose
+ * master isn't exported are dropped.
+ */
+class IncidenceRangeFilter
+{
+public:
+    IncidenceRangeFilter(const QDateTime &from, const QDateTime &to);
+
+    /// Returns the incidences to write given @p incidence, none while its series is incomplete
+    KCalendarCore::Incidence::List add(const KCalendarCore::Incidence::Ptr &incidence);
+    /// The number of exceptions held so far whose master wasn't met or didn't occur within the range
+    int heldExceptionCount() const;
+
+private:
+    struct Series {
+        KCalendarCore::Incidence::Ptr master;
+        KCalendarCore::Incidence::List exceptions;
+        bool occurs = false;
+        bool exported = false;
+    };
+
+    const QDateTime m_from;
+    const QDateTime m_to;
+    // By UID
+    QHash<QString, Series> m_series;
+};
+
+/**
+ * Exports the incidences of calendars to an iCalendar file, optionally only those occurring
+ * within a date range.
+ *
+ * Items are fetched from Akonadi in batches and serialized on a worker thread. The next batch is
+ * only fetched while the previous one is written, so no more than two batches are ever in memory.
+ * Works without any user interface, so it can be scripted and benchmarked from the command line.
+ */
+class CalendarExporter : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    /// Between 0 and 1, or -1 while unknown
+    Q_PROPERTY(qreal progress READ progress NOTIFY progressChanged)
+    Q_PROPERTY(int exportedCount READ exportedCount NOTIFY progressChanged)
+    Q_PROPERTY(qreal incidencesPerSecond READ incidencesPerSecond NOTIFY progressChanged)
+    Q_PROPERTY(QString errorMessage READ errorMessage NOTIFY errorMessageChanged)
+
+public:
+    explicit CalendarExporter(QObject *parent = nullptr);
+    ~CalendarExporter() override;
+
+    /**
+     * Exports the collections with @p collectionIds to @p url, or all the calendars if it is empty.
+     *
+     * If @p from or @p to are valid, only the incidences with an occurrence in between are exported.
+     * Recurring incidences are exported whole, with all their exceptions. Only local files are supported.
+     */
+    Q_INVOKABLE void exportToUrl(const QUrl &url, const QVariantList &collectionIds, const QDateTime &from = {}, const QDateTime &to = {});
+    void exportToFile(const QString &fileName, const Akonadi::Collection::List &collections, const QDateTime &from = {}, const QDateTime &to = {});
+
+    bool running() const;
+    qreal progress() const;
+    int exportedCount() const;
+    qreal incidencesPerSecond() const;
+    QString errorMessage() const;
+
+    /// Whether @p incidence occurs between @p from and @p to, each of which can be invalid
+    static bool occursWithin(const KCalendarCore::Incidence::Ptr &incidence, const QDateTime &from, const QDateTime &to);
+
+Q_SIGNALS:
+    void runningChanged();
+    void progressChanged();
+    void errorMessageChanged();
+    void finished(bool success);
+
+private:
+    void fetchCollections();
+    void listItems();
+    void fetchNextBatch();
+    /// Starts what can be started, and finishes once everything is written
+    void pump();
+    void finish(const QString &errorMessage = {});
+
+    Akonadi::Collection::List m_collections;
+    std::unique_ptr<IncidenceRangeFilter> m_rangeFilter;
+
+    QThread m_writerThread;
+    // Lives in the writer thread, to run the serialization there. Deleted once the thread
+    // is stopped, or was never started.
+    std::unique_ptr<QObject> m_writerContext;
+    std::unique_ptr<QSaveFile> m_file;
+    std::unique_ptr<ICalendarWriter> m_writer;
+
+    // Only the identifiers of the items left, without their payload
+    Akonadi::Item::List m_pendingItems;
+    KCalendarCore::Incidence::List m_fetchedIncidences;
+    bool m_fetching = false;
+    bool m_batchFetched = false;
+    bool m_writing = false;
+    bool m_writeFailed = false;
+    // An error met while a batch was being written
+    QString m_deferredErrorMessage;
+
+    QElapsedTimer m_timer;
+    bool m_running = false;
+    int m_totalCount = -1;
+    int m_processedCount = 0;
+    int m_exportedCount = 0;
+    QString m_errorMessage;
+};
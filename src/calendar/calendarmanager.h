@@ -13,6 +13,8 @@
 #include <Akonadi/CollectionFilterProxyModel>
 #include <Akonadi/SearchCollectionHelper>
 #include <KConfigWatcher>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QObject>
 #include <akonadi-calendar_version.h>
 
@@ -34,6 +36,7 @@ class CalendarManager : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(bool loading READ loading NOTIFY loadingChanged)
+    Q_PROPERTY(QVariantList collectionLoadStates READ collectionLoadStates NOTIFY collectionLoadStatesChanged)
     Q_PROPERTY(QAbstractProxyModel *collections READ collections CONSTANT)
     Q_PROPERTY(QAbstractItemModel *todoCollections READ todoCollections CONSTANT)
     Q_PROPERTY(QAbstractItemModel *viewCollections READ viewCollections CONSTANT)
@@ -51,6 +54,8 @@ public:
     void setCollectionSelectionProxyModel(KCheckableProxyModel *);
 
     bool loading() const;
+    /// For diagnostics, the id, name, whether it is populated and the load time in ms of each collection
+    QVariantList collectionLoadStates() const;
     QAbstractProxyModel *collections();
     QAbstractItemModel *todoCollections();
     QAbstractItemModel *viewCollections();
@@ -99,6 +104,7 @@ private Q_SLOTS:
 
 Q_SIGNALS:
     void loadingChanged();
+    void collectionLoadStatesChanged();
     void calendarChanged();
     void undoRedoDataChanged();
     void enabledTodoCollectionsChanged();
@@ -125,6 +131,8 @@ private:
     KConfigWatcher::Ptr m_colorWatcher;
     Akonadi::SearchCollectionHelper mSearchCollectionHelper;
     CalendarConfig *m_config = nullptr;
+    QElapsedTimer m_loadTimer;
+    QHash<Akonadi::Collection::Id, qint64> m_collectionLoadTimes;
 };
 
 Q_DECLARE_METATYPE(Akonadi::ETMCalendar::Ptr)
@@ -3,17 +3,22 @@
 
 #include "calendarplugin.h"
 #include "calendarapplication.h"
+#include "calendarexporter.h"
 #include "calendarconfig.h"
 #include "calendarmanager.h"
+#include "conflictdetector.h"
 #include "datetimestate.h"
 #include "filter.h"
+#include "freebusyengine.h"
 #include "incidencewrapper.h"
 #include "models/hourlyincidencemodel.h"
 #include "models/incidenceoccurrencemodel.h"
+#include "models/incidencesearchmodel.h"
 #include "models/infinitecalendarviewmodel.h"
 #include "models/itemtagsmodel.h"
 #include "models/monthmodel.h"
 #include "models/multidayincidencemodel.h"
+#include "models/occurrencerecord.h"
 #include "models/timezonelistmodel.h"
 #include "models/todosortfilterproxymodel.h"
 #include "remindersmodel.h"
@@ -80,8 +85,12 @@ void CalendarPlugin::registerTypes(const char *uri)
 
     qmlRegisterUncreatableType<IncidenceWrapper>(uri, 1, 0, "IncidenceWrapper", QStringLiteral("Only returned from apis"));
     qmlRegisterType<AttendeesModel>(uri, 1, 0, "AttendeesModel");
+    qmlRegisterType<FreeBusyEngine>(uri, 1, 0, "FreeBusyEngine");
+    qmlRegisterType<CalendarExporter>(uri, 1, 0, "CalendarExporter");
+    qmlRegisterType<ConflictDetector>(uri, 1, 0, "ConflictDetector");
     qmlRegisterType<MultiDayIncidenceModel>(uri, 1, 0, "MultiDayIncidenceModel");
     qmlRegisterType<IncidenceOccurrenceModel>(uri, 1, 0, "IncidenceOccurrenceModel");
+    qmlRegisterType<IncidenceSearchModel>(uri, 1, 0, "IncidenceSearchModel");
     qmlRegisterType<TodoSortFilterProxyModel>(uri, 1, 0, "TodoSortFilterProxyModel");
     qmlRegisterType<ItemTagsModel>(uri, 1, 0, "ItemTagsModel");
     qmlRegisterType<HourlyIncidenceModel>(uri, 1, 0, "HourlyIncidenceModel");
@@ -96,4 +105,5 @@ void CalendarPlugin::registerTypes(const char *uri)
     qRegisterMetaType<Akonadi::AgentFilterProxyModel *>();
     qRegisterMetaType<Akonadi::CollectionFilterProxyModel *>();
     qRegisterMetaType<QAction *>();
+    qRegisterMetaType<OccurrenceRecord>();
 }
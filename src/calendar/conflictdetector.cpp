@@ -0,0 +1,198 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "conflictdetector.h"
+#include "incidencewrapper.h"
+#include "occurrenceexpander.h"
+
+#include <KCalendarCore/Event>
+
+namespace
+{
+// Dragging usually stays within a few weeks, which are indexed around the first query
+constexpr int windowDays = 8 * 7;
+}
+
+ConflictDetector::ConflictDetector(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ConflictDetector::~ConflictDetector()
+{
+    if (m_sourceCalendar) {
+        m_sourceCalendar->unregisterObserver(this);
+    }
+}
+
+Akonadi::ETMCalendar::Ptr ConflictDetector::calendar() const
+{
+    return m_calendar;
+}
+
+void ConflictDetector::setCalendar(Akonadi::ETMCalendar::Ptr calendar)
+{
+    if (m_calendar == calendar) {
+        return;
+    }
+    m_calendar = calendar;
+    setSourceCalendar(m_calendar);
+    Q_EMIT calendarChanged();
+}
+
+void ConflictDetector::setSourceCalendar(const KCalendarCore::Calendar::Ptr &calendar)
+{
+    if (m_sourceCalendar == calendar) {
+        return;
+    }
+    if (m_sourceCalendar) {
+        m_sourceCalendar->unregisterObserver(this);
+    }
+    m_sourceCalendar = calendar;
+    if (m_sourceCalendar) {
+        m_sourceCalendar->registerObserver(this);
+    }
+    invalidate();
+}
+
+void ConflictDetector::calendarIncidenceAdded(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    Q_UNUSED(incidence)
+    invalidate();
+}
+
+void ConflictDetector::calendarIncidenceChanged(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    Q_UNUSED(incidence)
+    invalidate();
+}
+
+void ConflictDetector::calendarIncidenceDeleted(const KCalendarCore::Incidence::Ptr &incidence, const KCalendarCore::Calendar *calendar)
+{
+    Q_UNUSED(incidence)
+    Q_UNUSED(calendar)
+    invalidate();
+}
+
+void ConflictDetector::invalidate()
+{
+    // Reindexed on the next query, so loading a calendar doesn't reindex for every incidence
+    m_dirty = true;
+    Q_EMIT conflictsChanged();
+}
+
+void ConflictDetector::ensureIndexed(const QDateTime &start, const QDateTime &end)
+{
+    if (!m_dirty && start >= m_windowStart && end <= m_windowEnd) {
+        return;
+    }
+
+    m_windowStart = start.addDays(-windowDays);
+    m_windowEnd = end.addDays(windowDays);
+    m_index.clear();
+    m_occurrences.clear();
+    m_dirty = false;
+    if (!m_sourceCalendar) {
+        return;
+    }
+
+    QHash<const KCalendarCore::Incidence *, qint64> collectionIds;
+    OccurrenceExpander occurrenceIterator(*m_sourceCalendar, m_windowStart, m_windowEnd);
+    while (occurrenceIterator.hasNext()) {
+        occurrenceIterator.next();
+        const auto incidence = occurrenceIterator.incidence();
+        if (incidence->type() != KCalendarCore::IncidenceBase::TypeEvent) {
+            continue;
+        }
+        const auto event = incidence.staticCast<KCalendarCore::Event>();
+        if (event->transparency() == KCalendarCore::Event::Transparent) {
+            continue;
+        }
+
+        auto collectionId = collectionIds.constFind(incidence.data());
+        if (collectionId == collectionIds.constEnd()) {
+            collectionId = collectionIds.insert(incidence.data(), m_calendar ? m_calendar->item(incidence).parentCollection().id() : -1);
+        }
+
+        // The end date of all day events is included
+        const qint64 duration = event->dtStart().secsTo(event->dtEnd()) + (event->allDay() ? 24 * 60 * 60 : 0);
+        const auto occurrenceStart = occurrenceIterator.occurrenceStartDate();
+        const auto occurrenceEnd = occurrenceStart.addSecs(duration);
+
+        m_index.add(occurrenceStart.toSecsSinceEpoch(), occurrenceEnd.toSecsSinceEpoch(), m_occurrences.size());
+        m_occurrences.append({incidence, occurrenceStart, occurrenceEnd, collectionId.value()});
+    }
+    m_index.build();
+}
+
+template<typename Function>
+bool ConflictDetector::forEachConflict(const QDateTime &start,
+                                       const QDateTime &end,
+                                       const QList<qint64> &collectionIds,
+                                       const QString &ignoredUid,
+                                       Function function)
+{
+    if (!start.isValid() || !end.isValid()) {
+        return true;
+    }
+
+    ensureIndexed(start, end);
+    return m_index.forEachOverlap(start.toSecsSinceEpoch(), end.toSecsSinceEpoch(), [&](int value) {
+        const auto &occurrence = m_occurrences.at(value);
+        if ((!ignoredUid.isEmpty() && occurrence.incidence->uid() == ignoredUid)
+            || (!collectionIds.isEmpty() && !collectionIds.contains(occurrence.collectionId))) {
+            return true;
+        }
+        return function(occurrence);
+    });
+}
+
+QVector<ConflictDetector::Conflict>
+ConflictDetector::conflicts(const QDateTime &start, const QDateTime &end, const QList<qint64> &collectionIds, const QString &ignoredUid)
+{
+    QVector<Conflict> conflicts;
+    forEachConflict(start, end, collectionIds, ignoredUid, [&conflicts](const Conflict &conflict) {
+        conflicts.append(conflict);
+        return true;
+    });
+    return conflicts;
+}
+
+bool ConflictDetector::hasConflicts(const QDateTime &start, const QDateTime &end, const QList<qint64> &collectionIds, const QString &ignoredUid)
+{
+    return !forEachConflict(start, end, collectionIds, ignoredUid, [](const Conflict &) {
+        return false;
+    });
+}
+
+QVariantList ConflictDetector::conflictList(const QDateTime &start, const QDateTime &end, const QList<qint64> &collectionIds, const QString &ignoredUid)
+{
+    QVariantList list;
+    const auto conflicts = this->conflicts(start, end, collectionIds, ignoredUid);
+    for (const auto &conflict : conflicts) {
+        list.append(QVariantMap{
+            {QStringLiteral("summary"), conflict.incidence->summary()},
+            {QStringLiteral("start"), conflict.start},
+            {QStringLiteral("end"), conflict.end},
+            {QStringLiteral("collectionId"), conflict.collectionId},
+            {QStringLiteral("incidencePtr"), QVariant::fromValue(conflict.incidence)},
+        });
+    }
+    return list;
+}
+
+QVariantList ConflictDetector::conflictsForIncidence(IncidenceWrapper *wrapper)
+{
+    if (!wrapper) {
+        return {};
+    }
+
+    auto start = wrapper->incidenceStart();
+    auto end = wrapper->incidenceEnd();
+    if (wrapper->allDay()) {
+        // Both dates are included
+        start = QDateTime(start.date(), QTime(0, 0));
+        end = QDateTime(end.date().addDays(1), QTime(0, 0));
+    }
+    return conflictList(start, end, {}, wrapper->uid());
+}
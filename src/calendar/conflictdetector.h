@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "intervalindex.h"
+#include <Akonadi/ETMCalendar>
+#include <QDateTime>
+#include <QObject>
+#include <QVariantList>
+
+class IncidenceWrapper;
+
+/**
+ * Answers which events overlap a time span, fast enough to be asked on every frame while
+ * dragging an incidence.
+ *
+ * The occurrences of the opaque events within weeks around the queried times are expanded
+ * once into an IntervalIndex, which is rebuilt when the calendar changes or a query falls
+ * outside of it.
+ */
+class ConflictDetector : public QObject, public KCalendarCore::Calendar::CalendarObserver
+{
+    Q_OBJECT
+    Q_PROPERTY(Akonadi::ETMCalendar::Ptr calendar READ calendar WRITE setCalendar NOTIFY calendarChanged)
+
+public:
+    struct Conflict {
+        KCalendarCore::Incidence::Ptr incidence;
+        QDateTime start;
+        QDateTime end;
+        qint64 collectionId;
+    };
+
+    explicit ConflictDetector(QObject *parent = nullptr);
+    ~ConflictDetector() override;
+
+    Akonadi::ETMCalendar::Ptr calendar() const;
+    void setCalendar(Akonadi::ETMCalendar::Ptr calendar);
+    /// Uses the events of @p calendar, which doesn't have to be an Akonadi calendar
+    void setSourceCalendar(const KCalendarCore::Calendar::Ptr &calendar);
+
+    /**
+     * The occurrences overlapping @p start to @p end in @p collectionIds, or in all collections
+     * if empty, except those of the incidence with @p ignoredUid, in order of start.
+     */
+    QVector<Conflict> conflicts(const QDateTime &start,
+                                const QDateTime &end,
+                                const QList<qint64> &collectionIds = {},
+                                const QString &ignoredUid = {});
+    /// Whether conflicts() isn't empty, stopping at the first conflict
+    Q_INVOKABLE bool hasConflicts(const QDateTime &start, const QDateTime &end, const QList<qint64> &collectionIds = {}, const QString &ignoredUid = {});
+
+    /// The conflicts as maps with the summary, start, end, collectionId and incidencePtr
+    Q_INVOKABLE QVariantList conflictList(const QDateTime &start,
+                                          const QDateTime &end,
+                                          const QList<qint64> &collectionIds = {},
+                                          const QString &ignoredUid = {});
+    /// conflictList() for the times of the incidence edited with @p wrapper
+    Q_INVOKABLE QVariantList conflictsForIncidence(IncidenceWrapper *wrapper);
+
+    void calendarIncidenceAdded(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void calendarIncidenceChanged(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void calendarIncidenceDeleted(const KCalendarCore::Incidence::Ptr &incidence, const KCalendarCore::Calendar *calendar) override;
+
+Q_SIGNALS:
+    void calendarChanged();
+    /// Emitted when the events changed, so that conflicts should be asked again
+    void conflictsChanged();
+
+private:
+    void invalidate();
+    void ensureIndexed(const QDateTime &start, const QDateTime &end);
+    template<typename Function>
+    bool forEachConflict(const QDateTime &start, const QDateTime &end, const QList<qint64> &collectionIds, const QString &ignoredUid, Function function);
+
+    Akonadi::ETMCalendar::Ptr m_calendar;
+    KCalendarCore::Calendar::Ptr m_sourceCalendar;
+
+    bool m_dirty = true;
+    QDateTime m_windowStart;
+    QDateTime m_windowEnd;
+    IntervalIndex m_index;
+    QVector<Conflict> m_occurrences;
+};
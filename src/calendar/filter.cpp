@@ -3,6 +3,19 @@
 
 #include "filter.h"
 
+Filter::Filter(QObject *parent)
+    : QObject(parent)
+{
+    // Filtering on a tag keeps filtering on it when it's renamed. Renaming the tag doesn't change
+    // the categories of the incidences, so the old name has to keep matching too.
+    connect(TagRegistry::instance(), &TagRegistry::tagRenamed, this, [this](const QString &oldName, const QString &newName) {
+        if (!m_tags.contains(oldName) || m_tags.contains(newName)) {
+            return;
+        }
+        setTags(m_tags + QStringList{newName});
+    });
+}
+
 qint64 Filter::collectionId() const
 {
     return m_collectionId;
@@ -13,6 +26,11 @@ QStringList Filter::tags() const
     return m_tags;
 }
 
+const TagRegistry::TagSet &Filter::tagIds() const
+{
+    return m_tagIds;
+}
+
 QString Filter::name() const
 {
     return m_name;
@@ -33,6 +51,7 @@ void Filter::setTags(QStringList tags)
         return;
     }
     m_tags = tags;
+    m_tagIds = TagRegistry::instance()->intern(m_tags);
     Q_EMIT tagsChanged();
 }
 
@@ -49,16 +68,17 @@ void Filter::toggleFilterTag(const QString tagName)
 {
     if (!m_tags.contains(tagName)) {
         m_tags.append(tagName);
-        Q_EMIT tagsChanged();
     } else {
         m_tags.removeAll(tagName);
-        Q_EMIT tagsChanged();
     }
+    m_tagIds = TagRegistry::instance()->intern(m_tags);
+    Q_EMIT tagsChanged();
 }
 
 void Filter::removeTag(const QString &tagName)
 {
     m_tags.removeAll(tagName);
+    m_tagIds = TagRegistry::instance()->intern(m_tags);
     Q_EMIT tagsChanged();
 }
 
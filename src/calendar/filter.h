@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LGPL-2.0-or-later
 #pragma once
 #include <QObject>
+#include <tagregistry.h>
 
 /**
  * This class is used to enable cross-compatible filtering of data in models.
@@ -14,8 +15,12 @@ class Filter : public QObject
     Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
 
 public:
+    explicit Filter(QObject *parent = nullptr);
+
     qint64 collectionId() const;
     QStringList tags() const;
+    /// The tags as registered in TagRegistry
+    const TagRegistry::TagSet &tagIds() const;
     QString name() const;
 
 public Q_SLOTS:
@@ -35,5 +40,6 @@ Q_SIGNALS:
 private:
     qint64 m_collectionId = -1;
     QStringList m_tags;
+    TagRegistry::TagSet m_tagIds;
     QString m_name;
 };
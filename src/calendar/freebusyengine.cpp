@@ -0,0 +1,335 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "freebusyengine.h"
+#include "attendeecontactresolver.h"
+#include "kalendar_calendar_debug.h"
+#include "occurrenceexpander.h"
+
+#include <KCalendarCore/Event>
+#include <KCalendarCore/ICalFormat>
+#include <QFile>
+#include <QRegularExpression>
+#include <QUrl>
+
+namespace
+{
+constexpr int defaultDuration = 60;
+}
+
+FreeBusyEngine::FreeBusyEngine(QObject *parent)
+    : QObject(parent)
+    , m_start(QDate::currentDate(), QTime(0, 0))
+{
+}
+
+FreeBusyEngine::~FreeBusyEngine()
+{
+    if (m_sourceCalendar) {
+        m_sourceCalendar->unregisterObserver(this);
+    }
+}
+
+Akonadi::ETMCalendar::Ptr FreeBusyEngine::calendar() const
+{
+    return m_calendar;
+}
+
+void FreeBusyEngine::setCalendar(Akonadi::ETMCalendar::Ptr calendar)
+{
+    if (m_calendar == calendar) {
+        return;
+    }
+    m_calendar = calendar;
+    setSourceCalendar(m_calendar);
+    Q_EMIT calendarChanged();
+}
+
+void FreeBusyEngine::setSourceCalendar(const KCalendarCore::Calendar::Ptr &calendar)
+{
+    if (m_sourceCalendar == calendar) {
+        return;
+    }
+    if (m_sourceCalendar) {
+        m_sourceCalendar->unregisterObserver(this);
+    }
+    m_sourceCalendar = calendar;
+    if (m_sourceCalendar) {
+        m_sourceCalendar->registerObserver(this);
+    }
+    invalidate();
+}
+
+QDateTime FreeBusyEngine::start() const
+{
+    return m_start;
+}
+
+void FreeBusyEngine::setStart(const QDateTime &start)
+{
+    if (m_start == start) {
+        return;
+    }
+    m_start = start;
+    Q_EMIT startChanged();
+    invalidate();
+}
+
+int FreeBusyEngine::days() const
+{
+    return m_days;
+}
+
+void FreeBusyEngine::setDays(int days)
+{
+    if (m_days == days) {
+        return;
+    }
+    m_days = days;
+    Q_EMIT daysChanged();
+    invalidate();
+}
+
+int FreeBusyEngine::resolution() const
+{
+    return m_resolution;
+}
+
+void FreeBusyEngine::setResolution(int resolution)
+{
+    if (m_resolution == resolution) {
+        return;
+    }
+    m_resolution = resolution;
+    Q_EMIT resolutionChanged();
+    invalidate();
+}
+
+void FreeBusyEngine::calendarIncidenceAdded(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    Q_UNUSED(incidence)
+    invalidate();
+}
+
+void FreeBusyEngine::calendarIncidenceChanged(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    Q_UNUSED(incidence)
+    invalidate();
+}
+
+void FreeBusyEngine::calendarIncidenceDeleted(const KCalendarCore::Incidence::Ptr &incidence, const KCalendarCore::Calendar *calendar)
+{
+    Q_UNUSED(incidence)
+    Q_UNUSED(calendar)
+    invalidate();
+}
+
+void FreeBusyEngine::invalidate()
+{
+    // Rebuilt on the next query, so loading a calendar doesn't rebuild for every incidence
+    m_dirty = true;
+    Q_EMIT busyTimesChanged();
+}
+
+BusyBitmap FreeBusyEngine::emptyBitmap() const
+{
+    return BusyBitmap(m_start, m_start.addDays(m_days), m_resolution);
+}
+
+FreeBusyEngine::BusyTimes FreeBusyEngine::computeBusyTimes(const QString &ignoredUid) const
+{
+    BusyTimes busyTimes{emptyBitmap(), {}};
+    const auto personBitmap = [this, &busyTimes](const QString &email) -> BusyBitmap & {
+        const auto normalized = AttendeeContactResolver::normalizedEmail(email);
+        auto it = busyTimes.people.find(normalized);
+        if (it == busyTimes.people.end()) {
+            it = busyTimes.people.insert(normalized, emptyBitmap());
+        }
+        return it.value();
+    };
+
+    if (m_sourceCalendar) {
+        const auto end = m_start.addDays(m_days);
+        OccurrenceExpander occurrenceIterator(*m_sourceCalendar, m_start, end);
+        while (occurrenceIterator.hasNext()) {
+            occurrenceIterator.next();
+            const auto incidence = occurrenceIterator.incidence();
+            if (incidence->type() != KCalendarCore::IncidenceBase::TypeEvent || (!ignoredUid.isEmpty() && incidence->uid() == ignoredUid)) {
+                continue;
+            }
+            const auto event = incidence.staticCast<KCalendarCore::Event>();
+            if (event->transparency() == KCalendarCore::Event::Transparent) {
+                continue;
+            }
+
+            // The end date of all day events is included
+            const qint64 duration = event->dtStart().secsTo(event->dtEnd()) + (event->allDay() ? 24 * 60 * 60 : 0);
+            const auto occurrenceStart = occurrenceIterator.occurrenceStartDate();
+            const auto occurrenceEnd = occurrenceStart.addSecs(duration);
+
+            busyTimes.own.markBusy(occurrenceStart, occurrenceEnd);
+            const auto attendees = event->attendees();
+            for (const auto &attendee : attendees) {
+                // Without an address there is no one to look the busy times up for
+                if (attendee.email().isEmpty() || attendee.status() == KCalendarCore::Attendee::Declined
+                    || attendee.status() == KCalendarCore::Attendee::Delegated) {
+                    continue;
+                }
+                personBitmap(attendee.email()).markBusy(occurrenceStart, occurrenceEnd);
+            }
+            if (!event->organizer().email().isEmpty()) {
+                personBitmap(event->organizer().email()).markBusy(occurrenceStart, occurrenceEnd);
+            }
+        }
+    }
+
+    for (auto it = m_freeBusyPeriods.cbegin(); it != m_freeBusyPeriods.cend(); ++it) {
+        auto &bitmap = personBitmap(it.key());
+        for (const auto &period : it.value()) {
+            bitmap.markBusy(period.start(), period.end());
+        }
+    }
+
+    return busyTimes;
+}
+
+const FreeBusyEngine::BusyTimes &FreeBusyEngine::busyTimes()
+{
+    if (m_dirty) {
+        m_busyTimes = computeBusyTimes({});
+        m_dirty = false;
+    }
+    return m_busyTimes;
+}
+
+BusyBitmap FreeBusyEngine::busyBitmap(const QString &email)
+{
+    if (email.isEmpty()) {
+        return busyTimes().own;
+    }
+    return busyTimes().people.value(AttendeeContactResolver::normalizedEmail(email), emptyBitmap());
+}
+
+BusyBitmap FreeBusyEngine::combinedBusyBitmap(const QStringList &emails, bool includeOwnCalendars)
+{
+    return combinedBusyBitmap(busyTimes(), emails, includeOwnCalendars);
+}
+
+BusyBitmap FreeBusyEngine::combinedBusyBitmap(const BusyTimes &busyTimes, const QStringList &emails, bool includeOwnCalendars) const
+{
+    auto bitmap = includeOwnCalendars ? busyTimes.own : emptyBitmap();
+    for (const auto &email : emails) {
+        if (email.isEmpty()) {
+            continue;
+        }
+        const auto it = busyTimes.people.constFind(AttendeeContactResolver::normalizedEmail(email));
+        if (it != busyTimes.people.constEnd()) {
+            bitmap |= it.value();
+        }
+    }
+    return bitmap;
+}
+
+QVariantList FreeBusyEngine::freeSlots(const BusyBitmap &bitmap, int duration, int count) const
+{
+    QVariantList slots;
+    const auto freeSlots = bitmap.freeSlots(duration, count);
+    for (const auto &slot : freeSlots) {
+        slots.append(QVariantMap{
+            {QStringLiteral("start"), slot.start},
+            {QStringLiteral("end"), slot.end},
+        });
+    }
+    return slots;
+}
+
+QVariantList FreeBusyEngine::findFreeSlots(const QStringList &emails, int duration, int count, bool includeOwnCalendars)
+{
+    return freeSlots(combinedBusyBitmap(emails, includeOwnCalendars), duration, count);
+}
+
+QVariantList FreeBusyEngine::findFreeSlotsForIncidence(const KCalendarCore::Incidence::Ptr &incidence, int count)
+{
+    if (!incidence) {
+        return {};
+    }
+
+    QStringList emails;
+    const auto attendees = incidence->attendees();
+    for (const auto &attendee : attendees) {
+        emails << attendee.email();
+    }
+
+    int duration = defaultDuration;
+    if (incidence->type() == KCalendarCore::IncidenceBase::TypeEvent) {
+        const auto event = incidence.staticCast<KCalendarCore::Event>();
+        const qint64 seconds = event->dtStart().secsTo(event->dtEnd());
+        if (seconds > 0) {
+            duration = int(seconds / 60);
+        }
+    }
+
+    // The cached busy times include the incidence once it is stored, and other queries have to keep counting it
+    if (m_sourceCalendar && m_sourceCalendar->incidence(incidence->uid())) {
+        return freeSlots(combinedBusyBitmap(computeBusyTimes(incidence->uid()), emails, true), duration, count);
+    }
+    return findFreeSlots(emails, duration, count);
+}
+
+bool FreeBusyEngine::loadFreeBusyFile(const QUrl &url)
+{
+    QFile file(url.isLocalFile() ? url.toLocalFile() : url.toString());
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(KALENDAR_CALENDAR_LOG) << "Unable to read free/busy file" << url << file.errorString();
+        return false;
+    }
+    return loadFreeBusy(QString::fromUtf8(file.readAll())) > 0;
+}
+
+int FreeBusyEngine::loadFreeBusy(const QString &data)
+{
+    // The parser merges all blocks of a calendar into one, so they are parsed one by one
+    static const QRegularExpression blockExpression(QStringLiteral("^BEGIN:VFREEBUSY\\r?$.*?^END:VFREEBUSY\\r?$"),
+                                                    QRegularExpression::MultilineOption | QRegularExpression::DotMatchesEverythingOption);
+
+    KCalendarCore::ICalFormat format;
+    int count = 0;
+    auto blocks = blockExpression.globalMatch(data);
+    while (blocks.hasNext()) {
+        const auto block = blocks.next().captured();
+        const auto freeBusy = format.parseFreeBusy(QStringLiteral("BEGIN:VCALENDAR\r\nVERSION:2.0\r\nPRODID:-//KDE//Kalendar//EN\r\n") + block
+                                                   + QStringLiteral("\r\nEND:VCALENDAR\r\n"));
+        if (freeBusy) {
+            addFreeBusy(freeBusy);
+            ++count;
+        }
+    }
+    return count;
+}
+
+void FreeBusyEngine::addFreeBusy(const KCalendarCore::FreeBusy::Ptr &freeBusy)
+{
+    QString email = freeBusy->organizer().email();
+    if (email.isEmpty() && !freeBusy->attendees().isEmpty()) {
+        email = freeBusy->attendees().constFirst().email();
+    }
+    if (email.isEmpty()) {
+        qCDebug(KALENDAR_CALENDAR_LOG) << "Ignoring free/busy information without a person";
+        return;
+    }
+
+    auto &periods = m_freeBusyPeriods[AttendeeContactResolver::normalizedEmail(email)];
+    const auto busyPeriods = freeBusy->fullBusyPeriods();
+    for (const auto &period : busyPeriods) {
+        if (period.type() != KCalendarCore::FreeBusyPeriod::Free) {
+            periods.append(KCalendarCore::Period(period.start(), period.end()));
+        }
+    }
+    invalidate();
+}
+
+void FreeBusyEngine::clearFreeBusy()
+{
+    m_freeBusyPeriods.clear();
+    invalidate();
+}
@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "busybitmap.h"
+#include <Akonadi/ETMCalendar>
+#include <KCalendarCore/FreeBusy>
+#include <QHash>
+#include <QObject>
+#include <QVariantList>
+
+/**
+ * Finds the times when attendees and our own calendars are free.
+ *
+ * The busy times come from the opaque events of the enabled collections, which make us and
+ * their attendees who didn't decline busy, and from VFREEBUSY blocks loaded from ICS files, so
+ * this works offline. They are kept as one BusyBitmap per person over days from start, and
+ * rebuilt when needed after the calendar changed.
+ */
+class FreeBusyEngine : public QObject, public KCalendarCore::Calendar::CalendarObserver
+{
+    Q_OBJECT
+    Q_PROPERTY(Akonadi::ETMCalendar::Ptr calendar READ calendar WRITE setCalendar NOTIFY calendarChanged)
+    Q_PROPERTY(QDateTime start READ start WRITE setStart NOTIFY startChanged)
+    Q_PROPERTY(int days READ days WRITE setDays NOTIFY daysChanged)
+    /// The length of the slots in minutes, usually 5 or 15
+    Q_PROPERTY(int resolution READ resolution WRITE setResolution NOTIFY resolutionChanged)
+
+public:
+    explicit FreeBusyEngine(QObject *parent = nullptr);
+    ~FreeBusyEngine() override;
+
+    Akonadi::ETMCalendar::Ptr calendar() const;
+    void setCalendar(Akonadi::ETMCalendar::Ptr calendar);
+    /// Uses the events of @p calendar, which doesn't have to be an Akonadi calendar
+    void setSourceCalendar(const KCalendarCore::Calendar::Ptr &calendar);
+    QDateTime start() const;
+    void setStart(const QDateTime &start);
+    int days() const;
+    void setDays(int days);
+    int resolution() const;
+    void setResolution(int resolution);
+
+    /// The busy times of @p email, or of our own calendars if it is empty
+    BusyBitmap busyBitmap(const QString &email);
+    /// The times when any of @p emails, or our own calendars if @p includeOwnCalendars, are busy
+    BusyBitmap combinedBusyBitmap(const QStringList &emails, bool includeOwnCalendars);
+
+    /**
+     * Returns up to @p count slots of @p duration minutes when all of @p emails are free, as
+     * maps with a start and an end, in order and not overlapping each other.
+     */
+    Q_INVOKABLE QVariantList findFreeSlots(const QStringList &emails, int duration, int count, bool includeOwnCalendars = true);
+    /// Like findFreeSlots() for the attendees and duration of @p incidence, which doesn't count as busy time
+    Q_INVOKABLE QVariantList findFreeSlotsForIncidence(const KCalendarCore::Incidence::Ptr &incidence, int count);
+
+    /// Adds the busy periods of the VFREEBUSY blocks of the ICS file at @p url
+    Q_INVOKABLE bool loadFreeBusyFile(const QUrl &url);
+    /// Adds the busy periods of the VFREEBUSY blocks in @p data, returns the number of blocks
+    int loadFreeBusy(const QString &data);
+    void addFreeBusy(const KCalendarCore::FreeBusy::Ptr &freeBusy);
+    Q_INVOKABLE void clearFreeBusy();
+
+    void calendarIncidenceAdded(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void calendarIncidenceChanged(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void calendarIncidenceDeleted(const KCalendarCore::Incidence::Ptr &incidence, const KCalendarCore::Calendar *calendar) override;
+
+Q_SIGNALS:
+    void calendarChanged();
+    void startChanged();
+    void daysChanged();
+    void resolutionChanged();
+    /// Emitted when the busy times changed
+    void busyTimesChanged();
+
+private:
+    struct BusyTimes {
+        BusyBitmap own;
+        // By normalized email
+        QHash<QString, BusyBitmap> people;
+    };
+
+    void invalidate();
+    /// The busy times over the range, without the occurrences of the incidence @p ignoredUid
+    BusyTimes computeBusyTimes(const QString &ignoredUid) const;
+    /// The cached busy times of all incidences, computed again if the calendar changed
+    const BusyTimes &busyTimes();
+    BusyBitmap emptyBitmap() const;
+    BusyBitmap combinedBusyBitmap(const BusyTimes &busyTimes, const QStringList &emails, bool includeOwnCalendars) const;
+    QVariantList freeSlots(const BusyBitmap &bitmap, int duration, int count) const;
+
+    Akonadi::ETMCalendar::Ptr m_calendar;
+    KCalendarCore::Calendar::Ptr m_sourceCalendar;
+    QDateTime m_start;
+    int m_days = 28;
+    int m_resolution = 15;
+
+    // Busy periods of the VFREEBUSY blocks by email, kept to fill bitmaps of other ranges
+    QHash<QString, KCalendarCore::Period::List> m_freeBusyPeriods;
+
+    bool m_dirty = true;
+    BusyTimes m_busyTimes;
+};
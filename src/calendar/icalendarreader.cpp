@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "icalendarreader.h"
+#include "kalendar_calendar_debug.h"
+
+#include <KCalendarCore/ICalFormat>
+#include <KCalendarCore/MemoryCalendar>
+#include <QIODevice>
+#include <QTimeZone>
+
+#include <algorithm>
+
+namespace
+{
+bool isIncidence(const QByteArray &componentName)
+{
+    return componentName == "VEVENT" || componentName == "VTODO" || componentName == "VJOURNAL";
+}
+}
+
+ICalendarReader::ICalendarReader(QIODevice *device)
+    : m_device(device)
+{
+}
+
+KCalendarCore::Incidence::List ICalendarReader::read(int maxCount)
+{
+    // A batch of components which all fail to parse is not the end of the file
+    KCalendarCore::Incidence::List incidences;
+    while (incidences.isEmpty() && !m_device->atEnd()) {
+        incidences = readBatch(maxCount);
+    }
+    return incidences;
+}
+
+KCalendarCore::Incidence::List ICalendarReader::readBatch(int maxCount)
+{
+    QByteArrayList components;
+    while (components.count() < maxCount && !m_device->atEnd()) {
+        QByteArray line = m_device->readLine();
+        if (m_atStart) {
+            // Files written on Windows often start with a UTF-8 byte order mark
+            m_atStart = false;
+            if (line.startsWith("\xEF\xBB\xBF")) {
+                line.remove(0, 3);
+            }
+        }
+        const QByteArray trimmed = line.trimmed().toUpper();
+
+        if (m_componentName.isEmpty()) {
+            if (trimmed.startsWith("BEGIN:")) {
+                const QByteArray name = trimmed.mid(6);
+                if (name != "VCALENDAR") {
+                    m_componentName = name;
+                    m_component = line;
+                }
+            } else if (!trimmed.isEmpty() && !trimmed.startsWith("END:")) {
+                // Folded lines of the properties start with a space, so they are kept too
+                m_properties += line;
+            }
+            continue;
+        }
+
+        // Nested components, like alarms, end with their own name
+        m_component += line;
+        if (trimmed != "END:" + m_componentName) {
+            continue;
+        }
+        if (!m_component.endsWith('\n')) {
+            m_component += "\r\n";
+        }
+        if (m_componentName == "VTIMEZONE") {
+            m_timeZones += m_component;
+        } else if (isIncidence(m_componentName)) {
+            components.append(m_component);
+        }
+        m_component.clear();
+        m_componentName.clear();
+    }
+
+    if (components.isEmpty()) {
+        return {};
+    }
+
+    // Parsing many components at once is much cheaper than one by one, which is only done to skip broken ones
+    auto incidences = parse(components.join());
+    if (incidences.isEmpty() && components.count() > 1) {
+        for (const auto &component : std::as_const(components)) {
+            incidences += parse(component);
+        }
+    }
+    m_skippedCount += std::max(0, int(components.count() - incidences.count()));
+    return incidences;
+}
+
+KCalendarCore::Incidence::List ICalendarReader::parse(const QByteArray &components) const
+{
+    const QByteArray data = "BEGIN:VCALENDAR\r\n" + m_properties + m_timeZones + components + "END:VCALENDAR\r\n";
+
+    KCalendarCore::MemoryCalendar::Ptr calendar(new KCalendarCore::MemoryCalendar(QTimeZone::systemTimeZone()));
+    KCalendarCore::ICalFormat format;
+    if (!format.fromRawString(calendar, data)) {
+        qCDebug(KALENDAR_CALENDAR_LOG) << "Unable to parse iCalendar components";
+        return {};
+    }
+    return calendar->rawIncidences();
+}
+
+bool ICalendarReader::atEnd() const
+{
+    return m_device->atEnd();
+}
+
+qint64 ICalendarReader::position() const
+{
+    return m_device->pos();
+}
+
+int ICalendarReader::skippedCount() const
+{
+    return m_skippedCount;
+}
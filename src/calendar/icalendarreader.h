@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <KCalendarCore/Incidence>
+#include <QByteArray>
+#include <QByteArrayList>
+
+class QIODevice;
+
+/**
+ * Reads the events, tasks and journals of an iCalendar file in batches, so large files are
+ * never loaded into memory at once.
+ *
+ * The time zones and calendar properties met so far are given to every batch. Components
+ * which can't be parsed are skipped, and an incomplete one at the end of the file is ignored.
+ */
+class ICalendarReader
+{
+public:
+    explicit ICalendarReader(QIODevice *device);
+
+    /// Reads and parses up to @p maxCount incidences, empty only once the end is reached
+    KCalendarCore::Incidence::List read(int maxCount);
+
+    bool atEnd() const;
+    /// The number of bytes read so far
+    qint64 position() const;
+    /// The number of components which couldn't be parsed so far
+    int skippedCount() const;
+
+private:
+    KCalendarCore::Incidence::List readBatch(int maxCount);
+    KCalendarCore::Incidence::List parse(const QByteArray &components) const;
+
+    QIODevice *const m_device;
+    // The properties of the calendar itself, like its version and time zone
+    QByteArray m_properties;
+    QByteArray m_timeZones;
+    QByteArray m_component;
+    QByteArray m_componentName;
+    int m_skippedCount = 0;
+    bool m_atStart = true;
+};
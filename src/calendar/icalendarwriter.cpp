@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "icalendarwriter.h"
+
+#include <KCalendarCore/ICalFormat>
+#include <KCalendarCore/MemoryCalendar>
+#include <QBuffer>
+#include <QTimeZone>
+
+ICalendarWriter::ICalendarWriter(QIODevice *device)
+    : m_device(device)
+{
+}
+
+bool ICalendarWriter::writeHeader()
+{
+    m_headerWritten = true;
+    const QByteArray header = "BEGIN:VCALENDAR\r\nPRODID:" + KCalendarCore::CalFormat::productId().toUtf8() + "\r\nVERSION:2.0\r\n";
+    return m_device->write(header) == header.size();
+}
+
+bool ICalendarWriter::write(const KCalendarCore::Incidence::List &incidences)
+{
+    if (!m_headerWritten && !writeHeader()) {
+        return false;
+    }
+    if (incidences.isEmpty()) {
+        return true;
+    }
+
+    // The calendar takes ownership of what it is given, so it gets copies
+    KCalendarCore::MemoryCalendar::Ptr calendar(new KCalendarCore::MemoryCalendar(QTimeZone::utc()));
+    for (const auto &incidence : incidences) {
+        calendar->addIncidence(KCalendarCore::Incidence::Ptr(incidence->clone()));
+    }
+    QByteArray data = KCalendarCore::ICalFormat().toString(calendar).toUtf8();
+
+    // Only keep the components, without the calendar around them or the time zones already written
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    QByteArray output;
+    QByteArray component;
+    QByteArray componentName;
+    QByteArray timeZoneId;
+    while (!buffer.atEnd()) {
+        const QByteArray line = buffer.readLine();
+        const QByteArray trimmed = line.trimmed();
+
+        if (componentName.isEmpty()) {
+            if (trimmed.startsWith("BEGIN:") && trimmed != "BEGIN:VCALENDAR") {
+                componentName = trimmed.mid(6);
+                component = line;
+                timeZoneId.clear();
+            }
+            continue;
+        }
+
+        component += line;
+        if (componentName == "VTIMEZONE" && timeZoneId.isEmpty() && trimmed.startsWith("TZID:")) {
+            timeZoneId = trimmed.mid(5);
+        }
+        if (trimmed != "END:" + componentName) {
+            continue;
+        }
+        if (componentName != "VTIMEZONE") {
+            output += component;
+        } else if (!m_timeZoneIds.contains(timeZoneId)) {
+            m_timeZoneIds.insert(timeZoneId);
+            output += component;
+        }
+        component.clear();
+        componentName.clear();
+    }
+
+    m_count += incidences.count();
+    return m_device->write(output) == output.size();
+}
+
+bool ICalendarWriter::finish()
+{
+    if (!m_headerWritten && !writeHeader()) {
+        return false;
+    }
+    const QByteArray footer = "END:VCALENDAR\r\n";
+    return m_device->write(footer) == footer.size();
+}
+
+int ICalendarWriter::count() const
+{
+    return m_count;
+}
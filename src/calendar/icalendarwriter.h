@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <KCalendarCore/Incidence>
+#include <QSet>
+
+class QIODevice;
+
+/**
+ * Writes incidences to an iCalendar file in batches, so the whole calendar never has to be in
+ * memory at once.
+ *
+ * Each batch is serialized on its own, and the time zones it uses are only written the first
+ * time they are met. The counterpart of ICalendarReader.
+ */
+class ICalendarWriter
+{
+public:
+    explicit ICalendarWriter(QIODevice *device);
+
+    /// Appends @p incidences, returns false if the device can't be written
+    bool write(const KCalendarCore::Incidence::List &incidences);
+    /// Ends the calendar, nothing can be written afterwards
+    bool finish();
+
+    /// The number of incidences written so far
+    int count() const;
+
+private:
+    bool writeHeader();
+
+    QIODevice *const m_device;
+    QSet<QByteArray> m_timeZoneIds;
+    bool m_headerWritten = false;
+    int m_count = 0;
+};
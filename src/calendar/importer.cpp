@@ -1,55 +1,249 @@
 // SPDX-FileCopyrightText: 2021 Claudio Cambra <claudio.cambra@gmail.com>
 // SPDX-FileCopyrightText: 2023 Carl Schwan <carl@carlschwan.eu>
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include "importer.h"
+#include "icalendarreader.h"
 #include "kalendar_calendar_debug.h"
 #include <Akonadi/ICalImporter>
+#include <Akonadi/ItemCreateJob>
+#include <Akonadi/ItemFetchJob>
+#include <Akonadi/ItemFetchScope>
+#include <Akonadi/ItemModifyJob>
+#include <Akonadi/TransactionSequence>
 #include <KLocalizedString>
+#include <QFile>
 #include <QTimer>
 
 using namespace std::chrono_literals;
 
+// Incidences created per transaction
+static constexpr int importBatchSize = 200;
+
 Importer::Importer(QObject *parent)
     : QObject(parent)
 {
     connect(this, &Importer::calendarImportInProgressChanged, this, [this]() {
-        if (m_calendarImportInProgress && m_calendarFilesToImport.length() > 0) {
-            QTimer::singleShot(100ms, [this]() {
-                Q_EMIT importCalendarFromFile(m_calendarFilesToImport.takeFirst());
+        if (!m_calendarImportInProgress && m_calendarFilesToImport.length() > 0) {
+            QTimer::singleShot(100ms, this, [this]() {
+                if (!m_calendarImportInProgress && m_calendarFilesToImport.length() > 0) {
+                    Q_EMIT importCalendarFromFile(m_calendarFilesToImport.takeFirst());
+                }
             });
         }
     });
 }
 
+Importer::~Importer() = default;
+
 void Importer::importCalendarFromUrl(const QUrl &url, bool merge, qint64 collectionId)
 {
     if (!m_calendar) {
         return;
     }
 
+    // vCalendar files are left to the importer of Akonadi, which can convert them
+    if (merge && url.isLocalFile() && !url.path().endsWith(QLatin1String(".vcs"), Qt::CaseInsensitive)) {
+        importIntoExisting(url, m_calendar->collection(collectionId));
+        return;
+    }
+
     auto importer = new Akonadi::ICalImporter(m_calendar->incidenceChanger());
     bool jobStarted;
 
     if (merge) {
         connect(importer, &Akonadi::ICalImporter::importIntoExistingFinished, this, &Importer::importFinished);
         connect(importer, &Akonadi::ICalImporter::importIntoExistingFinished, this, &Importer::importIntoExistingFinished);
+        connect(importer, &Akonadi::ICalImporter::importIntoExistingFinished, this, [this]() {
+            setImportProgress(1, m_importedCount);
+            setCalendarImportInProgress(false);
+        });
         auto collection = m_calendar->collection(collectionId);
         jobStarted = importer->importIntoExistingResource(url, collection);
     } else {
         connect(importer, &Akonadi::ICalImporter::importIntoNewFinished, this, &Importer::importFinished);
         connect(importer, &Akonadi::ICalImporter::importIntoNewFinished, this, &Importer::importIntoNewFinished);
+        connect(importer, &Akonadi::ICalImporter::importIntoNewFinished, this, [this]() {
+            setImportProgress(1, m_importedCount);
+            setCalendarImportInProgress(false);
+        });
         jobStarted = importer->importIntoNewResource(url.path());
     }
 
     if (jobStarted) {
+        // The importer of Akonadi doesn't tell how far it is
+        m_importTimer.invalidate();
+        setImportProgress(-1, 0);
+        setCalendarImportInProgress(true);
         Q_EMIT importStarted();
-    } else if (!importer->errorMessage().isEmpty()) {
-        // empty error message means user canceled.
-        qCDebug(KALENDAR_CALENDAR_LOG) << i18n("An error occurred: %1", importer->errorMessage());
-        m_importErrorMessage = importer->errorMessage();
+    } else {
+        setCalendarImportInProgress(false);
+        if (!importer->errorMessage().isEmpty()) {
+            // empty error message means user canceled.
+            qCDebug(KALENDAR_CALENDAR_LOG) << i18n("An error occurred: %1", importer->errorMessage());
+            m_importErrorMessage = importer->errorMessage();
+            Q_EMIT importErrorMessageChanged();
+        }
+    }
+}
+
+bool Importer::importIntoExisting(const QUrl &url, const Akonadi::Collection &collection)
+{
+    if (m_reader) {
+        return false;
+    }
+
+    m_importFile = std::make_unique<QFile>(url.toLocalFile());
+    if (!m_importFile->open(QIODevice::ReadOnly)) {
+        m_importErrorMessage = i18n("Unable to open %1: %2", url.toDisplayString(QUrl::PreferLocalFile), m_importFile->errorString());
+        Q_EMIT importErrorMessageChanged();
+        m_importFile.reset();
+        setCalendarImportInProgress(false);
+        return false;
+    }
+    m_reader = std::make_unique<ICalendarReader>(m_importFile.get());
+    m_importCollection = collection;
+    m_existingItems.clear();
+    m_importTimer.start();
+    setCalendarImportInProgress(true);
+    setImportProgress(0, 0);
+    // Before the first batch, which finishes the import right away for files without incidences
+    Q_EMIT importStarted();
+
+    if (m_dedupeByUid) {
+        fetchExistingItems();
+    } else {
+        importBatch(m_reader->read(importBatchSize));
+    }
+    return true;
+}
+
+void Importer::fetchExistingItems()
+{
+    // Only the identifiers are needed to find the incidences to update, not their payload
+    auto job = new Akonadi::ItemFetchJob(m_importCollection, this);
+    job->fetchScope().setFetchGid(true);
+    job->fetchScope().setFetchModificationTime(false);
+    job->setDeliveryOption(Akonadi::ItemFetchJob::EmitItemsInBatches);
+    connect(job, &Akonadi::ItemFetchJob::itemsReceived, this, [this](const Akonadi::Item::List &items) {
+        for (const auto &item : items) {
+            if (!item.gid().isEmpty()) {
+                m_existingItems.insert(item.gid(), item);
+            }
+        }
+    });
+    connect(job, &KJob::result, this, [this](KJob *job) {
+        if (job->error()) {
+            qCWarning(KALENDAR_CALENDAR_LOG) << "Error fetching the items to deduplicate:" << job->errorString();
+            finishImport(i18n("Unable to read the calendar: %1", job->errorString()));
+            return;
+        }
+        importBatch(m_reader->read(importBatchSize));
+    });
+}
+
+void Importer::importBatch(const KCalendarCore::Incidence::List &incidences)
+{
+    if (incidences.isEmpty()) {
+        finishImport();
+        return;
+    }
+
+    auto transaction = new Akonadi::TransactionSequence(this);
+    for (const auto &incidence : incidences) {
+        // The serializer uses the instance identifier as the item's GID
+        const auto existingItem = m_existingItems.value(incidence->instanceIdentifier());
+        if (existingItem.isValid()) {
+            Akonadi::Item item = existingItem;
+            item.setPayload<KCalendarCore::Incidence::Ptr>(incidence);
+            auto job = new Akonadi::ItemModifyJob(item, transaction);
+            job->disableRevisionCheck();
+        } else {
+            Akonadi::Item item;
+            item.setMimeType(incidence->mimeType());
+            item.setPayload<KCalendarCore::Incidence::Ptr>(incidence);
+            new Akonadi::ItemCreateJob(item, m_importCollection, transaction);
+        }
+    }
+
+    // The next batch is only read once Akonadi stored this one, so a single batch is in memory
+    // however fast the file is read
+    const qint64 position = m_reader->position();
+    const int count = incidences.count();
+    connect(transaction, &KJob::result, this, [this, position, count](KJob *job) {
+        if (job->error()) {
+            qCWarning(KALENDAR_CALENDAR_LOG) << "Error importing incidences:" << job->errorString();
+            finishImport(i18n("Unable to import the incidences: %1", job->errorString()));
+            return;
+        }
+        setImportProgress(m_importFile->size() > 0 ? qreal(position) / m_importFile->size() : 1, m_importedCount + count);
+        importBatch(m_reader->read(importBatchSize));
+    });
+}
+
+void Importer::finishImport(const QString &errorMessage)
+{
+    if (m_reader && m_reader->skippedCount() > 0) {
+        qCWarning(KALENDAR_CALENDAR_LOG) << "Skipped" << m_reader->skippedCount() << "components which couldn't be parsed";
+    }
+    m_reader.reset();
+    m_importFile.reset();
+    m_existingItems.clear();
+
+    if (errorMessage.isEmpty()) {
+        setImportProgress(1, m_importedCount);
+    } else {
+        m_importErrorMessage = errorMessage;
         Q_EMIT importErrorMessageChanged();
     }
+
+    qCDebug(KALENDAR_CALENDAR_LOG) << "Imported" << m_importedCount << "incidences in" << m_importTimer.elapsed() << "ms";
+    Q_EMIT importIntoExistingFinished(errorMessage.isEmpty(), m_importedCount);
+    Q_EMIT importFinished();
+    setCalendarImportInProgress(false);
+}
+
+void Importer::setCalendarImportInProgress(bool calendarImportInProgress)
+{
+    if (m_calendarImportInProgress == calendarImportInProgress) {
+        return;
+    }
+    m_calendarImportInProgress = calendarImportInProgress;
+    Q_EMIT calendarImportInProgressChanged();
+}
+
+void Importer::setImportProgress(qreal progress, int importedCount)
+{
+    m_importProgress = progress;
+    m_importedCount = importedCount;
+    Q_EMIT importProgressChanged();
+}
+
+qreal Importer::importProgress() const
+{
+    return m_importProgress;
+}
+
+int Importer::importedCount() const
+{
+    return m_importedCount;
+}
+
+qreal Importer::incidencesPerSecond() const
+{
+    const qint64 elapsed = m_importTimer.isValid() ? m_importTimer.elapsed() : 0;
+    return elapsed > 0 ? m_importedCount * 1000.0 / elapsed : 0;
+}
+
+int Importer::remainingSeconds() const
+{
+    if (!m_reader || m_importProgress <= 0) {
+        return -1;
+    }
+    // Extrapolated from the part of the file imported so far
+    const qint64 elapsed = m_importTimer.elapsed();
+    return qRound(elapsed * (1 - m_importProgress) / m_importProgress / 1000);
 }
 
 QString Importer::importErrorMessage()
@@ -1,13 +1,20 @@
 // SPDX-FileCopyrightText: 2021 Claudio Cambra <claudio.cambra@gmail.com>
 // SPDX-FileCopyrightText: 2023 Carl Schwan <carl@carlschwan.eu>
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #pragma once
 
 #include <Akonadi/ETMCalendar>
 #include <QAction>
+#include <QElapsedTimer>
 #include <QObject>
 
+#include <memory>
+
+class QFile;
+class ICalendarReader;
+
 class Importer : public QObject
 {
     Q_OBJECT
@@ -17,9 +24,18 @@ class Importer : public QObject
     Q_PROPERTY(QAction *importAction READ importAction WRITE setImportAction NOTIFY importActionChanged)
     Q_PROPERTY(Akonadi::ETMCalendar::Ptr calendar MEMBER m_calendar NOTIFY calendarChanged)
     Q_PROPERTY(QString importErrorMessage READ importErrorMessage NOTIFY importErrorMessageChanged)
+    /// Whether incidences already in the calendar, with the same UID and recurrence id, are updated instead of duplicated
+    Q_PROPERTY(bool dedupeByUid MEMBER m_dedupeByUid NOTIFY dedupeByUidChanged)
+    /// Between 0 and 1, or -1 while unknown, as for files imported by Akonadi
+    Q_PROPERTY(qreal importProgress READ importProgress NOTIFY importProgressChanged)
+    Q_PROPERTY(int importedCount READ importedCount NOTIFY importProgressChanged)
+    Q_PROPERTY(qreal incidencesPerSecond READ incidencesPerSecond NOTIFY importProgressChanged)
+    /// The estimated time left, or -1 while unknown
+    Q_PROPERTY(int remainingSeconds READ remainingSeconds NOTIFY importProgressChanged)
 
 public:
     explicit Importer(QObject *parent = nullptr);
+    ~Importer() override;
 
     Q_INVOKABLE void importCalendarFromUrl(const QUrl &url, bool merge, qint64 collectionId = -1);
     QString importErrorMessage();
@@ -27,6 +43,11 @@ public:
     QAction *importAction() const;
     void setImportAction(QAction *importAction);
 
+    qreal importProgress() const;
+    int importedCount() const;
+    qreal incidencesPerSecond() const;
+    int remainingSeconds() const;
+
 Q_SIGNALS:
     void importActionChanged();
     void importStarted();
@@ -41,12 +62,32 @@ Q_SIGNALS:
     void currentFileChanged();
     void calendarChanged();
     void calendarFilesToImportChanged();
+    void dedupeByUidChanged();
+    void importProgressChanged();
 
 private:
+    /// Streams an iCalendar file into @p collection, returns false if it can't be read
+    bool importIntoExisting(const QUrl &url, const Akonadi::Collection &collection);
+    void fetchExistingItems();
+    void importBatch(const KCalendarCore::Incidence::List &incidences);
+    void finishImport(const QString &errorMessage = {});
+    void setCalendarImportInProgress(bool calendarImportInProgress);
+    void setImportProgress(qreal progress, int importedCount);
+
     Akonadi::ETMCalendar::Ptr m_calendar;
     QString m_importErrorMessage;
     bool m_calendarImportInProgress = false;
     QList<QUrl> m_calendarFilesToImport;
     QAction *m_importAction = nullptr;
     QUrl m_currentFile;
-};
\ No newline at end of file
+
+    bool m_dedupeByUid = false;
+    Akonadi::Collection m_importCollection;
+    std::unique_ptr<QFile> m_importFile;
+    std::unique_ptr<ICalendarReader> m_reader;
+    // The items of the collection by instance identifier, only filled when deduplicating
+    QHash<QString, Akonadi::Item> m_existingItems;
+    QElapsedTimer m_importTimer;
+    qreal m_importProgress = 0;
+    int m_importedCount = 0;
+};
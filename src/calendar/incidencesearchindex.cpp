@@ -0,0 +1,600 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "incidencesearchindex.h"
+#include "kalendar_calendar_debug.h"
+
+#include <Akonadi/ETMCalendar>
+#include <Akonadi/EntityTreeModel>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+namespace
+{
+constexpr quint32 fileMagic = 0x4b534958; // "KSIX"
+constexpr quint32 fileVersion = 2;
+// Changes are written in one go once the calendar is quiet for that long
+constexpr int saveDelay = 10000;
+constexpr int gramLength = 3;
+
+enum Weight : quint8 {
+    DescriptionWeight = 1,
+    LocationWeight = 2,
+    AttendeeWeight = 2,
+    CategoryWeight = 3,
+    SummaryWeight = 4,
+};
+
+QStringList splitWords(const QString &normalized)
+{
+    QStringList words;
+    int start = -1;
+    for (int i = 0; i <= normalized.size(); ++i) {
+        const bool isWordCharacter = i < normalized.size() && normalized.at(i).isLetterOrNumber();
+        if (isWordCharacter && start < 0) {
+            start = i;
+        } else if (!isWordCharacter && start >= 0) {
+            words << normalized.mid(start, i - start);
+            start = -1;
+        }
+    }
+    return words;
+}
+
+/// Grams a token is found by: its first one, two and three characters
+QSet<QString> tokenGrams(const QString &token)
+{
+    QSet<QString> grams;
+    for (int length = 1; length <= std::min<int>(gramLength, token.size()); ++length) {
+        grams.insert(token.left(length));
+    }
+    return grams;
+}
+
+qint64 incidenceDuration(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    const auto start = incidence->dateTime(KCalendarCore::Incidence::RoleDisplayStart);
+    const auto end = incidence->dateTime(KCalendarCore::Incidence::RoleDisplayEnd);
+    return start.isValid() && end.isValid() ? std::max<qint64>(0, start.secsTo(end)) : 0;
+}
+}
+
+QDataStream &operator<<(QDataStream &stream, const IncidenceSearchIndex::Document &document)
+{
+    stream << document.instanceIdentifier << document.collectionId << document.itemId;
+    stream << document.summary << document.lastModified << document.start << document.end << document.recurs;
+    stream << quint32(document.tokens.size());
+    for (const auto &token : document.tokens) {
+        stream << token.text << token.weight;
+    }
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, IncidenceSearchIndex::Document &document)
+{
+    stream >> document.instanceIdentifier >> document.collectionId >> document.itemId;
+    stream >> document.summary >> document.lastModified >> document.start >> document.end >> document.recurs;
+    quint32 tokenCount = 0;
+    stream >> tokenCount;
+    // The count comes from the file, nothing is reserved for it as it might be corrupted
+    document.tokens.clear();
+    for (quint32 i = 0; i < tokenCount && stream.status() == QDataStream::Ok; ++i) {
+        IncidenceSearchIndex::Token token;
+        stream >> token.text >> token.weight;
+        document.tokens.append(token);
+    }
+    return stream;
+}
+
+IncidenceSearchIndex::IncidenceSearchIndex(const QString &fileName, QObject *parent)
+    : QObject(parent)
+    , m_fileName(fileName)
+{
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(saveDelay);
+    connect(&m_saveTimer, &QTimer::timeout, this, &IncidenceSearchIndex::save);
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this] {
+            if (m_saveTimer.isActive()) {
+                save();
+            }
+        });
+    }
+
+    load();
+}
+
+IncidenceSearchIndex::~IncidenceSearchIndex()
+{
+    if (m_calendar) {
+        m_calendar->unregisterObserver(this);
+    }
+    if (m_saveTimer.isActive()) {
+        save();
+    }
+}
+
+IncidenceSearchIndex *IncidenceSearchIndex::instance()
+{
+    static auto index = new IncidenceSearchIndex(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/incidencesearchindex"));
+    return index;
+}
+
+QString IncidenceSearchIndex::normalize(const QString &text)
+{
+    const QString decomposed = text.normalized(QString::NormalizationForm_KD).toCaseFolded();
+    QString normalized;
+    normalized.reserve(decomposed.size());
+    for (const QChar c : decomposed) {
+        if (c.category() != QChar::Mark_NonSpacing) {
+            normalized += c;
+        }
+    }
+    return normalized;
+}
+
+int IncidenceSearchIndex::count() const
+{
+    return m_documentForKey.size();
+}
+
+KCalendarCore::Calendar::Ptr IncidenceSearchIndex::calendar() const
+{
+    return m_calendar;
+}
+
+void IncidenceSearchIndex::setCalendar(const KCalendarCore::Calendar::Ptr &calendar)
+{
+    if (m_calendar == calendar) {
+        return;
+    }
+
+    if (m_calendar) {
+        m_calendar->unregisterObserver(this);
+    }
+    disconnect(m_populatedConnection);
+    m_calendar = calendar;
+    m_seen.clear();
+    m_keyForIncidence.clear();
+
+    if (!m_calendar) {
+        return;
+    }
+
+    m_calendar->registerObserver(this);
+    const auto incidences = m_calendar->rawIncidences();
+    for (const auto &incidence : incidences) {
+        insertIfModified(incidence);
+    }
+
+    // What wasn't found once the calendar is loaded was removed while we didn't observe it
+    const auto etmCalendar = m_calendar.dynamicCast<Akonadi::ETMCalendar>();
+    if (etmCalendar && etmCalendar->isLoading()) {
+        m_populatedConnection = connect(etmCalendar->entityTreeModel(), &Akonadi::EntityTreeModel::collectionPopulated, this, [this] {
+            const auto etmCalendar = m_calendar.dynamicCast<Akonadi::ETMCalendar>();
+            if (etmCalendar && !etmCalendar->isLoading()) {
+                disconnect(m_populatedConnection);
+                prune();
+            }
+        });
+    } else {
+        prune();
+    }
+
+    scheduleSave();
+    Q_EMIT changed();
+}
+
+void IncidenceSearchIndex::calendarIncidenceAdded(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    if (insertIfModified(incidence)) {
+        scheduleSave();
+        Q_EMIT changed();
+    }
+}
+
+void IncidenceSearchIndex::calendarIncidenceChanged(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    insert(incidence);
+    scheduleSave();
+    Q_EMIT changed();
+}
+
+void IncidenceSearchIndex::calendarIncidenceDeleted(const KCalendarCore::Incidence::Ptr &incidence, const KCalendarCore::Calendar *calendar)
+{
+    Q_UNUSED(calendar)
+    // The calendar may not know which collection it was in anymore
+    QString key = m_keyForIncidence.take(incidence.data());
+    if (key.isEmpty()) {
+        key = keyOf(documentOf(incidence));
+    }
+    m_seen.remove(key);
+    remove(key);
+    scheduleSave();
+    Q_EMIT changed();
+}
+
+bool IncidenceSearchIndex::insertIfModified(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    const QString key = keyOf(documentOf(incidence));
+    const auto existing = m_documentForKey.constFind(key);
+    if (existing != m_documentForKey.constEnd() && incidence->lastModified().isValid()
+        && m_documents.at(existing.value()).lastModified == incidence->lastModified()) {
+        // Loaded again without changes since it was stored
+        m_seen.insert(key);
+        m_keyForIncidence.insert(incidence.data(), key);
+        return false;
+    }
+    insert(incidence);
+    return true;
+}
+
+void IncidenceSearchIndex::insert(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    Document document = documentOf(incidence);
+    document.summary = incidence->summary();
+    document.lastModified = incidence->lastModified();
+    document.start = incidence->dateTime(KCalendarCore::Incidence::RoleDisplayStart);
+    document.recurs = incidence->recurs();
+    if (document.recurs) {
+        const auto recurrenceEnd = incidence->recurrence()->endDateTime();
+        if (recurrenceEnd.isValid()) {
+            document.end = recurrenceEnd.addSecs(incidenceDuration(incidence));
+        }
+    } else {
+        document.end = document.start.addSecs(incidenceDuration(incidence));
+    }
+
+    QHash<QString, quint8> weights;
+    const auto addText = [&weights](const QString &text, quint8 weight) {
+        const auto words = splitWords(normalize(text));
+        for (const auto &word : words) {
+            auto &tokenWeight = weights[word];
+            tokenWeight = std::max(tokenWeight, weight);
+        }
+    };
+    addText(incidence->summary(), SummaryWeight);
+    addText(incidence->description(), DescriptionWeight);
+    addText(incidence->location(), LocationWeight);
+    const auto categories = incidence->categories();
+    for (const auto &category : categories) {
+        addText(category, CategoryWeight);
+    }
+    const auto attendees = incidence->attendees();
+    for (const auto &attendee : attendees) {
+        addText(attendee.name(), AttendeeWeight);
+        addText(attendee.email(), AttendeeWeight);
+        // The complete address too, so typing one matches it as a whole
+        const auto email = normalize(attendee.email());
+        if (!email.isEmpty()) {
+            weights.insert(email, AttendeeWeight);
+        }
+    }
+
+    document.tokens.reserve(weights.size());
+    for (auto it = weights.cbegin(); it != weights.cend(); ++it) {
+        document.tokens.append({it.key(), it.value()});
+    }
+
+    const QString key = keyOf(document);
+    // Moved to another collection
+    const QString previousKey = m_keyForIncidence.value(incidence.data());
+    if (!previousKey.isEmpty() && previousKey != key) {
+        m_seen.remove(previousKey);
+        remove(previousKey);
+    }
+    m_seen.insert(key);
+    m_keyForIncidence.insert(incidence.data(), key);
+    remove(key);
+    insertDocument(document);
+}
+
+IncidenceSearchIndex::Document IncidenceSearchIndex::documentOf(const KCalendarCore::Incidence::Ptr &incidence) const
+{
+    Document document;
+    document.instanceIdentifier = incidence->instanceIdentifier();
+    if (const auto etmCalendar = m_calendar.dynamicCast<Akonadi::ETMCalendar>()) {
+        const auto item = etmCalendar->item(incidence);
+        document.collectionId = item.parentCollection().id();
+        document.itemId = item.id();
+    }
+    return document;
+}
+
+QString IncidenceSearchIndex::keyOf(const Document &document)
+{
+    return QString::number(document.collectionId) + QLatin1Char('/') + document.instanceIdentifier;
+}
+
+KCalendarCore::Incidence::Ptr IncidenceSearchIndex::incidence(const Document &document) const
+{
+    if (!m_calendar) {
+        return {};
+    }
+    const auto etmCalendar = m_calendar.dynamicCast<Akonadi::ETMCalendar>();
+    if (etmCalendar && document.itemId >= 0) {
+        const auto item = etmCalendar->item(document.itemId);
+        if (item.hasPayload<KCalendarCore::Incidence::Ptr>()) {
+            return item.payload<KCalendarCore::Incidence::Ptr>();
+        }
+    }
+    return m_calendar->instance(document.instanceIdentifier);
+}
+
+void IncidenceSearchIndex::insertDocument(const Document &document)
+{
+    int documentIndex;
+    if (m_freeDocuments.isEmpty()) {
+        documentIndex = m_documents.size();
+        m_documents.append(document);
+    } else {
+        documentIndex = m_freeDocuments.takeLast();
+        m_documents[documentIndex] = document;
+    }
+    m_documentForKey.insert(keyOf(document), documentIndex);
+
+    QSet<QString> grams;
+    for (const auto &token : document.tokens) {
+        grams.unite(tokenGrams(token.text));
+    }
+    for (const auto &gram : std::as_const(grams)) {
+        m_postings[gram].append(documentIndex);
+    }
+}
+
+void IncidenceSearchIndex::remove(const QString &key)
+{
+    const auto it = m_documentForKey.find(key);
+    if (it == m_documentForKey.end()) {
+        return;
+    }
+    const int documentIndex = it.value();
+    m_documentForKey.erase(it);
+
+    // Searching skips removed documents, so they are only taken out of the postings once a good share of
+    // them is removed, instead of looking for each of them in the postings of all of its grams
+    m_documents[documentIndex] = Document{};
+    m_removedDocuments.append(documentIndex);
+    if (m_removedDocuments.size() > 64 && m_removedDocuments.size() * 4 > m_documents.size()) {
+        purgeRemovedDocuments();
+    }
+}
+
+void IncidenceSearchIndex::purgeRemovedDocuments()
+{
+    for (auto posting = m_postings.begin(); posting != m_postings.end();) {
+        const auto removed = std::remove_if(posting->begin(), posting->end(), [this](int documentIndex) {
+            return m_documents.at(documentIndex).instanceIdentifier.isEmpty();
+        });
+        posting->erase(removed, posting->end());
+        if (posting->isEmpty()) {
+            posting = m_postings.erase(posting);
+        } else {
+            ++posting;
+        }
+    }
+    m_freeDocuments += m_removedDocuments;
+    m_removedDocuments.clear();
+}
+
+void IncidenceSearchIndex::rebuildPostings()
+{
+    QVector<Document> documents;
+    documents.reserve(m_documentForKey.size());
+    for (const auto &document : std::as_const(m_documents)) {
+        if (!document.instanceIdentifier.isEmpty()) {
+            documents.append(document);
+        }
+    }
+
+    m_documents.clear();
+    m_freeDocuments.clear();
+    m_removedDocuments.clear();
+    m_documentForKey.clear();
+    m_postings.clear();
+    for (const auto &document : std::as_const(documents)) {
+        insertDocument(document);
+    }
+}
+
+void IncidenceSearchIndex::prune()
+{
+    bool pruned = false;
+    for (auto &document : m_documents) {
+        if (!document.instanceIdentifier.isEmpty() && !m_seen.contains(keyOf(document))) {
+            document = Document{};
+            pruned = true;
+        }
+    }
+    if (!pruned) {
+        return;
+    }
+
+    // Removing many documents one by one would go through the large postings again and again
+    rebuildPostings();
+    scheduleSave();
+    Q_EMIT changed();
+}
+
+bool IncidenceSearchIndex::occursWithin(const Document &document, const QDateTime &from, const QDateTime &to) const
+{
+    if (!from.isValid() && !to.isValid()) {
+        return true;
+    }
+    if (!document.start.isValid() || (to.isValid() && document.start > to) || (from.isValid() && document.end.isValid() && document.end < from)) {
+        return false;
+    }
+    if (!document.recurs || !from.isValid() || !m_calendar) {
+        return true;
+    }
+
+    // The span of the recurrence can have gaps around the range
+    const auto incidence = this->incidence(document);
+    if (!incidence) {
+        return true;
+    }
+    const auto next = incidence->recurrence()->getNextDateTime(from.addSecs(-incidenceDuration(incidence) - 1));
+    return next.isValid() && (!to.isValid() || next <= to);
+}
+
+QVector<IncidenceSearchIndex::Result> IncidenceSearchIndex::search(const QString &text, const QDateTime &from, const QDateTime &to, int limit) const
+{
+    const auto words = splitWords(normalize(text));
+    if (words.isEmpty()) {
+        return {};
+    }
+
+    // Every match has the prefixes of all words, so only the documents of the rarest one need to be looked at
+    const QVector<int> *candidates = nullptr;
+    for (const auto &word : words) {
+        const auto posting = m_postings.constFind(word.left(gramLength));
+        if (posting == m_postings.constEnd()) {
+            return {};
+        }
+        if (!candidates || posting->size() < candidates->size()) {
+            candidates = &posting.value();
+        }
+    }
+
+    struct Match {
+        int score;
+        const Document *document;
+    };
+    std::vector<Match> matches;
+    for (const int documentIndex : *candidates) {
+        const auto &document = m_documents.at(documentIndex);
+        if (document.instanceIdentifier.isEmpty()) {
+            continue;
+        }
+        int score = 0;
+        for (const auto &word : words) {
+            int wordScore = 0;
+            for (const auto &token : document.tokens) {
+                if (token.text == word) {
+                    wordScore = std::max(wordScore, 2 * token.weight);
+                } else if (token.text.startsWith(word)) {
+                    wordScore = std::max<int>(wordScore, token.weight);
+                }
+            }
+            if (wordScore == 0) {
+                score = 0;
+                break;
+            }
+            score += wordScore;
+        }
+        if (score > 0 && occursWithin(document, from, to)) {
+            matches.push_back({score, &document});
+        }
+    }
+
+    const auto better = [](const Match &left, const Match &right) {
+        if (left.score != right.score) {
+            return left.score > right.score;
+        }
+        // The most recent first, those without date last
+        return left.document->start > right.document->start;
+    };
+    if (limit >= 0 && limit < int(matches.size())) {
+        std::partial_sort(matches.begin(), matches.begin() + limit, matches.end(), better);
+        matches.resize(limit);
+    } else {
+        std::sort(matches.begin(), matches.end(), better);
+    }
+
+    QVector<Result> results;
+    results.reserve(matches.size());
+    for (const auto &match : matches) {
+        const auto document = match.document;
+        results.append({document->instanceIdentifier, document->itemId, document->summary, document->start, document->end, match.score});
+    }
+    return results;
+}
+
+void IncidenceSearchIndex::scheduleSave()
+{
+    if (!m_fileName.isEmpty() && !m_saveTimer.isActive()) {
+        m_saveTimer.start();
+    }
+}
+
+bool IncidenceSearchIndex::load()
+{
+    if (m_fileName.isEmpty()) {
+        return false;
+    }
+
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 documentCount = 0;
+    stream >> magic >> version;
+    if (magic != fileMagic || version != fileVersion) {
+        qCDebug(KALENDAR_CALENDAR_LOG) << "Ignoring search index of an other version" << m_fileName;
+        return false;
+    }
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream >> documentCount;
+
+    m_documents.clear();
+    m_freeDocuments.clear();
+    m_removedDocuments.clear();
+    m_documentForKey.clear();
+    m_postings.clear();
+    // As for the tokens, nothing is reserved for a count read from the file
+    for (quint32 i = 0; i < documentCount && stream.status() == QDataStream::Ok; ++i) {
+        Document document;
+        stream >> document;
+        if (stream.status() == QDataStream::Ok) {
+            insertDocument(document);
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(KALENDAR_CALENDAR_LOG) << "The search index is corrupted, rebuilding it" << m_fileName;
+        m_documents.clear();
+        m_freeDocuments.clear();
+        m_removedDocuments.clear();
+        m_documentForKey.clear();
+        m_postings.clear();
+        return false;
+    }
+    return true;
+}
+
+bool IncidenceSearchIndex::save()
+{
+    m_saveTimer.stop();
+    if (m_fileName.isEmpty()) {
+        return false;
+    }
+
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(KALENDAR_CALENDAR_LOG) << "Unable to write the search index" << m_fileName << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream << fileMagic << fileVersion;
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << quint32(m_documentForKey.size());
+    for (const auto &document : std::as_const(m_documents)) {
+        if (!document.instanceIdentifier.isEmpty()) {
+            stream << document;
+        }
+    }
+    return file.commit();
+}
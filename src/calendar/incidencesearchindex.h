@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <Akonadi/Collection>
+#include <Akonadi/Item>
+#include <KCalendarCore/Calendar>
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
+
+/**
+ * Full-text search index over the incidences of a calendar.
+ *
+ * Summaries, descriptions, locations, attendees and categories are split into normalized
+ * tokens (case folded, without diacritics), weighted by the field they come from. Every token
+ * is indexed by its first one, two and three characters, so a query only has to look at the
+ * incidences sharing the rarest prefix of its words.
+ *
+ * The index observes the calendar to stay up to date, and is stored on disk, so that it can be
+ * searched at startup and only the incidences modified since need indexing again.
+ */
+class IncidenceSearchIndex : public QObject, public KCalendarCore::Calendar::CalendarObserver
+{
+    Q_OBJECT
+public:
+    struct Result {
+        QString instanceIdentifier;
+        // -1 outside of Akonadi calendars
+        Akonadi::Item::Id itemId = -1;
+        QString summary;
+        QDateTime start;
+        QDateTime end;
+        int score = 0;
+    };
+
+    /// An index stored in @p fileName, or only in memory if it is empty
+    explicit IncidenceSearchIndex(const QString &fileName = {}, QObject *parent = nullptr);
+    ~IncidenceSearchIndex() override;
+
+    /// The index stored in the application data directory
+    static IncidenceSearchIndex *instance();
+
+    KCalendarCore::Calendar::Ptr calendar() const;
+    /// Indexes the incidences of @p calendar and follows its changes
+    void setCalendar(const KCalendarCore::Calendar::Ptr &calendar);
+
+    /**
+     * Returns the incidences having a token starting with each word of @p text, best matches first.
+     *
+     * Matches in the summary weigh most, then categories, location and attendees, then the
+     * description, and whole words weigh twice as much as prefixes. If @p from or @p to are
+     * valid, only incidences with an occurrence in between are returned.
+     */
+    QVector<Result> search(const QString &text, const QDateTime &from = {}, const QDateTime &to = {}, int limit = -1) const;
+
+    int count() const;
+
+    /// Removes the incidences which weren't found in the calendar since it was set
+    void prune();
+
+    bool load();
+    bool save();
+
+    static QString normalize(const QString &text);
+
+    void calendarIncidenceAdded(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void calendarIncidenceChanged(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void calendarIncidenceDeleted(const KCalendarCore::Incidence::Ptr &incidence, const KCalendarCore::Calendar *calendar) override;
+
+Q_SIGNALS:
+    /// Emitted after incidences were added, changed or removed
+    void changed();
+
+private:
+    struct Token {
+        QString text;
+        quint8 weight = 0;
+    };
+
+    struct Document {
+        // Empty once removed
+        QString instanceIdentifier;
+        // The same incidence can be in several collections, -1 outside of Akonadi calendars
+        Akonadi::Collection::Id collectionId = -1;
+        Akonadi::Item::Id itemId = -1;
+        QString summary;
+        QDateTime lastModified;
+        QDateTime start;
+        // Invalid with a valid start for incidences recurring forever
+        QDateTime end;
+        bool recurs = false;
+        QVector<Token> tokens;
+    };
+
+    friend QDataStream &operator<<(QDataStream &stream, const Document &document);
+    friend QDataStream &operator>>(QDataStream &stream, Document &document);
+
+    /// Indexes @p incidence unless it is indexed already with the same modification time
+    bool insertIfModified(const KCalendarCore::Incidence::Ptr &incidence);
+    void insert(const KCalendarCore::Incidence::Ptr &incidence);
+    void insertDocument(const Document &document);
+    /// A document with the identifiers of @p incidence, without its content
+    Document documentOf(const KCalendarCore::Incidence::Ptr &incidence) const;
+    /// The key of @p document in m_documentForKey, which differs between collections
+    static QString keyOf(const Document &document);
+    void remove(const QString &key);
+    void purgeRemovedDocuments();
+    void rebuildPostings();
+    KCalendarCore::Incidence::Ptr incidence(const Document &document) const;
+    bool occursWithin(const Document &document, const QDateTime &from, const QDateTime &to) const;
+    void scheduleSave();
+
+    const QString m_fileName;
+    KCalendarCore::Calendar::Ptr m_calendar;
+    QVector<Document> m_documents;
+    QVector<int> m_freeDocuments;
+    // Still in the postings, reused once they are purged from them
+    QVector<int> m_removedDocuments;
+    QHash<QString, int> m_documentForKey;
+    // The keys of the incidences of the calendar as they were indexed, which deleted ones can't be looked up again with
+    QHash<const KCalendarCore::Incidence *, QString> m_keyForIncidence;
+    QHash<QString, QVector<int>> m_postings;
+    // The keys of the incidences found in the calendar since it was set, the others are stale
+    QSet<QString> m_seen;
+    QMetaObject::Connection m_populatedConnection;
+    QTimer m_saveTimer;
+};
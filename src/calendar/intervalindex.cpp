@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "intervalindex.h"
+
+#include <algorithm>
+
+void IntervalIndex::clear()
+{
+    m_intervals.clear();
+    m_rootLevel = -1;
+}
+
+void IntervalIndex::reserve(int count)
+{
+    m_intervals.reserve(count);
+}
+
+void IntervalIndex::add(qint64 start, qint64 end, int value)
+{
+    m_intervals.append({start, std::max(start, end), 0, value});
+    m_rootLevel = -1;
+}
+
+int IntervalIndex::count() const
+{
+    return m_intervals.size();
+}
+
+void IntervalIndex::build()
+{
+    std::sort(m_intervals.begin(), m_intervals.end(), [](const Interval &left, const Interval &right) {
+        return left.start < right.start;
+    });
+
+    // Node i is at the level of the number of trailing ones of i, the leaves are the even ones
+    const qint64 n = m_intervals.size();
+    m_rootLevel = -1;
+    if (n == 0) {
+        return;
+    }
+
+    qint64 lastIndex = 0;
+    qint64 lastMaxEnd = 0;
+    for (qint64 i = 0; i < n; i += 2) {
+        lastIndex = i;
+        lastMaxEnd = m_intervals[i].maxEnd = m_intervals.at(i).end;
+    }
+
+    int level = 1;
+    for (; (qint64(1) << level) <= n; ++level) {
+        const qint64 step = qint64(1) << (level - 1);
+        for (qint64 i = (step << 1) - 1; i < n; i += step << 2) {
+            const qint64 leftMaxEnd = m_intervals.at(i - step).maxEnd;
+            // Past the end of an incomplete tree, the right child is the last node of that level
+            const qint64 rightMaxEnd = i + step < n ? m_intervals.at(i + step).maxEnd : lastMaxEnd;
+            m_intervals[i].maxEnd = std::max({m_intervals.at(i).end, leftMaxEnd, rightMaxEnd});
+        }
+        lastIndex = (lastIndex >> level & 1) ? lastIndex - step : lastIndex + step;
+        if (lastIndex < n && m_intervals.at(lastIndex).maxEnd > lastMaxEnd) {
+            lastMaxEnd = m_intervals.at(lastIndex).maxEnd;
+        }
+    }
+    m_rootLevel = level - 1;
+}
+
+QVector<int> IntervalIndex::overlapping(qint64 start, qint64 end) const
+{
+    QVector<int> values;
+    forEachOverlap(start, end, [&values](int value) {
+        values.append(value);
+        return true;
+    });
+    return values;
+}
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <QVector>
+
+#include <algorithm>
+
+/**
+ * Static index of half-open intervals answering which of them overlap a given one.
+ *
+ * The intervals are sorted by start and laid out as an implicit binary tree, each node
+ * knowing the largest end below it, so a query takes O(log n + matches) without any
+ * allocation. Call build() after adding intervals and before querying.
+ */
+class IntervalIndex
+{
+public:
+    void clear();
+    void reserve(int count);
+    void add(qint64 start, qint64 end, int value);
+    void build();
+    int count() const;
+
+    /**
+     * Calls @p function with the value of every interval overlapping @p start to @p end,
+     * in order of start, until it returns false. Returns false if it was stopped.
+     */
+    template<typename Function>
+    bool forEachOverlap(qint64 start, qint64 end, Function function) const;
+
+    QVector<int> overlapping(qint64 start, qint64 end) const;
+
+private:
+    struct Interval {
+        qint64 start;
+        qint64 end;
+        qint64 maxEnd;
+        int value;
+    };
+
+    QVector<Interval> m_intervals;
+    int m_rootLevel = -1;
+};
+
+template<typename Function>
+bool IntervalIndex::forEachOverlap(qint64 start, qint64 end, Function function) const
+{
+    struct Node {
+        int level;
+        qint64 index;
+        bool leftDone;
+    };
+
+    const qint64 n = m_intervals.size();
+    if (m_rootLevel < 0 || start >= end) {
+        return true;
+    }
+
+    Node stack[64];
+    int top = 0;
+    stack[top++] = {m_rootLevel, (qint64(1) << m_rootLevel) - 1, false};
+    while (top > 0) {
+        const Node node = stack[--top];
+        if (node.level <= 3) {
+            // Small subtree, cheaper to go through in order
+            const qint64 first = node.index >> node.level << node.level;
+            const qint64 last = std::min(first + (qint64(1) << (node.level + 1)) - 1, n);
+            for (qint64 i = first; i < last && m_intervals.at(i).start < end; ++i) {
+                if (start < m_intervals.at(i).end && !function(m_intervals.at(i).value)) {
+                    return false;
+                }
+            }
+        } else if (!node.leftDone) {
+            // The left child might be past the end of an incomplete tree
+            const qint64 left = node.index - (qint64(1) << (node.level - 1));
+            stack[top++] = {node.level, node.index, true};
+            if (left >= n || m_intervals.at(left).maxEnd > start) {
+                stack[top++] = {node.level - 1, left, false};
+            }
+        } else if (node.index < n && m_intervals.at(node.index).start < end) {
+            const auto &interval = m_intervals.at(node.index);
+            if (start < interval.end && !function(interval.value)) {
+                return false;
+            }
+            stack[top++] = {node.level - 1, node.index + (qint64(1) << (node.level - 1)), false};
+        }
+    }
+    return true;
+}
@@ -1,7 +1,9 @@
 // SPDX-FileCopyrightText: 2023 Carl Schwan <carlschwan@kde.org>
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include "../config-kalendar.h"
+#include "calendarexporter.h"
 #include "importer.h"
 #include "mousetracker.h"
 #include <KAboutData>
@@ -17,11 +19,13 @@
 #include <QDBusConnection>
 #include <QDBusConnectionInterface>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QIcon>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
 #include <QQuickStyle>
 #include <QQuickWindow>
+#include <QTextStream>
 #include <qobject.h>
 
 static void raiseWindow(QWindow *window)
@@ -30,6 +34,56 @@ static void raiseWindow(QWindow *window)
     KWindowSystem::activateWindow(window);
 }
 
+static int exportCalendars(const QString &fileName, const QStringList &collectionIds, const QString &from, const QString &to)
+{
+    QTextStream errorOutput(stderr);
+    Akonadi::Collection::List collections;
+    for (const auto &collectionId : collectionIds) {
+        bool ok = false;
+        const qint64 id = collectionId.toLongLong(&ok);
+        if (!ok || id < 0) {
+            errorOutput << i18n("Invalid calendar id: %1", collectionId) << Qt::endl;
+            return 1;
+        }
+        collections.append(Akonadi::Collection(id));
+    }
+
+    const QDate fromDate = QDate::fromString(from, Qt::ISODate);
+    const QDate toDate = QDate::fromString(to, Qt::ISODate);
+    if (!from.isEmpty() && !fromDate.isValid()) {
+        errorOutput << i18n("Invalid date: %1, expected yyyy-mm-dd", from) << Qt::endl;
+        return 1;
+    }
+    if (!to.isEmpty() && !toDate.isValid()) {
+        errorOutput << i18n("Invalid date: %1, expected yyyy-mm-dd", to) << Qt::endl;
+        return 1;
+    }
+    if (fromDate.isValid() && toDate.isValid() && fromDate >= toDate) {
+        errorOutput << i18n("The start date %1 has to be before the end date %2", from, to) << Qt::endl;
+        return 1;
+    }
+
+    CalendarExporter exporter;
+    QObject::connect(&exporter, &CalendarExporter::finished, qApp, [](bool success) {
+        QCoreApplication::exit(success ? 0 : 1);
+    });
+    QElapsedTimer timer;
+    timer.start();
+    exporter.exportToFile(QDir::current().absoluteFilePath(fileName),
+                          collections,
+                          fromDate.isValid() ? fromDate.startOfDay() : QDateTime(),
+                          toDate.isValid() ? toDate.startOfDay() : QDateTime());
+
+    const bool success = exporter.running() && QCoreApplication::exec() == 0;
+    if (success) {
+        QTextStream(stdout) << i18n("%1 incidences exported in %2 ms, %3 per second", exporter.exportedCount(), timer.elapsed(), qRound(exporter.incidencesPerSecond()))
+                            << Qt::endl;
+    } else {
+        errorOutput << exporter.errorMessage() << Qt::endl;
+    }
+    return success ? 0 : 1;
+}
+
 int main(int argc, char *argv[])
 {
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -79,9 +133,18 @@ int main(int argc, char *argv[])
 
     QCommandLineParser parser;
     aboutData.setupCommandLine(&parser);
+    const QCommandLineOption exportOption(QStringLiteral("export"), i18n("Export calendars to an iCalendar file without showing any window"), i18n("file"));
+    const QCommandLineOption collectionOption(QStringLiteral("collection"), i18n("Id of a calendar to export, all of them by default"), i18n("id"));
+    const QCommandLineOption fromOption(QStringLiteral("from"), i18n("Only export what occurs from this date on"), i18n("yyyy-mm-dd"));
+    const QCommandLineOption toOption(QStringLiteral("to"), i18n("Only export what occurs before this date"), i18n("yyyy-mm-dd"));
+    parser.addOptions({exportOption, collectionOption, fromOption, toOption});
     parser.process(app);
     aboutData.processCommandLine(&parser);
 
+    if (parser.isSet(exportOption)) {
+        return exportCalendars(parser.value(exportOption), parser.values(collectionOption), parser.value(fromOption), parser.value(toOption));
+    }
+
     const auto mouseTracker = MouseTracker::instance();
     qmlRegisterSingletonInstance("org.kde.kalendar.calendar.private", 1, 0, "MouseTracker", mouseTracker);
 
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include "attendeesmodel.h"
+#include "../attendeecontactresolver.h"
 #include "kalendar_calendar_debug.h"
 #include <KContacts/Addressee>
 #include <KLocalizedString>
@@ -12,9 +13,6 @@
 #include <Akonadi/Item>
 #include <Akonadi/ItemFetchJob>
 #include <Akonadi/ItemFetchScope>
-#include <Akonadi/SearchQuery>
-
-#include <Akonadi/ContactSearchJob>
 
 AttendeeStatusModel::AttendeeStatusModel(QObject *parent)
     : QAbstractListModel(parent)
@@ -76,6 +74,7 @@ AttendeesModel::AttendeesModel(QObject *parent, KCalendarCore::Incidence::Ptr in
     , m_attendeeStatusModel(parent)
 {
     connect(this, &AttendeesModel::attendeesChanged, this, &AttendeesModel::updateAkonadiContactIds);
+    connect(AttendeeContactResolver::instance(), &AttendeeContactResolver::resolved, this, &AttendeesModel::contactsResolved);
 }
 
 KCalendarCore::Incidence::Ptr AttendeesModel::incidencePtr() const
@@ -103,26 +102,52 @@ KCalendarCore::Attendee::List AttendeesModel::attendees() const
 
 void AttendeesModel::updateAkonadiContactIds()
 {
-    m_attendeesAkonadiIds.clear();
+    if (!m_incidence) {
+        return;
+    }
 
+    // Only the addresses which weren't resolved before are searched, all of them at once
+    QStringList emails;
     const auto attendees = m_incidence->attendees();
     for (const auto &attendee : attendees) {
-        auto job = new Akonadi::ContactSearchJob();
-        job->setQuery(Akonadi::ContactSearchJob::Email, attendee.email());
+        emails << attendee.email();
+    }
+    AttendeeContactResolver::instance()->resolve(emails);
 
-        connect(job, &Akonadi::ContactSearchJob::result, this, [this](KJob *job) {
-            auto searchJob = qobject_cast<Akonadi::ContactSearchJob *>(job);
+    updateAkonadiIdsList();
+}
 
-            const auto items = searchJob->items();
-            for (const auto &item : items) {
-                m_attendeesAkonadiIds.append(item.id());
-            }
+void AttendeesModel::contactsResolved(const QStringList &emails)
+{
+    if (!m_incidence) {
+        return;
+    }
 
-            Q_EMIT attendeesAkonadiIdsChanged();
-        });
+    const auto attendees = m_incidence->attendees();
+    for (int i = 0; i < attendees.count(); i++) {
+        if (emails.contains(AttendeeContactResolver::normalizedEmail(attendees[i].email()))) {
+            Q_EMIT dataChanged(index(i), index(i), {AkonadiIdsRole});
+        }
     }
 
-    Q_EMIT attendeesAkonadiIdsChanged();
+    updateAkonadiIdsList();
+}
+
+void AttendeesModel::updateAkonadiIdsList()
+{
+    QList<qint64> ids;
+    const auto attendees = m_incidence->attendees();
+    for (const auto &attendee : attendees) {
+        const auto contactIds = AttendeeContactResolver::instance()->contactIds(attendee.email());
+        for (const auto id : contactIds) {
+            ids.append(id);
+        }
+    }
+
+    if (ids != m_attendeesAkonadiIds) {
+        m_attendeesAkonadiIds = ids;
+        Q_EMIT attendeesAkonadiIdsChanged();
+    }
 }
 
 AttendeeStatusModel *AttendeesModel::attendeeStatusModel()
@@ -164,6 +189,14 @@ QVariant AttendeesModel::data(const QModelIndex &idx, int role) const
         return attendee.status();
     case UidRole:
         return attendee.uid();
+    case AkonadiIdsRole: {
+        QVariantList ids;
+        const auto contactIds = AttendeeContactResolver::instance()->contactIds(attendee.email());
+        for (const auto id : contactIds) {
+            ids.append(id);
+        }
+        return ids;
+    }
     default:
         qCWarning(KALENDAR_CALENDAR_LOG) << "Unknown role for attendee:" << QMetaEnum::fromType<Roles>().valueToKey(role);
         return {};
@@ -256,6 +289,7 @@ QHash<int, QByteArray> AttendeesModel::roleNames() const
         {RSVPRole, QByteArrayLiteral("rsvp")},
         {StatusRole, QByteArrayLiteral("status")},
         {UidRole, QByteArrayLiteral("uid")},
+        {AkonadiIdsRole, QByteArrayLiteral("akonadiIds")},
     };
 }
 
@@ -50,7 +50,8 @@ public:
         RoleRole,
         RSVPRole,
         StatusRole,
-        UidRole
+        UidRole,
+        AkonadiIdsRole,
     };
     Q_ENUM(Roles)
 
@@ -80,6 +81,9 @@ Q_SIGNALS:
     void attendeesAkonadiIdsChanged();
 
 private:
+    void contactsResolved(const QStringList &emails);
+    void updateAkonadiIdsList();
+
     KCalendarCore::Incidence::Ptr m_incidence;
     AttendeeStatusModel m_attendeeStatusModel;
     QList<qint64> m_attendeesAkonadiIds;
@@ -2,8 +2,10 @@
 // SPDX-License-Identifier: LGPL-2.0-or-later
 
 #include "hourlyincidencemodel.h"
-#include <QTimeZone>
+#include "../timezonecache.h"
+#include "occurrencerecord.h"
 #include <cmath>
+#include <tuple>
 
 using namespace std::chrono_literals;
 
@@ -30,40 +32,32 @@ int HourlyIncidenceModel::rowCount(const QModelIndex &parent) const
     return 0;
 }
 
-static double getDuration(const QDateTime &start, const QDateTime &end, int periodLength)
-{
-    return ((start.secsTo(end) * 1.0) / 60.0) / periodLength;
-}
-
 // We first sort all occurrences so we get all-day first (sorted by duration),
 // and then the rest sorted by start-date.
-QList<QModelIndex> HourlyIncidenceModel::sortedIncidencesFromSourceModel(const QDateTime &rowStart) const
+QList<QModelIndex> HourlyIncidenceModel::sortedIncidencesFromSourceModel(int rowDay) const
 {
-    // Don't add days if we are going for a daily period
-    const auto rowEnd = rowStart.date().endOfDay();
     QList<QModelIndex> sorted;
     sorted.reserve(mSourceModel->rowCount());
     // Get incidences from source model
     for (int row = 0; row < mSourceModel->rowCount(); row++) {
-        const auto srcIdx = mSourceModel->index(row, 0, {});
-        const auto start = srcIdx.data(IncidenceOccurrenceModel::StartTime).toDateTime().toTimeZone(QTimeZone::systemTimeZone());
-        const auto end = srcIdx.data(IncidenceOccurrenceModel::EndTime).toDateTime().toTimeZone(QTimeZone::systemTimeZone());
+        const auto &occurrence = mSourceModel->occurrence(row);
 
-        // Skip incidences not part of the week
-        if (end < rowStart || start > rowEnd) {
-            // qCWarning(KALENDAR_CALENDAR_LOG) << "Skipping because not part of this week";
+        // Skip incidences not part of the day
+        if (occurrence.endDay < rowDay || occurrence.startDay > rowDay) {
+            // qCWarning(KALENDAR_CALENDAR_LOG) << "Skipping because not part of this day";
             continue;
         }
 
-        if (m_filters.testFlag(NoAllDay) && srcIdx.data(IncidenceOccurrenceModel::AllDay).toBool()) {
+        if (m_filters.testFlag(NoAllDay) && occurrence.allDay) {
             continue;
         }
 
+        const auto srcIdx = mSourceModel->index(row, 0, {});
         if (m_filters.testFlag(NoMultiDay) && srcIdx.data(IncidenceOccurrenceModel::Duration).value<KCalendarCore::Duration>().asDays() >= 1) {
             continue;
         }
 
-        const auto incidencePtr = srcIdx.data(IncidenceOccurrenceModel::IncidencePtr).value<KCalendarCore::Incidence::Ptr>();
+        const auto &incidencePtr = occurrence.incidence;
         const auto incidenceIsTodo = incidencePtr->type() == Incidence::TypeTodo;
         if (!m_showTodos && incidenceIsTodo) {
             continue;
@@ -79,22 +73,19 @@ QList<QModelIndex> HourlyIncidenceModel::sortedIncidencesFromSourceModel(const Q
 
     // Sort incidences by date
     std::sort(sorted.begin(), sorted.end(), [&](const QModelIndex &left, const QModelIndex &right) {
-        // All-day first
-        const auto leftAllDay = left.data(IncidenceOccurrenceModel::AllDay).toBool();
-        const auto rightAllDay = right.data(IncidenceOccurrenceModel::AllDay).toBool();
+        const auto &leftOccurrence = mSourceModel->occurrence(left.row());
+        const auto &rightOccurrence = mSourceModel->occurrence(right.row());
 
-        const auto leftDt = left.data(IncidenceOccurrenceModel::StartTime).toDateTime();
-        const auto rightDt = right.data(IncidenceOccurrenceModel::StartTime).toDateTime();
-
-        if (leftAllDay && !rightAllDay) {
+        // All-day first
+        if (leftOccurrence.allDay && !rightOccurrence.allDay) {
             return true;
         }
-        if (!leftAllDay && rightAllDay) {
+        if (!leftOccurrence.allDay && rightOccurrence.allDay) {
             return false;
         }
 
         // The rest sorted by start date
-        return leftDt < rightDt;
+        return std::tie(leftOccurrence.startDay, leftOccurrence.startMinute) < std::tie(rightOccurrence.startDay, rightOccurrence.startMinute);
     });
 
     return sorted;
@@ -106,11 +97,13 @@ QList<QModelIndex> HourlyIncidenceModel::sortedIncidencesFromSourceModel(const Q
  * The line grouping algorithm then always picks the first incidence,
  * and tries to add more to the same line.
  *
+ * Times come precomputed in local days and minutes with the occurrences, so nothing here
+ * needs to convert between time zones.
  */
 QVariantList HourlyIncidenceModel::layoutLines(const QDateTime &rowStart) const
 {
-    QList<QModelIndex> sorted = sortedIncidencesFromSourceModel(rowStart);
-    const auto rowEnd = rowStart.date().endOfDay();
+    const int rowDay = int(TimeZoneCache::dayOf(rowStart.date()));
+    QList<QModelIndex> sorted = sortedIncidencesFromSourceModel(rowDay);
     const int periodsPerDay = (24 * 60) / mPeriodLength;
 
     // for (const auto &srcIdx : sorted) {
@@ -119,35 +112,15 @@ QVariantList HourlyIncidenceModel::layoutLines(const QDateTime &rowStart) const
     //     << srcIdx.data(IncidenceOccurrenceModel::AllDay).toBool();
     // }
     QVariantList result;
+    // The start of each incidence of result in minutes from the start of the day
+    QVector<int> startMinutes;
+    startMinutes.reserve(sorted.count());
 
     auto addToResults = [&result](const QModelIndex &idx, double start, double duration) {
-        auto incidenceMap = QVariantMap{
-            {QStringLiteral("text"), idx.data(IncidenceOccurrenceModel::Summary)},
-            {QStringLiteral("description"), idx.data(IncidenceOccurrenceModel::Description)},
-            {QStringLiteral("location"), idx.data(IncidenceOccurrenceModel::Location)},
-            {QStringLiteral("startTime"), idx.data(IncidenceOccurrenceModel::StartTime)},
-            {QStringLiteral("endTime"), idx.data(IncidenceOccurrenceModel::EndTime)},
-            {QStringLiteral("allDay"), idx.data(IncidenceOccurrenceModel::AllDay)},
-            {QStringLiteral("todoCompleted"), idx.data(IncidenceOccurrenceModel::TodoCompleted)},
-            {QStringLiteral("priority"), idx.data(IncidenceOccurrenceModel::Priority)},
-            {QStringLiteral("starts"), start},
-            {QStringLiteral("duration"), duration},
-            {QStringLiteral("durationString"), idx.data(IncidenceOccurrenceModel::DurationString)},
-            {QStringLiteral("recurs"), idx.data(IncidenceOccurrenceModel::Recurs)},
-            {QStringLiteral("hasReminders"), idx.data(IncidenceOccurrenceModel::HasReminders)},
-            {QStringLiteral("isOverdue"), idx.data(IncidenceOccurrenceModel::IsOverdue)},
-            {QStringLiteral("isReadOnly"), idx.data(IncidenceOccurrenceModel::IsReadOnly)},
-            {QStringLiteral("color"), idx.data(IncidenceOccurrenceModel::Color)},
-            {QStringLiteral("collectionId"), idx.data(IncidenceOccurrenceModel::CollectionId)},
-            {QStringLiteral("incidenceId"), idx.data(IncidenceOccurrenceModel::IncidenceId)},
-            {QStringLiteral("incidenceType"), idx.data(IncidenceOccurrenceModel::IncidenceType)},
-            {QStringLiteral("incidenceTypeStr"), idx.data(IncidenceOccurrenceModel::IncidenceTypeStr)},
-            {QStringLiteral("incidenceTypeIcon"), idx.data(IncidenceOccurrenceModel::IncidenceTypeIcon)},
-            {QStringLiteral("incidencePtr"), idx.data(IncidenceOccurrenceModel::IncidencePtr)},
-            {QStringLiteral("incidenceOccurrence"), idx.data(IncidenceOccurrenceModel::IncidenceOccurrence)},
-        };
-
-        result.append(incidenceMap);
+        auto record = idx.data(IncidenceOccurrenceModel::Record).value<OccurrenceRecord>();
+        record.setStarts(start);
+        record.setDuration(duration);
+        result.append(QVariant::fromValue(record));
     };
 
     // Since our hourly view displays by the minute, we need to know how many incidences there are in each minute.
@@ -166,30 +139,25 @@ QVariantList HourlyIncidenceModel::layoutLines(const QDateTime &rowStart) const
 
     while (!sorted.isEmpty()) {
         const auto idx = sorted.takeFirst();
-        const auto startDT = idx.data(IncidenceOccurrenceModel::StartTime).toDateTime().toTimeZone(QTimeZone::systemTimeZone()) > rowStart
-            ? idx.data(IncidenceOccurrenceModel::StartTime).toDateTime().toTimeZone(QTimeZone::systemTimeZone())
-            : rowStart;
-        const auto endDT = idx.data(IncidenceOccurrenceModel::EndTime).toDateTime().toTimeZone(QTimeZone::systemTimeZone()) < rowEnd
-            ? idx.data(IncidenceOccurrenceModel::EndTime).toDateTime().toTimeZone(QTimeZone::systemTimeZone())
-            : rowEnd;
+        const auto &occurrence = mSourceModel->occurrence(idx.row());
+        // Incidences starting before the day are displayed from its start
+        const int startMinutesFromDayStart = occurrence.startDay < rowDay ? 0 : occurrence.startMinute;
         // Need to convert ints into doubles to get more accurate starting positions
         // We get a start position relative to the number of period spaces there are in a day
-        const auto start = ((startDT.time().hour() * 1.0) * (60.0 / mPeriodLength)) + ((startDT.time().minute() * 1.0) / mPeriodLength);
+        const auto start = (startMinutesFromDayStart * 1.0) / mPeriodLength;
+        const int minutesToEnd = (occurrence.endDay - rowDay) * 24 * 60 + occurrence.endMinute - startMinutesFromDayStart;
         auto duration = // Give a minimum acceptable height or otherwise have unclickable incidence
-            qMax(getDuration(startDT, idx.data(IncidenceOccurrenceModel::EndTime).toDateTime().toTimeZone(QTimeZone::systemTimeZone()), mPeriodLength), 1.0);
+            qMax((minutesToEnd * 1.0) / mPeriodLength, 1.0);
 
         // Make sure incidence doesn't extend past the end of the day
         if (start + duration > periodsPerDay) {
             duration = periodsPerDay - start;
         }
 
-        const auto realEndMinutesFromDayStart = qMin((endDT.time().hour() * 60) + endDT.time().minute(), 24 * 60 * 60);
-        // Todos likely won't have end date
-        const auto startMinutesFromDayStart =
-            startDT.isValid() ? (startDT.time().hour() * 60) + startDT.time().minute() : qMax(realEndMinutesFromDayStart - mPeriodLength, 0);
         const auto displayedEndMinutesFromDayStart = floor(startMinutesFromDayStart + (mPeriodLength * duration));
 
         addToResults(idx, start, duration);
+        startMinutes.append(startMinutesFromDayStart);
         setTakenSpaces(startMinutesFromDayStart, displayedEndMinutesFromDayStart);
     }
 
@@ -199,7 +167,7 @@ QVariantList HourlyIncidenceModel::layoutLines(const QDateTime &rowStart) const
     // the left of them. Rather than loop more than once over our incidences, we create a record of these and then deal with them
     // later, storing the needed data in a struct.
     struct PotentialMover {
-        QVariantMap incidenceMap;
+        OccurrenceRecord incidenceRecord;
         int resultIterator;
         int startMinutesFromDayStart;
         int endMinutesFromDayStart;
@@ -208,25 +176,11 @@ QVariantList HourlyIncidenceModel::layoutLines(const QDateTime &rowStart) const
 
     // Calculate the width and x position of each incidence rectangle
     for (int i = 0; i < result.length(); i++) {
-        auto incidence = result[i].value<QVariantMap>();
+        auto incidence = result[i].value<OccurrenceRecord>();
         int concurrentIncidences = 1;
 
-        const auto startDT = incidence[QLatin1String("startTime")].toDateTime().toTimeZone(QTimeZone::systemTimeZone()) > rowStart
-            ? incidence[QLatin1String("startTime")].toDateTime().toTimeZone(QTimeZone::systemTimeZone())
-            : rowStart;
-        const auto endDT = incidence[QLatin1String("endTime")].toDateTime().toTimeZone(QTimeZone::systemTimeZone()) < rowEnd
-            ? incidence[QLatin1String("endTime")].toDateTime().toTimeZone(QTimeZone::systemTimeZone())
-            : rowEnd;
-        const auto duration = incidence[QLatin1String("duration")].toDouble();
-
-        // We need a "real" and "displayed" end time for two reasons:
-        // 1. We need the real end minutes to give a fake start time to todos which do not have a start time
-        // 2. We need the displayed end minutes to be able to properly position those incidences which are displayed as longer
-        // than they actually are
-        const auto realEndMinutesFromDayStart = qMin((endDT.time().hour() * 60) + endDT.time().minute(), 24 * 60 * 60);
-        // Todos likely won't have end date
-        const auto startMinutesFromDayStart =
-            startDT.isValid() ? (startDT.time().hour() * 60) + startDT.time().minute() : qMax(realEndMinutesFromDayStart - mPeriodLength, 0);
+        const auto duration = incidence.duration();
+        const int startMinutesFromDayStart = startMinutes[i];
         const int displayedEndMinutesFromDayStart = floor(startMinutesFromDayStart + (mPeriodLength * duration));
 
         // Get max number of incidences that happen at the same time as this
@@ -235,9 +189,9 @@ QVariantList HourlyIncidenceModel::layoutLines(const QDateTime &rowStart) const
             concurrentIncidences = qMax(concurrentIncidences, takenSpaces[i]);
         }
 
-        incidence[QLatin1String("maxConcurrentIncidences")] = concurrentIncidences;
+        incidence.setMaxConcurrentIncidences(concurrentIncidences);
         double widthShare = 1.0 / (concurrentIncidences * 1.0); // Width as a fraction of the whole day column width
-        incidence[QLatin1String("widthShare")] = widthShare;
+        incidence.setWidthShare(widthShare);
 
         // This is the value that the QML view will use to position the incidence rectangle on the day column's X axis.
         double priorTakenWidthShare = 0.0;
@@ -271,13 +225,13 @@ QVariantList HourlyIncidenceModel::layoutLines(const QDateTime &rowStart) const
             }
         }
 
-        incidence[QLatin1String("priorTakenWidthShare")] = priorTakenWidthShare;
+        incidence.setPriorTakenWidthShare(priorTakenWidthShare);
 
         if (takenSpaces[startMinutesFromDayStart] < takenSpaces[displayedEndMinutesFromDayStart - 1] && priorTakenWidthShare > 0) {
             potentialMovers.append(PotentialMover{incidence, i, startMinutesFromDayStart, displayedEndMinutesFromDayStart});
         }
 
-        result[i] = incidence;
+        result[i] = QVariant::fromValue(incidence);
     }
 
     for (auto &potentialMover : potentialMovers) {
@@ -287,10 +241,10 @@ QVariantList HourlyIncidenceModel::layoutLines(const QDateTime &rowStart) const
         }
 
         if (maxTakenWidth < 0.98) {
-            potentialMover.incidenceMap[QLatin1String("priorTakenWidthShare")] =
-                potentialMover.incidenceMap[QLatin1String("widthShare")].toDouble() * (takenSpaces[potentialMover.endMinutesFromDayStart - 1] - 1);
+            potentialMover.incidenceRecord.setPriorTakenWidthShare(potentialMover.incidenceRecord.widthShare()
+                                                                   * (takenSpaces[potentialMover.endMinutesFromDayStart - 1] - 1));
 
-            result[potentialMover.resultIterator] = potentialMover.incidenceMap;
+            result[potentialMover.resultIterator] = QVariant::fromValue(potentialMover.incidenceRecord);
         }
     }
 
@@ -78,7 +78,7 @@ private Q_SLOTS:
     void scheduleReset();
 
 private:
-    QList<QModelIndex> sortedIncidencesFromSourceModel(const QDateTime &rowStart) const;
+    QList<QModelIndex> sortedIncidencesFromSourceModel(int rowDay) const;
     QVariantList layoutLines(const QDateTime &rowStart) const;
 
     QTimer mRefreshTimer;
@@ -9,14 +9,16 @@
 #include "kalendar_calendar_debug.h"
 
 #include "../filter.h"
+#include "../occurrenceexpander.h"
 #include "../utils.h"
+#include "occurrencerecord.h"
 #include <Akonadi/CollectionColorAttribute>
 #include <Akonadi/EntityTreeModel>
-#include <KCalendarCore/OccurrenceIterator>
 #include <KConfigGroup>
 #include <KLocalizedString>
 #include <KSharedConfig>
 #include <QMetaEnum>
+#include <limits>
 
 IncidenceOccurrenceModel::IncidenceOccurrenceModel(QObject *parent)
     : QAbstractListModel(parent)
@@ -128,8 +130,7 @@ void IncidenceOccurrenceModel::resetFromSource()
 
     setLoading(true);
 
-    if (m_resetThrottlingTimer.isActive() || m_coreCalendar->isLoading()) {
-        // If calendar is still loading then just schedule a refresh later
+    if (m_resetThrottlingTimer.isActive()) {
         // If refresh timer already active this won't restart it
         scheduleReset();
         return;
@@ -140,9 +141,30 @@ void IncidenceOccurrenceModel::resetFromSource()
     beginResetModel();
 
     m_incidences.clear();
+    m_records.clear();
+    m_tagCache.clear();
+    // A day of margin for the occurrences overlapping the period, the others go through the time zone
+    m_timeZoneCache = TimeZoneCache(QTimeZone::systemTimeZone(), mStart.addDays(-1).startOfDay(), mEnd.addDays(2).startOfDay());
+
+    // Only show the collections which are complete, the others are appended once they are
+    m_loadedCollections.clear();
+    collectPopulatedCollections(m_coreCalendar->checkableProxyModel(), {});
+
+    if (!m_loadedCollections.isEmpty()) {
+        OccurrenceExpander occurrenceIterator(*m_coreCalendar, QDateTime(mStart, {0, 0, 0}), QDateTime(mEnd, {12, 59, 59}));
+        appendOccurrences(occurrenceIterator, m_incidences, m_loadedCollections);
+    }
+    m_records.resize(m_incidences.count());
+
+    endResetModel();
 
-    KCalendarCore::OccurrenceIterator occurrenceIterator(*m_coreCalendar, QDateTime(mStart, {0, 0, 0}), QDateTime(mEnd, {12, 59, 59}));
+    setLoading(m_coreCalendar->isLoading());
+}
 
+void IncidenceOccurrenceModel::appendOccurrences(OccurrenceExpander &occurrenceIterator,
+                                                 QVector<Occurrence> &occurrences,
+                                                 const QSet<Akonadi::Collection::Id> &collections)
+{
     while (occurrenceIterator.hasNext()) {
         occurrenceIterator.next();
         const auto incidence = occurrenceIterator.incidence();
@@ -151,25 +173,100 @@ void IncidenceOccurrenceModel::resetFromSource()
             continue;
         }
 
+        const auto collectionId = getCollectionId(incidence);
+        if (!collections.contains(collectionId)) {
+            continue;
+        }
+
         const auto occurrenceStartEnd = incidenceOccurrenceStartEnd(occurrenceIterator.occurrenceStartDate(), incidence);
         const auto start = occurrenceStartEnd.first;
         const auto end = occurrenceStartEnd.second;
 
-        const Occurrence occurrence{
+        Occurrence occurrence{
             start,
             end,
             incidence,
             getColor(incidence),
-            getCollectionId(incidence),
+            collectionId,
             incidence->allDay(),
         };
 
-        m_incidences.append(occurrence);
+        constexpr int invalidDay = std::numeric_limits<int>::min();
+        if (!start.isValid()) {
+            occurrence.startDay = invalidDay;
+        } else if (occurrence.allDay) {
+            // All day incidences are on the same dates in every time zone
+            occurrence.startDay = int(TimeZoneCache::dayOf(start.date()));
+            occurrence.startMinute = start.time().msecsSinceStartOfDay() / 60000;
+        } else {
+            const qint64 startSecs = start.toSecsSinceEpoch();
+            occurrence.startDay = int(m_timeZoneCache.localDay(startSecs));
+            occurrence.startMinute = m_timeZoneCache.localMinuteOfDay(startSecs);
+        }
+        if (!end.isValid()) {
+            occurrence.endDay = invalidDay;
+        } else if (occurrence.allDay) {
+            occurrence.endDay = int(TimeZoneCache::dayOf(end.date()));
+            occurrence.endMinute = end.time().msecsSinceStartOfDay() / 60000;
+        } else {
+            const qint64 endSecs = end.toSecsSinceEpoch();
+            occurrence.endDay = int(m_timeZoneCache.localDay(endSecs));
+            occurrence.endMinute = m_timeZoneCache.localMinuteOfDay(endSecs);
+        }
+
+        occurrences.append(occurrence);
     }
+}
 
-    endResetModel();
+void IncidenceOccurrenceModel::collectPopulatedCollections(const QAbstractItemModel *model, const QModelIndex &parent)
+{
+    const auto etm = m_coreCalendar->entityTreeModel();
+    for (int row = 0, count = model->rowCount(parent); row < count; ++row) {
+        const auto index = model->index(row, 0, parent);
+        const auto collectionId = index.data(Akonadi::EntityTreeModel::CollectionIdRole).toLongLong();
+        if (etm->isCollectionPopulated(collectionId)) {
+            m_loadedCollections.insert(collectionId);
+        }
+        collectPopulatedCollections(model, index);
+    }
+}
 
-    setLoading(false);
+void IncidenceOccurrenceModel::itemsChanged(const QModelIndex &parent, int first, int last)
+{
+    // Items of the collections still loading are appended once they are complete
+    const auto model = m_coreCalendar->model();
+    for (int row = first; row <= last; ++row) {
+        const auto collection = model->index(row, 0, parent).data(Akonadi::EntityTreeModel::ParentCollectionRole).value<Akonadi::Collection>();
+        if (m_loadedCollections.contains(collection.id())) {
+            scheduleReset();
+            return;
+        }
+    }
+}
+
+void IncidenceOccurrenceModel::collectionPopulated(Akonadi::Collection::Id collectionId)
+{
+    if (m_resetThrottlingTimer.isActive() || m_loadedCollections.contains(collectionId)) {
+        // The pending reset covers it
+        return;
+    }
+
+    loadColors();
+    m_loadedCollections.insert(collectionId);
+
+    // The calendar picks the incidences of the period, only those of the collection are kept
+    QVector<Occurrence> occurrences;
+    OccurrenceExpander occurrenceIterator(*m_coreCalendar, QDateTime(mStart, {0, 0, 0}), QDateTime(mEnd, {12, 59, 59}));
+    appendOccurrences(occurrenceIterator, occurrences, {collectionId});
+
+    if (!occurrences.isEmpty()) {
+        beginInsertRows({}, m_incidences.count(), m_incidences.count() + occurrences.count() - 1);
+        m_incidences += occurrences;
+        m_records.resize(m_incidences.count());
+        endInsertRows();
+    }
+
+    setLoading(m_coreCalendar->isLoading());
 }
 
 int IncidenceOccurrenceModel::rowCount(const QModelIndex &parent) const
@@ -180,6 +277,11 @@ int IncidenceOccurrenceModel::rowCount(const QModelIndex &parent) const
     return m_incidences.size();
 }
 
+const IncidenceOccurrenceModel::Occurrence &IncidenceOccurrenceModel::occurrence(int row) const
+{
+    return m_incidences.at(row);
+}
+
 qint64 IncidenceOccurrenceModel::getCollectionId(const KCalendarCore::Incidence::Ptr &incidence)
 {
     auto item = m_coreCalendar->item(incidence);
@@ -230,8 +332,8 @@ QVariant IncidenceOccurrenceModel::data(const QModelIndex &idx, int role) const
 {
     Q_ASSERT(hasIndex(idx.row(), idx.column()));
 
-    const auto occurrence = m_incidences.at(idx.row());
-    const auto incidence = occurrence.incidence;
+    const auto &occurrence = m_incidences.at(idx.row());
+    const auto &incidence = occurrence.incidence;
 
     switch (role) {
     case Qt::DisplayRole:
@@ -293,10 +395,8 @@ QVariant IncidenceOccurrenceModel::data(const QModelIndex &idx, int role) const
         auto todo = incidence.staticCast<KCalendarCore::Todo>();
         return todo->isOverdue();
     }
-    case IsReadOnly: {
-        const auto collection = m_coreCalendar->collection(occurrence.collectionId);
-        return collection.rights().testFlag(Akonadi::Collection::ReadOnly);
-    }
+    case IsReadOnly:
+        return isReadOnly(occurrence.collectionId);
     case IncidenceId:
         return incidence->uid();
     case IncidenceType:
@@ -309,11 +409,31 @@ QVariant IncidenceOccurrenceModel::data(const QModelIndex &idx, int role) const
         return QVariant::fromValue(incidence);
     case IncidenceOccurrence:
         return QVariant::fromValue(occurrence);
+    case Record: {
+        auto &record = m_records[idx.row()];
+        if (!record.isValid()) {
+            record = QVariant::fromValue(OccurrenceRecord(occurrence, isReadOnly(occurrence.collectionId), m_format));
+        }
+        return record;
+    }
     default:
         return {};
     }
 }
 
+QHash<int, QByteArray> IncidenceOccurrenceModel::roleNames() const
+{
+    auto roles = QAbstractListModel::roleNames();
+    roles.insert(Record, QByteArrayLiteral("record"));
+    return roles;
+}
+
+bool IncidenceOccurrenceModel::isReadOnly(qint64 collectionId) const
+{
+    const auto collection = m_coreCalendar->collection(collectionId);
+    return collection.rights().testFlag(Akonadi::Collection::ReadOnly);
+}
+
 void IncidenceOccurrenceModel::setCalendar(Akonadi::ETMCalendar::Ptr calendar)
 {
     if (m_coreCalendar == calendar) {
@@ -321,13 +441,16 @@ void IncidenceOccurrenceModel::setCalendar(Akonadi::ETMCalendar::Ptr calendar)
     }
     m_coreCalendar = calendar;
 
-    connect(m_coreCalendar->model(), &QAbstractItemModel::dataChanged, this, &IncidenceOccurrenceModel::scheduleReset);
-    connect(m_coreCalendar->model(), &QAbstractItemModel::rowsInserted, this, &IncidenceOccurrenceModel::scheduleReset);
+    connect(m_coreCalendar->model(), &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        itemsChanged(topLeft.parent(), topLeft.row(), bottomRight.row());
+    });
+    connect(m_coreCalendar->model(), &QAbstractItemModel::rowsInserted, this, &IncidenceOccurrenceModel::itemsChanged);
     connect(m_coreCalendar->model(), &QAbstractItemModel::rowsRemoved, this, &IncidenceOccurrenceModel::scheduleReset);
     connect(m_coreCalendar->model(), &QAbstractItemModel::layoutChanged, this, &IncidenceOccurrenceModel::scheduleReset);
     connect(m_coreCalendar->model(), &QAbstractItemModel::modelReset, this, &IncidenceOccurrenceModel::scheduleReset);
     connect(m_coreCalendar->model(), &QAbstractItemModel::rowsMoved, this, &IncidenceOccurrenceModel::scheduleReset);
     connect(m_coreCalendar.get(), &Akonadi::ETMCalendar::collectionsRemoved, this, &IncidenceOccurrenceModel::scheduleReset);
+    connect(m_coreCalendar->entityTreeModel(), &Akonadi::EntityTreeModel::collectionPopulated, this, &IncidenceOccurrenceModel::collectionPopulated);
 
     Q_EMIT calendarChanged();
 
@@ -370,12 +493,9 @@ std::pair<QDateTime, QDateTime> IncidenceOccurrenceModel::incidenceOccurrenceSta
 
 bool IncidenceOccurrenceModel::incidencePassesFilter(const KCalendarCore::Incidence::Ptr &incidence)
 {
-    if (!mFilter || mFilter->tags().empty()) {
+    if (!mFilter || mFilter->tagIds().isEmpty()) {
         return true;
     }
 
-    const auto tags = mFilter->tags();
-    return std::any_of(tags.cbegin(), tags.cend(), [&incidence](const QString &tag) {
-        return incidence->categories().contains(tag);
-    });
+    return TagRegistry::intersects(m_tagCache.tags(*incidence), mFilter->tagIds());
 }
@@ -16,10 +16,15 @@
 #include <QColor>
 #include <QDateTime>
 #include <QList>
+#include <QSet>
 #include <QSharedPointer>
 #include <QTimer>
 
+#include "../timezonecache.h"
+#include <tagregistry.h>
+
 class Filter;
+class OccurrenceExpander;
 namespace KCalendarCore
 {
 class Incidence;
@@ -34,7 +39,10 @@ using namespace KCalendarCore;
 /**
  * Loads all event occurrences within the given period and matching the given filter.
  *
- * Recurrences are expanded
+ * Recurrences are expanded, see OccurrenceExpander
+ *
+ * While the calendar loads, the occurrences of the collections which finished loading are
+ * shown, and those of the other collections are appended as they finish.
  */
 class IncidenceOccurrenceModel : public QAbstractListModel
 {
@@ -70,6 +78,7 @@ public:
         IncidenceTypeIcon,
         IncidencePtr,
         IncidenceOccurrence,
+        Record, ///< All of the above in an OccurrenceRecord, computed once per occurrence
         LastRole
     };
     Q_ENUM(Roles)
@@ -78,6 +87,7 @@ public:
 
     int rowCount(const QModelIndex &parent = {}) const override;
     QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
 
     Akonadi::ETMCalendar::Ptr calendar() const;
     QDate start() const;
@@ -93,8 +103,19 @@ public:
         QColor color;
         qint64 collectionId;
         bool allDay;
+
+        // Precomputed in the system time zone, so that the views never convert times while laying
+        // out: days since 1970-01-01 (see TimeZoneCache::localDay()), and minutes since the start
+        // of the day. Days are std::numeric_limits<int>::min() for invalid times.
+        int startDay = 0;
+        int endDay = 0;
+        int startMinute = 0;
+        int endMinute = 0;
     };
 
+    /// The occurrence at @p row, without going through a QVariant
+    const Occurrence &occurrence(int row) const;
+
 Q_SIGNALS:
     void startChanged();
     void lengthChanged();
@@ -114,14 +135,22 @@ private Q_SLOTS:
     void loadColors();
     void scheduleReset();
     void resetFromSource();
+    void itemsChanged(const QModelIndex &parent, int first, int last);
+    void collectionPopulated(Akonadi::Collection::Id collectionId);
     void setLoading(const bool loading);
 
 private:
     static std::pair<QDateTime, QDateTime> incidenceOccurrenceStartEnd(const QDateTime &ocStart, const KCalendarCore::Incidence::Ptr &incidence);
     bool incidencePassesFilter(const KCalendarCore::Incidence::Ptr &incidence);
+    /// Appends the occurrences from @p occurrenceIterator of the incidences in @p collections
+    void appendOccurrences(OccurrenceExpander &occurrenceIterator,
+                           QVector<Occurrence> &occurrences,
+                           const QSet<Akonadi::Collection::Id> &collections);
+    void collectPopulatedCollections(const QAbstractItemModel *model, const QModelIndex &parent);
 
     QColor getColor(const KCalendarCore::Incidence::Ptr &incidence);
     qint64 getCollectionId(const KCalendarCore::Incidence::Ptr &incidence);
+    bool isReadOnly(qint64 collectionId) const;
 
     QSharedPointer<QAbstractItemModel> mSourceModel;
     QDate mStart;
@@ -133,10 +162,18 @@ private:
     int m_resetThrottleInterval = 100;
 
     bool m_loading = false;
+    // The fully loaded collections, whose occurrences are in m_incidences
+    QSet<Akonadi::Collection::Id> m_loadedCollections;
     QVector<Occurrence> m_incidences; // We need incidences to be in a preditable order for the model
+    // The OccurrenceRecord of each of m_incidences, once asked for
+    mutable QVector<QVariant> m_records;
+    // The offsets of the system time zone around the loaded period
+    TimeZoneCache m_timeZoneCache;
     QHash<Akonadi::Collection::Id, QColor> m_colors;
     KConfigWatcher::Ptr m_colorWatcher;
     Filter *mFilter = nullptr;
+    // The tags of the incidences, to filter them without looking their categories up again
+    IncidenceTagCache m_tagCache;
     KFormat m_format;
 };
 
@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include "incidencesearchmodel.h"
+
+IncidenceSearchModel::IncidenceSearchModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    m_resetThrottlingTimer.setSingleShot(true);
+    connect(&m_resetThrottlingTimer, &QTimer::timeout, this, &IncidenceSearchModel::resetFromIndex);
+}
+
+IncidenceSearchIndex *IncidenceSearchModel::searchIndex()
+{
+    if (!m_index) {
+        setSearchIndex(IncidenceSearchIndex::instance());
+    }
+    return m_index;
+}
+
+void IncidenceSearchModel::setSearchIndex(IncidenceSearchIndex *index)
+{
+    if (m_index == index) {
+        return;
+    }
+    if (m_index) {
+        disconnect(m_index, nullptr, this, nullptr);
+    }
+    m_index = index;
+    if (m_index) {
+        connect(m_index, &IncidenceSearchIndex::changed, this, &IncidenceSearchModel::scheduleReset);
+        if (m_calendar) {
+            m_index->setCalendar(m_calendar);
+        }
+    }
+    scheduleReset();
+}
+
+Akonadi::ETMCalendar::Ptr IncidenceSearchModel::calendar() const
+{
+    return m_calendar;
+}
+
+void IncidenceSearchModel::setCalendar(Akonadi::ETMCalendar::Ptr calendar)
+{
+    if (m_calendar == calendar) {
+        return;
+    }
+    m_calendar = calendar;
+    searchIndex()->setCalendar(m_calendar);
+    Q_EMIT calendarChanged();
+    scheduleReset();
+}
+
+QString IncidenceSearchModel::searchText() const
+{
+    return m_searchText;
+}
+
+void IncidenceSearchModel::setSearchText(const QString &searchText)
+{
+    if (m_searchText == searchText) {
+        return;
+    }
+    m_searchText = searchText;
+    Q_EMIT searchTextChanged();
+    // Typing is answered right away, only index changes are throttled
+    resetFromIndex();
+}
+
+QDateTime IncidenceSearchModel::from() const
+{
+    return m_from;
+}
+
+void IncidenceSearchModel::setFrom(const QDateTime &from)
+{
+    if (m_from == from) {
+        return;
+    }
+    m_from = from;
+    Q_EMIT fromChanged();
+    scheduleReset();
+}
+
+QDateTime IncidenceSearchModel::to() const
+{
+    return m_to;
+}
+
+void IncidenceSearchModel::setTo(const QDateTime &to)
+{
+    if (m_to == to) {
+        return;
+    }
+    m_to = to;
+    Q_EMIT toChanged();
+    scheduleReset();
+}
+
+int IncidenceSearchModel::limit() const
+{
+    return m_limit;
+}
+
+void IncidenceSearchModel::setLimit(int limit)
+{
+    if (m_limit == limit) {
+        return;
+    }
+    m_limit = limit;
+    Q_EMIT limitChanged();
+    scheduleReset();
+}
+
+int IncidenceSearchModel::resetThrottleInterval() const
+{
+    return m_resetThrottleInterval;
+}
+
+void IncidenceSearchModel::setResetThrottleInterval(int resetThrottleInterval)
+{
+    if (m_resetThrottleInterval == resetThrottleInterval) {
+        return;
+    }
+    m_resetThrottleInterval = resetThrottleInterval;
+    Q_EMIT resetThrottleIntervalChanged();
+}
+
+void IncidenceSearchModel::scheduleReset()
+{
+    if (!m_resetThrottlingTimer.isActive()) {
+        m_resetThrottlingTimer.start(m_resetThrottleInterval);
+    }
+}
+
+void IncidenceSearchModel::resetFromIndex()
+{
+    m_resetThrottlingTimer.stop();
+
+    beginResetModel();
+    m_results = searchIndex()->search(m_searchText, m_from, m_to, m_limit);
+    endResetModel();
+}
+
+int IncidenceSearchModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_results.count();
+}
+
+QVariant IncidenceSearchModel::data(const QModelIndex &index, int role) const
+{
+    Q_ASSERT(checkIndex(index, QAbstractItemModel::CheckIndexOption::IndexIsValid));
+
+    const auto &result = m_results.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case Summary:
+        return result.summary;
+    case StartTime:
+        return result.start;
+    case EndTime:
+        return result.end;
+    case Score:
+        return result.score;
+    case IncidenceId:
+    case IncidencePtr: {
+        // Null until the calendar loaded it, the results of the stored index come first
+        KCalendarCore::Incidence::Ptr incidence;
+        if (m_calendar) {
+            // The same incidence can be in several collections, the item tells which one matched
+            const auto item = m_calendar->item(result.itemId);
+            incidence = item.hasPayload<KCalendarCore::Incidence::Ptr>() ? item.payload<KCalendarCore::Incidence::Ptr>()
+                                                                          : m_calendar->instance(result.instanceIdentifier);
+        }
+        if (role == IncidenceId) {
+            return incidence ? incidence->uid() : QString();
+        }
+        return QVariant::fromValue(incidence);
+    }
+    default:
+        return {};
+    }
+}
+
+QHash<int, QByteArray> IncidenceSearchModel::roleNames() const
+{
+    return {
+        {Summary, QByteArrayLiteral("summary")},
+        {StartTime, QByteArrayLiteral("startTime")},
+        {EndTime, QByteArrayLiteral("endTime")},
+        {Score, QByteArrayLiteral("score")},
+        {IncidenceId, QByteArrayLiteral("incidenceId")},
+        {IncidencePtr, QByteArrayLiteral("incidencePtr")},
+    };
+}
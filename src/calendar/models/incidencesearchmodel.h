@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#pragma once
+
+#include "../incidencesearchindex.h"
+#include <Akonadi/ETMCalendar>
+#include <QAbstractListModel>
+#include <QDateTime>
+#include <QPointer>
+#include <QTimer>
+
+/**
+ * The incidences matching searchText in the IncidenceSearchIndex, best matches first.
+ *
+ * The results are updated with the index, at most every resetThrottleInterval.
+ */
+class IncidenceSearchModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(Akonadi::ETMCalendar::Ptr calendar READ calendar WRITE setCalendar NOTIFY calendarChanged)
+    Q_PROPERTY(QString searchText READ searchText WRITE setSearchText NOTIFY searchTextChanged)
+    /// Only incidences occurring between from and to if they are valid
+    Q_PROPERTY(QDateTime from READ from WRITE setFrom NOTIFY fromChanged)
+    Q_PROPERTY(QDateTime to READ to WRITE setTo NOTIFY toChanged)
+    Q_PROPERTY(int limit READ limit WRITE setLimit NOTIFY limitChanged)
+    Q_PROPERTY(int resetThrottleInterval READ resetThrottleInterval WRITE setResetThrottleInterval NOTIFY resetThrottleIntervalChanged)
+
+public:
+    enum Roles {
+        Summary = Qt::UserRole + 1,
+        StartTime,
+        EndTime,
+        Score,
+        IncidenceId,
+        IncidencePtr,
+    };
+    Q_ENUM(Roles)
+    explicit IncidenceSearchModel(QObject *parent = nullptr);
+    ~IncidenceSearchModel() override = default;
+
+    int rowCount(const QModelIndex &parent = {}) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    Akonadi::ETMCalendar::Ptr calendar() const;
+    void setCalendar(Akonadi::ETMCalendar::Ptr calendar);
+    QString searchText() const;
+    void setSearchText(const QString &searchText);
+    QDateTime from() const;
+    void setFrom(const QDateTime &from);
+    QDateTime to() const;
+    void setTo(const QDateTime &to);
+    int limit() const;
+    void setLimit(int limit);
+    int resetThrottleInterval() const;
+    void setResetThrottleInterval(int resetThrottleInterval);
+
+    /// The index to search, IncidenceSearchIndex::instance() by default
+    void setSearchIndex(IncidenceSearchIndex *index);
+
+Q_SIGNALS:
+    void calendarChanged();
+    void searchTextChanged();
+    void fromChanged();
+    void toChanged();
+    void limitChanged();
+    void resetThrottleIntervalChanged();
+
+private:
+    void scheduleReset();
+    void resetFromIndex();
+    IncidenceSearchIndex *searchIndex();
+
+    Akonadi::ETMCalendar::Ptr m_calendar;
+    QPointer<IncidenceSearchIndex> m_index;
+    QString m_searchText;
+    QDateTime m_from;
+    QDateTime m_to;
+    int m_limit = 200;
+    QTimer m_resetThrottlingTimer;
+    int m_resetThrottleInterval = 100;
+    QVector<IncidenceSearchIndex::Result> m_results;
+};
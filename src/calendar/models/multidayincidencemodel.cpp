@@ -6,7 +6,11 @@
 // SPDX-License-Identifier: LGPL-2.0-or-later
 
 #include "multidayincidencemodel.h"
+#include "../timezonecache.h"
+#include "occurrencerecord.h"
 #include <QBitArray>
+#include <limits>
+#include <tuple>
 
 using namespace std::chrono_literals;
 
@@ -48,27 +52,28 @@ int MultiDayIncidenceModel::rowCount(const QModelIndex &parent) const
     return qMax(mSourceModel->length() / mPeriodLength, 1);
 }
 
-static long long getDuration(const QDate &start, const QDate &end)
+// Days as in TimeZoneCache::localDay()
+static long long getDuration(long long startDay, long long endDay)
 {
-    return qMax(start.daysTo(end) + 1, 1ll);
+    return qMax(endDay - startDay + 1, 1ll);
 }
 
 // We first sort all occurrences so we get all-day first (sorted by duration),
 // and then the rest sorted by start-date.
 QList<QModelIndex> MultiDayIncidenceModel::sortedIncidencesFromSourceModel(const QDate &rowStart) const
 {
+    const int rowDay = int(TimeZoneCache::dayOf(rowStart));
     // Don't add days if we are going for a daily period
-    const auto rowEnd = rowStart.addDays(mPeriodLength > 1 ? mPeriodLength : 0);
+    const int rowEndDay = rowDay + (mPeriodLength > 1 ? mPeriodLength : 0);
     QList<QModelIndex> sorted;
     sorted.reserve(mSourceModel->rowCount());
     // Get incidences from source model
     for (int row = 0; row < mSourceModel->rowCount(); row++) {
         const auto srcIdx = mSourceModel->index(row, 0, {});
-        const auto start = srcIdx.data(IncidenceOccurrenceModel::StartTime).toDateTime().date();
-        const auto end = srcIdx.data(IncidenceOccurrenceModel::EndTime).toDateTime().date();
+        const auto &occurrence = mSourceModel->occurrence(row);
 
         // Skip incidences not part of the week
-        if (end < rowStart || start > rowEnd) {
+        if (occurrence.endDay < rowDay || occurrence.startDay > rowEndDay) {
             // qCWarning(KALENDAR_CALENDAR_LOG) << "Skipping because not part of this week";
             continue;
         }
@@ -84,17 +89,18 @@ QList<QModelIndex> MultiDayIncidenceModel::sortedIncidencesFromSourceModel(const
 
     // Sort incidences by date
     std::sort(sorted.begin(), sorted.end(), [&](const QModelIndex &left, const QModelIndex &right) {
+        const auto &leftOccurrence = mSourceModel->occurrence(left.row());
+        const auto &rightOccurrence = mSourceModel->occurrence(right.row());
+
         // All-day first, sorted by duration (in the hope that we can fit multiple on the same line)
-        const auto leftAllDay = left.data(IncidenceOccurrenceModel::AllDay).toBool();
-        const auto rightAllDay = right.data(IncidenceOccurrenceModel::AllDay).toBool();
+        const auto leftAllDay = leftOccurrence.allDay;
+        const auto rightAllDay = rightOccurrence.allDay;
 
-        const auto leftDuration =
-            getDuration(left.data(IncidenceOccurrenceModel::StartTime).toDateTime().date(), left.data(IncidenceOccurrenceModel::EndTime).toDateTime().date());
-        const auto rightDuration =
-            getDuration(right.data(IncidenceOccurrenceModel::StartTime).toDateTime().date(), right.data(IncidenceOccurrenceModel::EndTime).toDateTime().date());
+        const auto leftDuration = getDuration(leftOccurrence.startDay, leftOccurrence.endDay);
+        const auto rightDuration = getDuration(rightOccurrence.startDay, rightOccurrence.endDay);
 
-        const auto leftDt = left.data(IncidenceOccurrenceModel::StartTime).toDateTime();
-        const auto rightDt = right.data(IncidenceOccurrenceModel::StartTime).toDateTime();
+        const auto leftDt = std::tie(leftOccurrence.startDay, leftOccurrence.startMinute);
+        const auto rightDt = std::tie(rightOccurrence.startDay, rightOccurrence.startMinute);
 
         if (leftAllDay && !rightAllDay) {
             return true;
@@ -121,11 +127,15 @@ QList<QModelIndex> MultiDayIncidenceModel::sortedIncidencesFromSourceModel(const
  *
  * We never mix all-day and non-all day, and otherwise try to fit as much as possible
  * on the same line. Same day time-order should be preserved because of the sorting.
+ *
+ * Days come precomputed in the local time zone with the occurrences, so nothing here
+ * needs to convert between time zones.
  */
 QVariantList MultiDayIncidenceModel::layoutLines(const QDate &rowStart) const
 {
-    auto getStart = [&rowStart](const QDate &start) {
-        return qMax(rowStart.daysTo(start), 0ll);
+    const long long rowDay = TimeZoneCache::dayOf(rowStart);
+    auto getStart = [rowDay](long long startDay) {
+        return qMax(startDay - rowDay, 0ll);
     };
 
     QList<QModelIndex> sorted = sortedIncidencesFromSourceModel(rowStart);
@@ -139,42 +149,20 @@ QVariantList MultiDayIncidenceModel::layoutLines(const QDate &rowStart) const
     QVariantList result;
     while (!sorted.isEmpty()) {
         const auto srcIdx = sorted.takeFirst();
-        const auto startDate = srcIdx.data(IncidenceOccurrenceModel::StartTime).toDateTime().date() < rowStart
-            ? rowStart
-            : srcIdx.data(IncidenceOccurrenceModel::StartTime).toDateTime().date();
-        const auto start = getStart(srcIdx.data(IncidenceOccurrenceModel::StartTime).toDateTime().date());
-        const auto duration = qMin(getDuration(startDate, srcIdx.data(IncidenceOccurrenceModel::EndTime).toDateTime().date()), mPeriodLength - start);
+        const auto &occurrence = mSourceModel->occurrence(srcIdx.row());
+        const auto startDay = qMax<long long>(occurrence.startDay, rowDay);
+        const auto start = getStart(occurrence.startDay);
+        const auto duration = qMin(getDuration(startDay, occurrence.endDay), mPeriodLength - start);
 
         // qCWarning(KALENDAR_CALENDAR_LOG) << "First of line " << srcIdx.data(IncidenceOccurrenceModel::StartTime).toDateTime() << duration <<
         // srcIdx.data(IncidenceOccurrenceModel::Summary).toString();
         QVariantList currentLine;
 
         auto addToLine = [&currentLine](const QModelIndex &idx, int start, int duration) {
-            currentLine.append(QVariantMap{
-                {QStringLiteral("text"), idx.data(IncidenceOccurrenceModel::Summary)},
-                {QStringLiteral("description"), idx.data(IncidenceOccurrenceModel::Description)},
-                {QStringLiteral("location"), idx.data(IncidenceOccurrenceModel::Location)},
-                {QStringLiteral("startTime"), idx.data(IncidenceOccurrenceModel::StartTime)},
-                {QStringLiteral("endTime"), idx.data(IncidenceOccurrenceModel::EndTime)},
-                {QStringLiteral("allDay"), idx.data(IncidenceOccurrenceModel::AllDay)},
-                {QStringLiteral("todoCompleted"), idx.data(IncidenceOccurrenceModel::TodoCompleted)},
-                {QStringLiteral("priority"), idx.data(IncidenceOccurrenceModel::Priority)},
-                {QStringLiteral("starts"), start},
-                {QStringLiteral("duration"), duration},
-                {QStringLiteral("durationString"), idx.data(IncidenceOccurrenceModel::DurationString)},
-                {QStringLiteral("recurs"), idx.data(IncidenceOccurrenceModel::Recurs)},
-                {QStringLiteral("hasReminders"), idx.data(IncidenceOccurrenceModel::HasReminders)},
-                {QStringLiteral("isOverdue"), idx.data(IncidenceOccurrenceModel::IsOverdue)},
-                {QStringLiteral("isReadOnly"), idx.data(IncidenceOccurrenceModel::IsReadOnly)},
-                {QStringLiteral("color"), idx.data(IncidenceOccurrenceModel::Color)},
-                {QStringLiteral("collectionId"), idx.data(IncidenceOccurrenceModel::CollectionId)},
-                {QStringLiteral("incidenceId"), idx.data(IncidenceOccurrenceModel::IncidenceId)},
-                {QStringLiteral("incidenceType"), idx.data(IncidenceOccurrenceModel::IncidenceType)},
-                {QStringLiteral("incidenceTypeStr"), idx.data(IncidenceOccurrenceModel::IncidenceTypeStr)},
-                {QStringLiteral("incidenceTypeIcon"), idx.data(IncidenceOccurrenceModel::IncidenceTypeIcon)},
-                {QStringLiteral("incidencePtr"), idx.data(IncidenceOccurrenceModel::IncidencePtr)},
-                {QStringLiteral("incidenceOccurrence"), idx.data(IncidenceOccurrenceModel::IncidenceOccurrence)},
-            });
+            auto record = idx.data(IncidenceOccurrenceModel::Record).value<OccurrenceRecord>();
+            record.setStarts(start);
+            record.setDuration(duration);
+            currentLine.append(QVariant::fromValue(record));
         };
 
         if (start >= mPeriodLength) {
@@ -210,11 +198,10 @@ QVariantList MultiDayIncidenceModel::layoutLines(const QDate &rowStart) const
 
         for (auto it = sorted.begin(); it != sorted.end();) {
             const auto idx = *it;
-            const auto startDate = idx.data(IncidenceOccurrenceModel::StartTime).toDateTime().date() < rowStart
-                ? rowStart
-                : idx.data(IncidenceOccurrenceModel::StartTime).toDateTime().date();
-            const auto start = getStart(idx.data(IncidenceOccurrenceModel::StartTime).toDateTime().date());
-            const auto duration = qMin(getDuration(startDate, idx.data(IncidenceOccurrenceModel::EndTime).toDateTime().date()), mPeriodLength - start);
+            const auto &occurrence = mSourceModel->occurrence(idx.row());
+            const auto startDay = qMax<long long>(occurrence.startDay, rowDay);
+            const auto start = getStart(occurrence.startDay);
+            const auto duration = qMin(getDuration(startDay, occurrence.endDay), mPeriodLength - start);
             const auto end = start + duration;
 
             // This leaves a space in rows with all day events, making this y area of the row exclusively for all day events
@@ -291,12 +278,11 @@ void MultiDayIncidenceModel::slotSourceDataChanged(const QModelIndex &upperLeft,
     QSet<int> rows;
 
     for (int i = upperLeft.row(); i <= bottomRight.row(); ++i) {
-        const auto sourceModelIndex = mSourceModel->index(i, 0, {});
-        const auto occurrence = sourceModelIndex.data(IncidenceOccurrenceModel::IncidenceOccurrence).value<IncidenceOccurrenceModel::Occurrence>();
+        const auto &occurrence = mSourceModel->occurrence(i);
 
-        const auto sourceModelStartDate = mSourceModel->start();
-        const auto startDaysFromSourceStart = sourceModelStartDate.daysTo(occurrence.start.date());
-        const auto endDaysFromSourceStart = sourceModelStartDate.daysTo(occurrence.end.date());
+        const auto sourceModelStartDay = TimeZoneCache::dayOf(mSourceModel->start());
+        const auto startDaysFromSourceStart = occurrence.startDay - sourceModelStartDay;
+        const auto endDaysFromSourceStart = occurrence.endDay - sourceModelStartDay;
 
         const auto firstPeriodOccurrenceAppears = startDaysFromSourceStart / mPeriodLength;
         const auto lastPeriodOccurrenceAppears = endDaysFromSourceStart / mPeriodLength;
@@ -393,13 +379,13 @@ bool MultiDayIncidenceModel::incidencePassesFilter(const QModelIndex &idx) const
         // Start out assuming the worst, filter everything out
         include = false;
 
-        const auto start = idx.data(IncidenceOccurrenceModel::StartTime).toDateTime().date();
+        const auto &occurrence = mSourceModel->occurrence(idx.row());
 
-        if (m_filters.testFlag(AllDayOnly) && idx.data(IncidenceOccurrenceModel::AllDay).toBool()) {
+        if (m_filters.testFlag(AllDayOnly) && occurrence.allDay) {
             include = true;
         }
 
-        if (m_filters.testFlag(NoStartDateOnly) && !start.isValid()) {
+        if (m_filters.testFlag(NoStartDateOnly) && occurrence.startDay == std::numeric_limits<int>::min()) {
             include = true;
         }
 
@@ -408,7 +394,7 @@ bool MultiDayIncidenceModel::incidencePassesFilter(const QModelIndex &idx) const
         }
     }
 
-    const auto incidencePtr = idx.data(IncidenceOccurrenceModel::IncidencePtr).value<KCalendarCore::Incidence::Ptr>();
+    const auto &incidencePtr = mSourceModel->occurrence(idx.row()).incidence;
     const auto incidenceIsTodo = incidencePtr->type() == Incidence::TypeTodo;
     if (!m_showTodos && incidenceIsTodo) {
         include = false;
@@ -424,16 +410,15 @@ int MultiDayIncidenceModel::incidenceCount() const
     int count = 0;
 
     for (int i = 0; i < rowCount(); i++) {
-        const auto rowStart = mSourceModel->start().addDays(i * mPeriodLength);
-        const auto rowEnd = rowStart.addDays(mPeriodLength > 1 ? mPeriodLength : 0);
+        const int rowDay = int(TimeZoneCache::dayOf(mSourceModel->start().addDays(i * mPeriodLength)));
+        const int rowEndDay = rowDay + (mPeriodLength > 1 ? mPeriodLength : 0);
 
         for (int row = 0; row < mSourceModel->rowCount(); row++) {
             const auto srcIdx = mSourceModel->index(row, 0, {});
-            const auto start = srcIdx.data(IncidenceOccurrenceModel::StartTime).toDateTime().date();
-            const auto end = srcIdx.data(IncidenceOccurrenceModel::EndTime).toDateTime().date();
+            const auto &occurrence = mSourceModel->occurrence(row);
 
             // Skip incidences not part of the week
-            if (end < rowStart || start > rowEnd) {
+            if (occurrence.endDay < rowDay || occurrence.startDay > rowEndDay) {
                 // qCWarning(KALENDAR_CALENDAR_LOG) << "Skipping because not part of this week";
                 continue;
             }
@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include "occurrencerecord.h"
+
+#include "../utils.h"
+#include <KCalendarCore/Todo>
+#include <KLocalizedString>
+#include <optional>
+
+struct OccurrenceRecord::Data {
+    IncidenceOccurrenceModel::Occurrence occurrence;
+    bool readOnly = false;
+    KFormat format;
+    // Formatted on first use, as most delegates don't show them
+    std::optional<QString> durationString;
+    std::optional<QString> incidenceTypeStr;
+};
+
+OccurrenceRecord::OccurrenceRecord() = default;
+
+OccurrenceRecord::OccurrenceRecord(const IncidenceOccurrenceModel::Occurrence &occurrence, bool readOnly, const KFormat &format)
+    : d(new Data{occurrence, readOnly, format, {}, {}})
+{
+}
+
+bool OccurrenceRecord::isValid() const
+{
+    return d && d->occurrence.incidence;
+}
+
+QString OccurrenceRecord::text() const
+{
+    return isValid() ? d->occurrence.incidence->summary() : QString();
+}
+
+QString OccurrenceRecord::description() const
+{
+    return isValid() ? d->occurrence.incidence->description() : QString();
+}
+
+QString OccurrenceRecord::location() const
+{
+    return isValid() ? d->occurrence.incidence->location() : QString();
+}
+
+QDateTime OccurrenceRecord::startTime() const
+{
+    return d ? d->occurrence.start : QDateTime();
+}
+
+QDateTime OccurrenceRecord::endTime() const
+{
+    return d ? d->occurrence.end : QDateTime();
+}
+
+bool OccurrenceRecord::allDay() const
+{
+    return d && d->occurrence.allDay;
+}
+
+bool OccurrenceRecord::todoCompleted() const
+{
+    if (!isValid() || d->occurrence.incidence->type() != KCalendarCore::IncidenceBase::TypeTodo) {
+        return false;
+    }
+    return d->occurrence.incidence.staticCast<KCalendarCore::Todo>()->isCompleted();
+}
+
+int OccurrenceRecord::priority() const
+{
+    return isValid() ? d->occurrence.incidence->priority() : 0;
+}
+
+QString OccurrenceRecord::durationString() const
+{
+    if (!d) {
+        return {};
+    }
+    if (!d->durationString) {
+        const KCalendarCore::Duration duration(d->occurrence.start, d->occurrence.end);
+        d->durationString = Utils::formatSpelloutDuration(duration, d->format, d->occurrence.allDay);
+    }
+    return *d->durationString;
+}
+
+bool OccurrenceRecord::recurs() const
+{
+    return isValid() && d->occurrence.incidence->recurs();
+}
+
+bool OccurrenceRecord::hasReminders() const
+{
+    return isValid() && !d->occurrence.incidence->alarms().isEmpty();
+}
+
+bool OccurrenceRecord::isOverdue() const
+{
+    if (!isValid() || d->occurrence.incidence->type() != KCalendarCore::IncidenceBase::TypeTodo) {
+        return false;
+    }
+    return d->occurrence.incidence.staticCast<KCalendarCore::Todo>()->isOverdue();
+}
+
+bool OccurrenceRecord::isReadOnly() const
+{
+    return d && d->readOnly;
+}
+
+QColor OccurrenceRecord::color() const
+{
+    return d ? d->occurrence.color : QColor();
+}
+
+qint64 OccurrenceRecord::collectionId() const
+{
+    return d ? d->occurrence.collectionId : -1;
+}
+
+QString OccurrenceRecord::incidenceId() const
+{
+    return isValid() ? d->occurrence.incidence->uid() : QString();
+}
+
+int OccurrenceRecord::incidenceType() const
+{
+    return isValid() ? d->occurrence.incidence->type() : KCalendarCore::IncidenceBase::TypeUnknown;
+}
+
+QString OccurrenceRecord::incidenceTypeStr() const
+{
+    if (!isValid()) {
+        return {};
+    }
+    if (!d->incidenceTypeStr) {
+        const auto &incidence = d->occurrence.incidence;
+        d->incidenceTypeStr = incidence->type() == KCalendarCore::Incidence::TypeTodo ? i18n("Task") : i18n(incidence->typeStr().constData());
+    }
+    return *d->incidenceTypeStr;
+}
+
+QString OccurrenceRecord::incidenceTypeIcon() const
+{
+    return isValid() ? QString(d->occurrence.incidence->iconName()) : QString();
+}
+
+KCalendarCore::Incidence::Ptr OccurrenceRecord::incidencePtr() const
+{
+    return d ? d->occurrence.incidence : KCalendarCore::Incidence::Ptr();
+}
+
+IncidenceOccurrenceModel::Occurrence OccurrenceRecord::incidenceOccurrence() const
+{
+    return d ? d->occurrence : IncidenceOccurrenceModel::Occurrence{};
+}
+
+double OccurrenceRecord::starts() const
+{
+    return m_starts;
+}
+
+void OccurrenceRecord::setStarts(double starts)
+{
+    m_starts = starts;
+}
+
+double OccurrenceRecord::duration() const
+{
+    return m_duration;
+}
+
+void OccurrenceRecord::setDuration(double duration)
+{
+    m_duration = duration;
+}
+
+int OccurrenceRecord::maxConcurrentIncidences() const
+{
+    return m_maxConcurrentIncidences;
+}
+
+void OccurrenceRecord::setMaxConcurrentIncidences(int maxConcurrentIncidences)
+{
+    m_maxConcurrentIncidences = maxConcurrentIncidences;
+}
+
+double OccurrenceRecord::widthShare() const
+{
+    return m_widthShare;
+}
+
+void OccurrenceRecord::setWidthShare(double widthShare)
+{
+    m_widthShare = widthShare;
+}
+
+double OccurrenceRecord::priorTakenWidthShare() const
+{
+    return m_priorTakenWidthShare;
+}
+
+void OccurrenceRecord::setPriorTakenWidthShare(double priorTakenWidthShare)
+{
+    m_priorTakenWidthShare = priorTakenWidthShare;
+}
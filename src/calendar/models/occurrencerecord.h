@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#pragma once
+
+#include "incidenceoccurrencemodel.h"
+
+#include <KFormat>
+#include <QColor>
+#include <QDateTime>
+#include <QSharedPointer>
+
+/**
+ * An occurrence as the views display it, with the same names as the roles of
+ * IncidenceOccurrenceModel, so delegates bind to a single value instead of reading
+ * each role from the model.
+ *
+ * Copies share the occurrence and the strings formatted on first use, and have their own
+ * position in the view, which the layout models set.
+ */
+class OccurrenceRecord
+{
+    Q_GADGET
+    Q_PROPERTY(QString text READ text)
+    Q_PROPERTY(QString description READ description)
+    Q_PROPERTY(QString location READ location)
+    Q_PROPERTY(QDateTime startTime READ startTime)
+    Q_PROPERTY(QDateTime endTime READ endTime)
+    Q_PROPERTY(bool allDay READ allDay)
+    Q_PROPERTY(bool todoCompleted READ todoCompleted)
+    Q_PROPERTY(int priority READ priority)
+    Q_PROPERTY(QString durationString READ durationString)
+    Q_PROPERTY(bool recurs READ recurs)
+    Q_PROPERTY(bool hasReminders READ hasReminders)
+    Q_PROPERTY(bool isOverdue READ isOverdue)
+    Q_PROPERTY(bool isReadOnly READ isReadOnly)
+    Q_PROPERTY(QColor color READ color)
+    Q_PROPERTY(qint64 collectionId READ collectionId)
+    Q_PROPERTY(QString incidenceId READ incidenceId)
+    Q_PROPERTY(int incidenceType READ incidenceType)
+    Q_PROPERTY(QString incidenceTypeStr READ incidenceTypeStr)
+    Q_PROPERTY(QString incidenceTypeIcon READ incidenceTypeIcon)
+    Q_PROPERTY(KCalendarCore::Incidence::Ptr incidencePtr READ incidencePtr)
+    Q_PROPERTY(IncidenceOccurrenceModel::Occurrence incidenceOccurrence READ incidenceOccurrence)
+
+    // The position in the view, in days or in periods of the hourly views
+    Q_PROPERTY(double starts READ starts WRITE setStarts)
+    Q_PROPERTY(double duration READ duration WRITE setDuration)
+    Q_PROPERTY(int maxConcurrentIncidences READ maxConcurrentIncidences WRITE setMaxConcurrentIncidences)
+    Q_PROPERTY(double widthShare READ widthShare WRITE setWidthShare)
+    Q_PROPERTY(double priorTakenWidthShare READ priorTakenWidthShare WRITE setPriorTakenWidthShare)
+
+public:
+    OccurrenceRecord();
+    /// @p format is used for the duration string, as the model formats it
+    OccurrenceRecord(const IncidenceOccurrenceModel::Occurrence &occurrence, bool readOnly, const KFormat &format);
+
+    bool isValid() const;
+
+    QString text() const;
+    QString description() const;
+    QString location() const;
+    QDateTime startTime() const;
+    QDateTime endTime() const;
+    bool allDay() const;
+    bool todoCompleted() const;
+    int priority() const;
+    QString durationString() const;
+    bool recurs() const;
+    bool hasReminders() const;
+    bool isOverdue() const;
+    bool isReadOnly() const;
+    QColor color() const;
+    qint64 collectionId() const;
+    QString incidenceId() const;
+    int incidenceType() const;
+    QString incidenceTypeStr() const;
+    QString incidenceTypeIcon() const;
+    KCalendarCore::Incidence::Ptr incidencePtr() const;
+    IncidenceOccurrenceModel::Occurrence incidenceOccurrence() const;
+
+    double starts() const;
+    void setStarts(double starts);
+    double duration() const;
+    void setDuration(double duration);
+    int maxConcurrentIncidences() const;
+    void setMaxConcurrentIncidences(int maxConcurrentIncidences);
+    double widthShare() const;
+    void setWidthShare(double widthShare);
+    double priorTakenWidthShare() const;
+    void setPriorTakenWidthShare(double priorTakenWidthShare);
+
+private:
+    struct Data;
+    QSharedPointer<Data> d;
+
+    double m_starts = 0;
+    double m_duration = 0;
+    int m_maxConcurrentIncidences = 1;
+    double m_widthShare = 0;
+    double m_priorTakenWidthShare = 0;
+};
+
+Q_DECLARE_METATYPE(OccurrenceRecord)
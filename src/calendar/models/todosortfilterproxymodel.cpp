@@ -331,17 +331,10 @@ bool TodoSortFilterProxyModel::filterAcceptsRowCheck(int row, const QModelIndex
         break;
     }
 
-    if (!m_filterObject->tags().isEmpty()) {
-        const auto tags = m_filterObject->tags();
-        bool containsTag = false;
-        for (const auto &tag : tags) {
-            const auto todoPtr = sourceIndex.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
-            if (todoPtr->categories().contains(tag)) {
-                containsTag = true;
-                break;
-            }
-        }
-        acceptRow = acceptRow && containsTag;
+    const auto &tagIds = m_filterObject->tagIds();
+    if (acceptRow && !tagIds.isEmpty()) {
+        const auto todoPtr = sourceIndex.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
+        acceptRow = TagRegistry::intersects(m_tagCache.tags(*todoPtr), tagIds);
     }
 
     return acceptRow ? QSortFilterProxyModel::filterAcceptsRow(row, sourceParent) : acceptRow;
@@ -13,6 +13,7 @@
 #include <QObject>
 #include <QSortFilterProxyModel>
 #include <QTimer>
+#include <tagregistry.h>
 
 class Filter;
 
@@ -153,6 +154,8 @@ private:
     int m_showCompleted = ShowComplete::ShowAll;
     int m_showCompletedStore; // For when searches happen
     Filter *m_filterObject = nullptr;
+    // The tags of the todos, to filter them without looking their categories up again
+    mutable IncidenceTagCache m_tagCache;
     int m_sortColumn = DueDateColumn;
     bool m_sortAscending = false;
     bool m_showCompletedSubtodosInIncomplete = true;
@@ -0,0 +1,280 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "occurrenceexpander.h"
+
+#include <KCalendarCore/CalFilter>
+#include <KCalendarCore/OccurrenceIterator>
+#include <QHash>
+
+#include <algorithm>
+
+using namespace KCalendarCore;
+
+OccurrenceExpander::OccurrenceExpander(const Calendar &calendar, const QDateTime &start, const QDateTime &end)
+    : m_start(start)
+    , m_end(end)
+{
+    // The same incidences as OccurrenceIterator
+    Event::List events = calendar.rawEvents(start.date(), end.date(), start.timeZone());
+    Todo::List todos = calendar.rawTodos(start.date(), end.date(), start.timeZone());
+    Journal::List journals;
+    const auto allJournals = calendar.rawJournals();
+    for (const auto &journal : allJournals) {
+        const QDate journalStart = journal->dtStart().toTimeZone(start.timeZone()).date();
+        if (journal->dtStart().isValid() && journalStart >= start.date() && journalStart <= end.date()) {
+            journals << journal;
+        }
+    }
+    if (const auto filter = calendar.filter()) {
+        filter->apply(&events);
+        filter->apply(&todos);
+        filter->apply(&journals);
+    }
+
+    const auto incidences = Calendar::mergeIncidenceList(events, todos, journals);
+    for (const auto &incidence : incidences) {
+        expand(calendar, incidence);
+    }
+}
+
+void OccurrenceExpander::expand(const Calendar &calendar, const Incidence::Ptr &incidence)
+{
+    if (incidence->hasRecurrenceId()) {
+        // Expanded with their main incidence
+        return;
+    }
+    if (!incidence->recurs()) {
+        m_occurrences.append({incidence, {}, incidence->dtStart()});
+        return;
+    }
+
+    const auto exceptions = calendar.instances(incidence);
+    const bool simple = incidence->type() == IncidenceBase::TypeEvent && isSimple(incidence->recurrence())
+        && std::none_of(exceptions.cbegin(), exceptions.cend(), [](const Incidence::Ptr &exception) {
+                            return exception->thisAndFuture();
+                        });
+    if (!simple) {
+        OccurrenceIterator occurrenceIterator(calendar, incidence, m_start, m_end);
+        while (occurrenceIterator.hasNext()) {
+            occurrenceIterator.next();
+            m_occurrences.append({occurrenceIterator.incidence(), occurrenceIterator.recurrenceId(), occurrenceIterator.occurrenceStartDate()});
+        }
+        return;
+    }
+
+    QHash<QDateTime, Incidence::Ptr> exceptionsByRecurrenceId;
+    for (const auto &exception : exceptions) {
+        exceptionsByRecurrenceId.insert(exception->recurrenceId(), exception);
+    }
+
+    const auto times = simpleTimesInInterval(incidence->recurrence(), m_start, m_end);
+    for (const auto &time : times) {
+        const auto exception = exceptionsByRecurrenceId.value(time);
+        if (!exception) {
+            m_occurrences.append({incidence, time, time});
+        } else if (exception->status() != Incidence::StatusCanceled) {
+            m_occurrences.append({exception, time, exception->dtStart()});
+        }
+    }
+}
+
+bool OccurrenceExpander::hasNext() const
+{
+    return m_current + 1 < m_occurrences.count();
+}
+
+void OccurrenceExpander::next()
+{
+    ++m_current;
+}
+
+Incidence::Ptr OccurrenceExpander::incidence() const
+{
+    return m_occurrences.at(m_current).incidence;
+}
+
+QDateTime OccurrenceExpander::occurrenceStartDate() const
+{
+    return m_occurrences.at(m_current).startDate;
+}
+
+QDateTime OccurrenceExpander::recurrenceId() const
+{
+    return m_occurrences.at(m_current).recurrenceId;
+}
+
+bool OccurrenceExpander::isSimple(const Recurrence *recurrence)
+{
+    if (!recurrence || recurrence->rRules().count() != 1 || !recurrence->exRules().isEmpty() || !recurrence->rDates().isEmpty()
+        || !recurrence->rDateTimes().isEmpty()) {
+        return false;
+    }
+
+    const auto rule = recurrence->defaultRRuleConst();
+    if (rule->frequency() < 1 || !rule->startDt().isValid() || !rule->bySeconds().isEmpty() || !rule->byMinutes().isEmpty() || !rule->byHours().isEmpty()
+        || !rule->byYearDays().isEmpty() || !rule->byWeekNumbers().isEmpty() || !rule->byMonths().isEmpty() || !rule->bySetPos().isEmpty()) {
+        return false;
+    }
+
+    // The start has to be an occurrence, otherwise the rule counts its occurrences differently
+    const QDate startDate = rule->startDt().date();
+    switch (rule->recurrenceType()) {
+    case RecurrenceRule::rDaily:
+        return rule->byDays().isEmpty() && rule->byMonthDays().isEmpty();
+    case RecurrenceRule::rWeekly: {
+        if (!rule->byMonthDays().isEmpty()) {
+            return false;
+        }
+        const auto days = rule->byDays();
+        bool startMatches = days.isEmpty();
+        for (const auto &day : days) {
+            if (day.pos() != 0) {
+                return false;
+            }
+            startMatches = startMatches || day.day() == startDate.dayOfWeek();
+        }
+        return startMatches;
+    }
+    case RecurrenceRule::rMonthly: {
+        const auto monthDays = rule->byMonthDays();
+        if (!rule->byDays().isEmpty() || monthDays.count() > 1) {
+            return false;
+        }
+        const int day = monthDays.isEmpty() ? startDate.day() : monthDays.constFirst();
+        // Months too short for the day are skipped, which would have to be counted
+        return day == startDate.day() && (day <= 28 || rule->duration() <= 0);
+    }
+    default:
+        return false;
+    }
+}
+
+QList<QDateTime> OccurrenceExpander::timesInInterval(const Recurrence *recurrence, const QDateTime &start, const QDateTime &end)
+{
+    if (!isSimple(recurrence) || !start.isValid() || !end.isValid()) {
+        return recurrence->timesInInterval(start, end);
+    }
+    return simpleTimesInInterval(recurrence, start, end);
+}
+
+QList<QDateTime> OccurrenceExpander::simpleTimesInInterval(const Recurrence *recurrence, const QDateTime &start, const QDateTime &end)
+{
+    const auto rule = recurrence->defaultRRuleConst();
+    const QDateTime recurrenceStart = rule->startDt();
+    const qint64 frequency = rule->frequency();
+    // Forever if negative, until the end date if 0, otherwise a number of occurrences
+    const int count = rule->duration();
+    const QDateTime until = count == 0 ? rule->endDt() : QDateTime();
+
+    // The days around the range in the time zone of the recurrence, the exact bounds are checked for each occurrence
+    const auto timeZone = recurrenceStart.timeZone();
+    const qint64 firstDay = recurrenceStart.date().toJulianDay();
+    const qint64 fromDay = std::max(firstDay, start.toTimeZone(timeZone).date().toJulianDay() - 1);
+    const qint64 toDay = end.toTimeZone(timeZone).date().toJulianDay() + 1;
+    if (fromDay > toDay) {
+        return {};
+    }
+
+    QList<QDateTime> times;
+    // Returns false once past the last occurrence, @p index being the number of occurrences before
+    const auto append = [&](qint64 day, qint64 index) {
+        if (count > 0 && index >= count) {
+            return false;
+        }
+        QDateTime time = recurrenceStart;
+        time.setDate(QDate::fromJulianDay(day));
+        if (until.isValid() && time > until) {
+            return false;
+        }
+        if (time >= start && time <= end) {
+            times.append(time);
+        }
+        return true;
+    };
+
+    switch (rule->recurrenceType()) {
+    case RecurrenceRule::rDaily:
+        for (qint64 period = (fromDay - firstDay + frequency - 1) / frequency; firstDay + period * frequency <= toDay; ++period) {
+            if (!append(firstDay + period * frequency, period)) {
+                break;
+            }
+        }
+        break;
+    case RecurrenceRule::rWeekly: {
+        const int weekStart = rule->weekStart();
+        const auto dayInWeek = [weekStart](int dayOfWeek) {
+            return (dayOfWeek - weekStart + 7) % 7;
+        };
+
+        QVector<int> days;
+        const auto byDays = rule->byDays();
+        for (const auto &day : byDays) {
+            days.append(dayInWeek(day.day()));
+        }
+        if (days.isEmpty()) {
+            days.append(dayInWeek(recurrenceStart.date().dayOfWeek()));
+        }
+        std::sort(days.begin(), days.end());
+        days.erase(std::unique(days.begin(), days.end()), days.end());
+
+        const qint64 firstWeek = firstDay - dayInWeek(recurrenceStart.date().dayOfWeek());
+        const qint64 fromWeek = fromDay - dayInWeek(QDate::fromJulianDay(fromDay).dayOfWeek());
+        // The days of the first week before the start aren't occurrences
+        const qint64 skipped = std::count_if(days.cbegin(), days.cend(), [firstDay, firstWeek](int day) {
+            return firstWeek + day < firstDay;
+        });
+
+        bool done = false;
+        for (qint64 period = (fromWeek - firstWeek) / (7 * frequency); !done && firstWeek + period * 7 * frequency <= toDay; ++period) {
+            const qint64 week = firstWeek + period * 7 * frequency;
+            for (int i = 0; i < days.count(); ++i) {
+                const qint64 day = week + days.at(i);
+                if (day < firstDay) {
+                    continue;
+                }
+                if (day > toDay || !append(day, period * days.count() + i - skipped)) {
+                    done = true;
+                    break;
+                }
+            }
+        }
+        break;
+    }
+    case RecurrenceRule::rMonthly: {
+        const QDate firstDate = recurrenceStart.date();
+        const QDate fromDate = QDate::fromJulianDay(fromDay);
+        const int dayOfMonth = rule->byMonthDays().isEmpty() ? firstDate.day() : rule->byMonthDays().constFirst();
+        const qint64 firstMonth = firstDate.year() * 12 + firstDate.month() - 1;
+        const qint64 fromMonth = fromDate.year() * 12 + fromDate.month() - 1;
+
+        for (qint64 period = (fromMonth - firstMonth) / frequency;; ++period) {
+            const qint64 month = firstMonth + period * frequency;
+            const int year = int(month / 12);
+            if (QDate(year, int(month % 12) + 1, 1).toJulianDay() > toDay) {
+                break;
+            }
+            const QDate date(year, int(month % 12) + 1, dayOfMonth);
+            // Every month is an occurrence when counting, see isSimple()
+            if (date.isValid() && !append(date.toJulianDay(), period)) {
+                break;
+            }
+        }
+        break;
+    }
+    default:
+        return recurrence->timesInInterval(start, end);
+    }
+
+    const auto exDates = recurrence->exDates();
+    const auto exDateTimes = recurrence->exDateTimes();
+    if (!exDates.isEmpty() || !exDateTimes.isEmpty()) {
+        times.erase(std::remove_if(times.begin(),
+                                   times.end(),
+                                   [&exDates, &exDateTimes](const QDateTime &time) {
+                                       return exDates.contains(time.date()) || exDateTimes.contains(time);
+                                   }),
+                    times.end());
+    }
+    return times;
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <KCalendarCore/Calendar>
+#include <KCalendarCore/Recurrence>
+#include <QDateTime>
+#include <QVector>
+
+/**
+ * Iterates over the occurrences of the incidences of a calendar within a time range, like
+ * KCalendarCore::OccurrenceIterator.
+ *
+ * Events recurring daily, weekly or monthly on a day of the month, without other rule parts,
+ * are expanded arithmetically: the first occurrence in the range is computed directly instead
+ * of walking the recurrence from its start, so a series started years ago costs no more than
+ * one started last week. Other incidences go through KCalendarCore::OccurrenceIterator.
+ */
+class OccurrenceExpander
+{
+public:
+    /// Iterates over the occurrences of all the incidences of @p calendar
+    OccurrenceExpander(const KCalendarCore::Calendar &calendar, const QDateTime &start, const QDateTime &end);
+
+    bool hasNext() const;
+    void next();
+
+    KCalendarCore::Incidence::Ptr incidence() const;
+    QDateTime occurrenceStartDate() const;
+    /// The start of the occurrence as the recurrence defines it, before exceptions moved it
+    QDateTime recurrenceId() const;
+
+    /// Whether the occurrences of @p recurrence can be computed without walking it
+    static bool isSimple(const KCalendarCore::Recurrence *recurrence);
+    /// The same as Recurrence::timesInInterval(), computed arithmetically for simple recurrences
+    static QList<QDateTime> timesInInterval(const KCalendarCore::Recurrence *recurrence, const QDateTime &start, const QDateTime &end);
+
+private:
+    struct Occurrence {
+        KCalendarCore::Incidence::Ptr incidence;
+        QDateTime recurrenceId;
+        QDateTime startDate;
+    };
+
+    void expand(const KCalendarCore::Calendar &calendar, const KCalendarCore::Incidence::Ptr &incidence);
+    static QList<QDateTime> simpleTimesInInterval(const KCalendarCore::Recurrence *recurrence, const QDateTime &start, const QDateTime &end);
+
+    const QDateTime m_start;
+    const QDateTime m_end;
+    QVector<Occurrence> m_occurrences;
+    int m_current = -1;
+};
@@ -1,4 +1,5 @@
 // SPDX-FileCopyrightText: 2021 Claudio Cambra <claudio.cambra@gmail.com>
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 import QtQuick 2.15
@@ -43,6 +44,57 @@ TapHandler {
         }
     }
 
+    property Loader exportSheetLoader: Loader {
+        id: exportSheetLoader
+        property url url
+
+        active: false
+        onLoaded: {
+            item.exporter.exportToUrl(url, [calendarTapHandler.collectionId]);
+            item.open();
+        }
+
+        sourceComponent: CalendarExportSheet {
+            parent: applicationWindow().overlay
+            onSheetOpenChanged: if (!sheetOpen && !exporter.running) {
+                exportSheetLoader.active = false;
+            }
+        }
+
+        property Connections exporterConnections: Connections {
+            target: exportSheetLoader.item ? exportSheetLoader.item.exporter : null
+
+            function onFinished() {
+                if (!exportSheetLoader.item.sheetOpen) {
+                    exportSheetLoader.active = false;
+                }
+            }
+        }
+    }
+
+    property Loader exportDialogLoader: Loader {
+        id: exportDialogLoader
+        active: false
+        onLoaded: item.open()
+
+        sourceComponent: FileDialog {
+            title: i18nc("@title:window", "Export Calendar")
+            nameFilters: [i18n("Calendar files (*.ics)")]
+            selectExisting: false
+            onAccepted: {
+                if (exportSheetLoader.active) {
+                    // One export at a time, show the one still running
+                    exportSheetLoader.item.open();
+                } else {
+                    exportSheetLoader.url = fileUrl;
+                    exportSheetLoader.active = true;
+                }
+                exportDialogLoader.active = false;
+            }
+            onRejected: exportDialogLoader.active = false
+        }
+    }
+
     property Component calendarActions: Component {
         CalendarItemMenu {
             parent: calendarTapHandler.parent
@@ -1,5 +1,6 @@
 // SPDX-FileCopyrightText: 2021 Claudio Cambra <claudio.cambra@gmail.com>
 // SPDX-FileCopyrightText: 2023 Carl Schwan <carl@carlschwan.eu>
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 import QtQuick 2.15
@@ -38,10 +39,27 @@ Importer {
             width: root.width
         }, {
             width: Kirigami.Units.gridUnit * 30,
-            height: Kirigami.Units.gridUnit * 8,
+            height: Kirigami.Units.gridUnit * 10,
         });
     }
 
+    // The page showing the progress while importing, if not closed by the user
+    property var _importProgressPage: null
+
+    onImportStarted: {
+        root._importProgressPage = pageStack.pushDialogLayer(importProgressPageComponent, {}, {
+            width: Kirigami.Units.gridUnit * 20,
+            height: Kirigami.Units.gridUnit * 8
+        });
+    }
+
+    onImportFinished: {
+        if (root._importProgressPage) {
+            root._importProgressPage.closeDialog();
+            root._importProgressPage = null;
+        }
+    }
+
     onImportIntoExistingFinished: (success, total) => {
         if (success) {
             applicationWindow().showPassiveNotification(
@@ -73,8 +91,8 @@ Importer {
     property var importMergeCollectionPickerComponent: Component {
         CollectionPickerPage {
             onCollectionPicked: {
+                // Reset by the importer once it is done
                 root.importCalendarFromUrl(root.currentFile, true, collectionId);
-                root.calendarImportInProgress = false;
                 closeDialog();
             }
             onCancel: {
@@ -95,11 +113,60 @@ Importer {
                 width: root.width
             }, {
                 width: Kirigami.Units.gridUnit * 30,
-                height: Kirigami.Units.gridUnit * 8
+                height: Kirigami.Units.gridUnit * 10
             });
         }
     }
 
+    property var importProgressPageComponent: Component {
+        Kirigami.Page {
+            title: i18n("Importing Calendar")
+
+            ColumnLayout {
+                anchors.fill: parent
+
+                QQC2.ProgressBar {
+                    Layout.fillWidth: true
+                    from: 0
+                    to: 1
+                    value: Math.max(root.importProgress, 0)
+                    // Akonadi doesn't tell how far along it is when creating a new calendar
+                    indeterminate: root.importProgress < 0
+                }
+
+                QQC2.Label {
+                    Layout.fillWidth: true
+                    text: i18np("%1 incidence, %2 per second", "%1 incidences, %2 per second", root.importedCount, Math.round(root.incidencesPerSecond))
+                    visible: root.importProgress >= 0
+                    wrapMode: Text.WordWrap
+                }
+
+                QQC2.Label {
+                    Layout.fillWidth: true
+                    text: root.remainingSeconds < 60
+                        ? i18np("%1 second remaining", "%1 seconds remaining", root.remainingSeconds)
+                        : i18np("%1 minute remaining", "%1 minutes remaining", Math.ceil(root.remainingSeconds / 60))
+                    visible: root.remainingSeconds >= 0
+                    wrapMode: Text.WordWrap
+                }
+
+                Item {
+                    Layout.fillHeight: true
+                }
+
+                QQC2.Button {
+                    Layout.alignment: Qt.AlignRight
+                    text: i18n("Hide")
+                    // The import goes on, its result is notified once it is done
+                    onClicked: {
+                        root._importProgressPage = null;
+                        closeDialog();
+                    }
+                }
+            }
+        }
+    }
+
     property var importChoicePageComponent: Component {
         Kirigami.Page {
             id: importChoicePage
@@ -116,6 +183,13 @@ Importer {
                     wrapMode: Text.WordWrap
                 }
 
+                QQC2.CheckBox {
+                    Layout.fillWidth: true
+                    text: i18n("Update the events and tasks imported before instead of duplicating them")
+                    checked: root.dedupeByUid
+                    onToggled: root.dedupeByUid = checked
+                }
+
                 RowLayout {
                     QQC2.Button {
                         Layout.fillWidth: true
@@ -136,7 +210,7 @@ Importer {
                         icon.name: "document-new"
                         text: i18n("Create new calendar")
                         onClicked: {
-                            root.calendarImportInProgress = false;
+                            // Reset by the importer once it is done
                             root.importCalendarFromUrl(root.currentFile, false);
                             closeDialog();
                         }
@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+import QtQuick 2.15
+import QtQuick.Controls 2.15 as QQC2
+import QtQuick.Layouts 1.15
+import org.kde.kirigami 2.14 as Kirigami
+import org.kde.kalendar.calendar 1.0
+
+Kirigami.OverlaySheet {
+    id: root
+
+    readonly property CalendarExporter exporter: CalendarExporter {}
+
+    header: Kirigami.Heading {
+        text: i18nc("@title", "Exporting Calendar")
+    }
+
+    ColumnLayout {
+        Layout.preferredWidth: Kirigami.Units.gridUnit * 20
+
+        QQC2.ProgressBar {
+            Layout.fillWidth: true
+            from: 0
+            to: 1
+            value: Math.max(root.exporter.progress, 0)
+            indeterminate: root.exporter.running && root.exporter.progress < 0
+        }
+
+        QQC2.Label {
+            Layout.fillWidth: true
+            text: root.exporter.running
+                ? i18np("%1 incidence, %2 per second", "%1 incidences, %2 per second", root.exporter.exportedCount, Math.round(root.exporter.incidencesPerSecond))
+                : i18np("%1 incidence exported", "%1 incidences exported", root.exporter.exportedCount)
+            visible: root.exporter.errorMessage.length === 0
+        }
+
+        Kirigami.InlineMessage {
+            Layout.fillWidth: true
+            type: Kirigami.MessageType.Error
+            text: root.exporter.errorMessage
+            visible: root.exporter.errorMessage.length > 0
+        }
+    }
+
+    footer: QQC2.DialogButtonBox {
+        standardButtons: QQC2.DialogButtonBox.Close
+        enabled: !root.exporter.running
+        onRejected: root.close()
+    }
+}
@@ -45,6 +45,11 @@ QQC2.Menu {
             colorDialogLoader.item.open();
         }
     }
+    QQC2.MenuItem {
+        icon.name: "document-export"
+        text: i18nc("@action:inmenu", "Export calendar as iCalendar file…")
+        onClicked: exportDialogLoader.active = true
+    }
     QQC2.MenuSeparator {
         visible: collectionDetails.isResource
     }
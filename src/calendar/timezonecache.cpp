@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "timezonecache.h"
+
+#include <algorithm>
+
+static constexpr qint64 secsPerDay = 24 * 60 * 60;
+static const qint64 epochJulianDay = QDate(1970, 1, 1).toJulianDay();
+
+// Rounded towards negative infinity, unlike the / operator, for times before the epoch
+static qint64 floorDiv(qint64 value, qint64 divisor)
+{
+    return value / divisor - (value % divisor < 0 ? 1 : 0);
+}
+
+TimeZoneCache::TimeZoneCache()
+    : m_timeZone(QTimeZone::systemTimeZone())
+{
+}
+
+TimeZoneCache::TimeZoneCache(const QTimeZone &timeZone, const QDateTime &from, const QDateTime &to)
+    : m_timeZone(timeZone)
+    , m_from(from.toSecsSinceEpoch())
+    , m_to(to.toSecsSinceEpoch())
+{
+    if (!timeZone.isValid() || m_from >= m_to) {
+        return;
+    }
+
+    // Without transition data the offset of each time has to be asked for, unless it never changes
+    if (!timeZone.hasTransitions() && timeZone.hasDaylightTime()) {
+        return;
+    }
+
+    m_transitions.append({m_from, timeZone.offsetFromUtc(from)});
+    if (timeZone.hasTransitions()) {
+        const auto transitions = timeZone.transitions(from, to);
+        for (const auto &transition : transitions) {
+            const qint64 atSecs = transition.atUtc.toSecsSinceEpoch();
+            if (atSecs <= m_from) {
+                m_transitions.last().offset = transition.offsetFromUtc;
+            } else if (atSecs < m_to) {
+                m_transitions.append({atSecs, transition.offsetFromUtc});
+            }
+        }
+    }
+}
+
+QTimeZone TimeZoneCache::timeZone() const
+{
+    return m_timeZone;
+}
+
+int TimeZoneCache::offsetFromUtc(qint64 secsSinceEpoch) const
+{
+    if (m_transitions.isEmpty() || secsSinceEpoch < m_from || secsSinceEpoch >= m_to) {
+        return m_timeZone.offsetFromUtc(QDateTime::fromSecsSinceEpoch(secsSinceEpoch, Qt::UTC));
+    }
+
+    // The last transition at or before the time
+    const auto it = std::upper_bound(m_transitions.cbegin(), m_transitions.cend(), secsSinceEpoch, [](qint64 secs, const Transition &transition) {
+        return secs < transition.atSecs;
+    });
+    return std::prev(it)->offset;
+}
+
+qint64 TimeZoneCache::toLocalSecs(qint64 secsSinceEpoch) const
+{
+    return secsSinceEpoch + offsetFromUtc(secsSinceEpoch);
+}
+
+qint64 TimeZoneCache::localDay(qint64 secsSinceEpoch) const
+{
+    return floorDiv(toLocalSecs(secsSinceEpoch), secsPerDay);
+}
+
+int TimeZoneCache::localMinuteOfDay(qint64 secsSinceEpoch) const
+{
+    const qint64 localSecs = toLocalSecs(secsSinceEpoch);
+    return int((localSecs - floorDiv(localSecs, secsPerDay) * secsPerDay) / 60);
+}
+
+QDate TimeZoneCache::localDate(qint64 secsSinceEpoch) const
+{
+    return QDate::fromJulianDay(epochJulianDay + localDay(secsSinceEpoch));
+}
+
+qint64 TimeZoneCache::dayOf(const QDate &date)
+{
+    return date.toJulianDay() - epochJulianDay;
+}
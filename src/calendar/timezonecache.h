@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <QDateTime>
+#include <QTimeZone>
+#include <QVector>
+
+/**
+ * Converts times in seconds since the epoch to the local time of a time zone.
+ *
+ * The offset transitions of the time zone within a window are looked up once, so converting
+ * a time within it is a binary search instead of a QTimeZone query. Times outside the window
+ * are still converted correctly, through the time zone.
+ */
+class TimeZoneCache
+{
+public:
+    /// A cache of the system time zone, with an empty window
+    TimeZoneCache();
+    TimeZoneCache(const QTimeZone &timeZone, const QDateTime &from, const QDateTime &to);
+
+    QTimeZone timeZone() const;
+
+    /// The offset from UTC in seconds at @p secsSinceEpoch
+    int offsetFromUtc(qint64 secsSinceEpoch) const;
+    /// @p secsSinceEpoch shifted by the offset, so whole days are local days
+    qint64 toLocalSecs(qint64 secsSinceEpoch) const;
+    /// The number of local days between 1970-01-01 and @p secsSinceEpoch
+    qint64 localDay(qint64 secsSinceEpoch) const;
+    /// The number of minutes since the start of the local day at @p secsSinceEpoch
+    int localMinuteOfDay(qint64 secsSinceEpoch) const;
+    QDate localDate(qint64 secsSinceEpoch) const;
+
+    /// The local day of @p date, in the same unit as localDay()
+    static qint64 dayOf(const QDate &date);
+
+private:
+    struct Transition {
+        qint64 atSecs;
+        int offset;
+    };
+
+    QTimeZone m_timeZone;
+    qint64 m_from = 0;
+    qint64 m_to = 0;
+    // Sorted by time, the first one at m_from
+    QVector<Transition> m_transitions;
+};
@@ -8,7 +8,6 @@ import org.kde.plasma.core 2.0 as PlasmaCore
 import org.kde.plasma.extras 2.0 as PlasmaExtras
 import org.kde.plasma.components 3.0 as PlasmaComponents3
 import org.kde.kalendar.contact 1.0
-import org.kde.kitemmodels 1.0
 
 PlasmaComponents3.ScrollView {
     id: scrollView
@@ -22,7 +21,7 @@ PlasmaComponents3.ScrollView {
             PlasmaExtras.SearchField {
                 id: searchField
                 Layout.fillWidth: true
-                onTextChanged: contactsList.model.setFilterFixedString(text)
+                onTextChanged: contactsList.model.searchText = text
             }
         }
     }
@@ -63,10 +62,7 @@ PlasmaComponents3.ScrollView {
 
     contentItem: ListView {
         id: contactsList
-        model: KSortFilterProxyModel {
-            filterCaseSensitivity: Qt.CaseInsensitive
-            sourceModel: ContactsModel {}
-        }
+        model: ContactsModel {}
         boundsBehavior: Flickable.StopAtBounds
         topMargin: PlasmaCore.Units.smallSpacing * 2
         bottomMargin: PlasmaCore.Units.smallSpacing * 2
@@ -75,7 +71,8 @@ PlasmaComponents3.ScrollView {
         spacing: PlasmaCore.Units.smallSpacing
         activeFocusOnTab: true
 
-        section.property: "display"
+        // Search results are sorted by relevance
+        section.property: searchField.text.length === 0 ? "display" : ""
         section.criteria: ViewSection.FirstCharacter
         section.delegate: PlasmaExtras.Heading {level: 4; text: section}
         highlight: PlasmaExtras.Highlight { }
@@ -0,0 +1,235 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "../contactsearchindex.h"
+#include <Akonadi/EntityTreeModel>
+#include <KContacts/Addressee>
+#include <KContacts/ContactGroup>
+#include <QObject>
+#include <QStandardItemModel>
+#include <QTest>
+#include <benchmarkhelper.h>
+
+class ContactSearchIndexTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QStandardItem *createItem(Akonadi::Item::Id id, const QString &name, const QStringList &emails, const QString &organization = {})
+    {
+        KContacts::Addressee addressee;
+        addressee.setFormattedName(name);
+        const auto names = name.split(QLatin1Char(' '));
+        addressee.setGivenName(names.first());
+        addressee.setFamilyName(names.last());
+        addressee.setOrganization(organization);
+        for (const auto &email : emails) {
+            addressee.insertEmail(email);
+        }
+
+        Akonadi::Item item(id);
+        item.setMimeType(KContacts::Addressee::mimeType());
+        item.setPayload(addressee);
+
+        auto standardItem = new QStandardItem(name);
+        standardItem->setData(QVariant::fromValue(item), Akonadi::EntityTreeModel::ItemRole);
+        standardItem->setData(item.id(), Akonadi::EntityTreeModel::ItemIdRole);
+        return standardItem;
+    }
+
+    static void fillModel(QStandardItemModel &model)
+    {
+        model.appendRow(createItem(1, QStringLiteral("Carl Schwan"), {QStringLiteral("carl@carlschwan.eu")}, QStringLiteral("KDE e.V.")));
+        model.appendRow(createItem(2, QStringLiteral("Claudio Cambra"), {QStringLiteral("claudio.cambra@gmail.com")}));
+        model.appendRow(createItem(3, QStringLiteral("Zoë Müller"), {QStringLiteral("zoe@example.org"), QStringLiteral("mueller@work.example")}));
+        model.appendRow(createItem(4, QStringLiteral("Carla Carlsson"), {}));
+    }
+
+    // Distinct names made of syllables, so the grams are spread like in a real address book
+    static void fillModel(QStandardItemModel &model, int count)
+    {
+        static const QStringList givenNames{
+            QStringLiteral("Anna"),
+            QStringLiteral("Carl"),
+            QStringLiteral("Claudio"),
+            QStringLiteral("Eva"),
+            QStringLiteral("Jonas"),
+            QStringLiteral("Lena"),
+            QStringLiteral("Mario"),
+            QStringLiteral("Nina"),
+            QStringLiteral("Paul"),
+            QStringLiteral("Zoë"),
+        };
+        static const QStringList syllables = QStringLiteral("ka len dar mo ri sa to ne vi lu pe zo an el or us ba di fe gu").split(QLatin1Char(' '));
+        for (int i = 0; i < count; ++i) {
+            QString familyName;
+            for (int rest = i; familyName.isEmpty() || rest > 0; rest /= syllables.size()) {
+                familyName += syllables.at(rest % syllables.size());
+            }
+            familyName[0] = familyName.at(0).toUpper();
+            const auto &givenName = givenNames.at(i % givenNames.size());
+            const auto email = QStringLiteral("%1.%2@example.org").arg(givenName, familyName).toLower();
+            model.appendRow(createItem(i + 1, givenName + QLatin1Char(' ') + familyName, {email}));
+        }
+    }
+
+private Q_SLOTS:
+    void init()
+    {
+        KALENDAR_SKIP_BENCHMARKS();
+    }
+
+    void testNormalize()
+    {
+        QCOMPARE(ContactSearchIndex::normalize(QStringLiteral("Zoë MÜLLER")), QStringLiteral("zoe muller"));
+    }
+
+    void testSearch_data()
+    {
+        QTest::addColumn<QString>("text");
+        QTest::addColumn<QVector<Akonadi::Item::Id>>("ids");
+
+        QTest::newRow("empty") << QString() << QVector<Akonadi::Item::Id>{};
+        QTest::newRow("single character") << QStringLiteral("z") << QVector<Akonadi::Item::Id>{3};
+        // Carla Carlsson has two tokens starting with the word, but exact matches rank first
+        QTest::newRow("prefix") << QStringLiteral("carl") << QVector<Akonadi::Item::Id>{1, 4};
+        QTest::newRow("case and diacritics") << QStringLiteral("MULLER") << QVector<Akonadi::Item::Id>{3};
+        QTest::newRow("substring") << QStringLiteral("ambr") << QVector<Akonadi::Item::Id>{2};
+        QTest::newRow("short substring") << QStringLiteral("la") << QVector<Akonadi::Item::Id>{};
+        QTest::newRow("email") << QStringLiteral("claudio.cambra@gmail") << QVector<Akonadi::Item::Id>{2};
+        QTest::newRow("second email") << QStringLiteral("work.example") << QVector<Akonadi::Item::Id>{3};
+        QTest::newRow("organization") << QStringLiteral("kde") << QVector<Akonadi::Item::Id>{1};
+        QTest::newRow("all words") << QStringLiteral("carl sson") << QVector<Akonadi::Item::Id>{4};
+        QTest::newRow("no match") << QStringLiteral("xyz") << QVector<Akonadi::Item::Id>{};
+    }
+
+    void testSearch()
+    {
+        QFETCH(QString, text);
+        QFETCH(QVector<Akonadi::Item::Id>, ids);
+
+        QStandardItemModel model;
+        fillModel(model);
+        ContactSearchIndex index(&model);
+        QCOMPARE(index.count(), 4);
+        QCOMPARE(index.search(text), ids);
+    }
+
+    void testLimit()
+    {
+        QStandardItemModel model;
+        fillModel(model);
+        ContactSearchIndex index(&model);
+        QCOMPARE(index.search(QStringLiteral("c"), 1), QVector<Akonadi::Item::Id>{1});
+    }
+
+    void testIncrementalUpdates()
+    {
+        QStandardItemModel model;
+        fillModel(model);
+        ContactSearchIndex index(&model);
+
+        model.appendRow(createItem(5, QStringLiteral("Carlos Santana"), {QStringLiteral("carlos@example.org")}));
+        QCOMPARE(index.search(QStringLiteral("santa")), QVector<Akonadi::Item::Id>{5});
+
+        // Changing the contact replaces its tokens
+        const auto changed = createItem(5, QStringLiteral("Carlos Smith"), {});
+        model.item(4)->setData(changed->data(Akonadi::EntityTreeModel::ItemRole), Akonadi::EntityTreeModel::ItemRole);
+        delete changed;
+        QCOMPARE(index.search(QStringLiteral("santa")), QVector<Akonadi::Item::Id>{});
+        QCOMPARE(index.search(QStringLiteral("smith")), QVector<Akonadi::Item::Id>{5});
+
+        model.removeRow(0);
+        QCOMPARE(index.search(QStringLiteral("carl")), (QVector<Akonadi::Item::Id>{4, 5}));
+        QCOMPARE(index.count(), 4);
+
+        model.clear();
+        QCOMPARE(index.count(), 0);
+        QCOMPARE(index.search(QStringLiteral("carl")), QVector<Akonadi::Item::Id>{});
+    }
+
+    void testManyRemovals()
+    {
+        QStandardItemModel model;
+        fillModel(model, 1000);
+        ContactSearchIndex index(&model);
+        const auto first = index.search(QStringLiteral("karilen"));
+        QCOMPARE(first.size(), 1);
+
+        // Enough to purge the removed contacts from the postings, and to reuse their documents afterwards
+        model.removeRows(0, 900);
+        QCOMPARE(index.count(), 100);
+        QCOMPARE(index.search(QStringLiteral("karilen")), QVector<Akonadi::Item::Id>{});
+        QCOMPARE(index.search(QStringLiteral("example")).size(), 100);
+
+        model.appendRow(createItem(5000, QStringLiteral("Carlos Santana"), {}));
+        QCOMPARE(index.count(), 101);
+        QCOMPARE(index.search(QStringLiteral("santa")), QVector<Akonadi::Item::Id>{5000});
+        QCOMPARE(index.search(QStringLiteral("example")).size(), 100);
+    }
+
+    void testContactGroup()
+    {
+        QStandardItemModel model;
+        KContacts::ContactGroup group(QStringLiteral("Kalendar Developers"));
+        Akonadi::Item item(7);
+        item.setMimeType(KContacts::ContactGroup::mimeType());
+        item.setPayload(group);
+        auto standardItem = new QStandardItem(group.name());
+        standardItem->setData(QVariant::fromValue(item), Akonadi::EntityTreeModel::ItemRole);
+        model.appendRow(standardItem);
+
+        ContactSearchIndex index(&model);
+        QCOMPARE(index.search(QStringLiteral("develop")), QVector<Akonadi::Item::Id>{7});
+    }
+
+    void benchmarkBuild()
+    {
+        QStandardItemModel model;
+        fillModel(model, 100000);
+        QBENCHMARK {
+            ContactSearchIndex index(&model);
+        }
+    }
+
+    void benchmarkSearch_data()
+    {
+        QTest::addColumn<QString>("text");
+
+        QTest::newRow("single character") << QStringLiteral("k");
+        QTest::newRow("prefix") << QStringLiteral("kare");
+        QTest::newRow("substring") << QStringLiteral("arilen");
+        QTest::newRow("two words") << QStringLiteral("nina ka");
+        QTest::newRow("email") << QStringLiteral("nina.karilen@example");
+    }
+
+    void benchmarkSearch()
+    {
+        QFETCH(QString, text);
+
+        QStandardItemModel model;
+        fillModel(model, 100000);
+        ContactSearchIndex index(&model);
+        QBENCHMARK {
+            index.search(text, 50);
+        }
+    }
+
+    void benchmarkRemove()
+    {
+        QStandardItemModel model;
+        fillModel(model, 100000);
+        ContactSearchIndex index(&model);
+
+        // A tenth of the contacts, one at a time
+        QBENCHMARK_ONCE {
+            for (int i = 0; i < 10000; ++i) {
+                model.removeRow(model.rowCount() - 1);
+            }
+        }
+        QCOMPARE(index.count(), 90000);
+    }
+};
+
+QTEST_MAIN(ContactSearchIndexTest)
+#include "contactsearchindextest.moc"
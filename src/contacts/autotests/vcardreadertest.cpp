@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "../vcardreader.h"
+#include <QBuffer>
+#include <QObject>
+#include <QTemporaryFile>
+#include <QTest>
+
+class VCardReaderTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QByteArray card(int i)
+    {
+        return QStringLiteral(
+                   "BEGIN:VCARD\r\n"
+                   "VERSION:3.0\r\n"
+                   "FN:Contact %1\r\n"
+                   "N:%1;Contact;;;\r\n"
+                   "EMAIL;TYPE=INTERNET:contact%1@example.org\r\n"
+                   "NOTE:A note long enough to be folded over two lines by the writ\r\n"
+                   " er of contact %1\r\n"
+                   "END:VCARD\r\n")
+            .arg(i)
+            .toUtf8();
+    }
+
+private Q_SLOTS:
+    void testBatches()
+    {
+        QByteArray data;
+        for (int i = 0; i < 5; ++i) {
+            data += card(i);
+        }
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+
+        VCardReader reader(&buffer);
+        auto contacts = reader.read(2);
+        QCOMPARE(contacts.count(), 2);
+        QCOMPARE(contacts[0].formattedName(), QStringLiteral("Contact 0"));
+        QCOMPARE(contacts[1].preferredEmail(), QStringLiteral("contact1@example.org"));
+        QCOMPARE(contacts[1].note(), QStringLiteral("A note long enough to be folded over two lines by the writer of contact 1"));
+        QVERIFY(!reader.atEnd());
+
+        QCOMPARE(reader.read(2).count(), 2);
+        contacts = reader.read(2);
+        QCOMPARE(contacts.count(), 1);
+        QCOMPARE(contacts[0].formattedName(), QStringLiteral("Contact 4"));
+        QVERIFY(reader.atEnd());
+        QVERIFY(reader.read(2).isEmpty());
+    }
+
+    void testIncompleteCard()
+    {
+        QByteArray data = "garbage before\n" + card(0) + "BEGIN:VCARD\r\nFN:Unfinished\r\n";
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+
+        VCardReader reader(&buffer);
+        const auto contacts = reader.read(10);
+        QCOMPARE(contacts.count(), 1);
+        QCOMPARE(contacts[0].formattedName(), QStringLiteral("Contact 0"));
+        QVERIFY(reader.atEnd());
+    }
+
+    void testByteOrderMark()
+    {
+        QByteArray data = "\xEF\xBB\xBF" + card(0) + card(1);
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+
+        VCardReader reader(&buffer);
+        const auto contacts = reader.read(10);
+        QCOMPARE(contacts.count(), 2);
+        QCOMPARE(contacts[0].formattedName(), QStringLiteral("Contact 0"));
+        QCOMPARE(contacts[1].formattedName(), QStringLiteral("Contact 1"));
+    }
+
+    void testLargeFile()
+    {
+        constexpr int contactCount = 50000;
+
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        for (int i = 0; i < contactCount; ++i) {
+            file.write(card(i));
+        }
+        QVERIFY(file.seek(0));
+
+        VCardReader reader(&file);
+        int count = 0;
+        qint64 position = 0;
+        while (!reader.atEnd()) {
+            const auto contacts = reader.read(500);
+            QVERIFY(contacts.count() <= 500);
+            QVERIFY(reader.position() > position);
+            position = reader.position();
+            for (const auto &contact : contacts) {
+                QCOMPARE(contact.formattedName(), QStringLiteral("Contact %1").arg(count));
+                ++count;
+            }
+        }
+        QCOMPARE(count, contactCount);
+        QCOMPARE(position, file.size());
+    }
+};
+
+QTEST_MAIN(VCardReaderTest)
+#include "vcardreadertest.moc"
@@ -12,6 +12,9 @@
 
 using namespace Akonadi;
 
+// References are fetched in jobs of this many items when loading a group
+static constexpr int referenceBatchSize = 500;
+
 struct GroupMember {
     KContacts::ContactGroup::ContactReference reference;
     KContacts::ContactGroup::Data data;
@@ -45,6 +48,106 @@ public:
         });
     }
 
+    void resolveContactReferences(const QVector<KContacts::ContactGroup::ContactReference> &references)
+    {
+        ++mLoadGeneration;
+        mPendingReferences = references;
+        mFetchedById.clear();
+        mFetchedByGid.clear();
+        mPendingJobs = 0;
+
+        // Items can't be fetched by a mix of ids and gids
+        Item::List itemsById;
+        Item::List itemsByGid;
+        for (const auto &reference : references) {
+            Item item;
+            if (!reference.gid().isEmpty()) {
+                item.setGid(reference.gid());
+                itemsByGid.append(item);
+            } else {
+                item.setId(reference.uid().toLongLong());
+                itemsById.append(item);
+            }
+        }
+        fetchReferences(itemsById);
+        fetchReferences(itemsByGid);
+
+        if (mPendingJobs == 0) {
+            insertReferences();
+        }
+    }
+
+    void fetchReferences(const Item::List &items)
+    {
+        for (int i = 0; i < items.count(); i += referenceBatchSize) {
+            auto job = new ItemFetchJob(items.mid(i, referenceBatchSize), mParent);
+            job->fetchScope().fetchFullPayload();
+            ++mPendingJobs;
+
+            const int generation = mLoadGeneration;
+            mParent->connect(job, &ItemFetchJob::result, mParent, [this, generation](KJob *job) {
+                if (generation != mLoadGeneration) {
+                    // Another group was loaded in the meantime
+                    return;
+                }
+                // The references of a failed job are loaded one by one afterwards
+                if (!job->error()) {
+                    const auto items = qobject_cast<ItemFetchJob *>(job)->items();
+                    for (const Item &item : items) {
+                        if (!item.hasPayload<KContacts::Addressee>()) {
+                            continue;
+                        }
+                        const auto contact = item.payload<KContacts::Addressee>();
+                        mFetchedById.insert(item.id(), contact);
+                        if (!item.gid().isEmpty()) {
+                            mFetchedByGid.insert(item.gid(), contact);
+                        }
+                    }
+                }
+                if (--mPendingJobs == 0) {
+                    insertReferences();
+                }
+            });
+        }
+    }
+
+    void insertReferences()
+    {
+        if (mPendingReferences.isEmpty()) {
+            return;
+        }
+
+        QVector<GroupMember> members;
+        members.reserve(mPendingReferences.count());
+        QVector<int> unresolved;
+        for (const auto &reference : std::as_const(mPendingReferences)) {
+            GroupMember member;
+            member.isReference = true;
+            member.reference = reference;
+
+            const bool fetched = !reference.gid().isEmpty() ? mFetchedByGid.contains(reference.gid()) : mFetchedById.contains(reference.uid().toLongLong());
+            if (fetched) {
+                member.referencedContact =
+                    !reference.gid().isEmpty() ? mFetchedByGid.value(reference.gid()) : mFetchedById.value(reference.uid().toLongLong());
+            } else {
+                unresolved.append(members.count());
+            }
+            members.append(member);
+        }
+        mPendingReferences.clear();
+        mFetchedById.clear();
+        mFetchedByGid.clear();
+
+        const int first = mMembers.count();
+        mParent->beginInsertRows({}, first, first + members.count() - 1);
+        mMembers += members;
+        mParent->endInsertRows();
+
+        for (const int index : std::as_const(unresolved)) {
+            resolveContactReference(mMembers[first + index].reference, first + index);
+        }
+    }
+
     void itemFetched(KJob *job, const QString &preferredEmail)
     {
         const int row = job->property("row").toInt();
@@ -128,6 +231,12 @@ public:
     KContacts::ContactGroup mGroup;
     QString mLastErrorMessage;
     bool mIsEditing;
+
+    QVector<KContacts::ContactGroup::ContactReference> mPendingReferences;
+    QHash<Item::Id, KContacts::Addressee> mFetchedById;
+    QHash<QString, KContacts::Addressee> mFetchedByGid;
+    int mPendingJobs = 0;
+    int mLoadGeneration = 0;
 };
 
 ContactGroupModel::ContactGroupModel(bool isEditing, QObject *parent)
@@ -155,20 +264,17 @@ void ContactGroupModel::loadContactGroup(const KContacts::ContactGroup &contactG
         d->mMembers.append(member);
     }
 
-    for (int i = 0; i < d->mGroup.contactReferenceCount(); ++i) {
-        const KContacts::ContactGroup::ContactReference reference = d->mGroup.contactReference(i);
-        GroupMember member;
-        member.isReference = true;
-        member.reference = reference;
-
-        d->mMembers.append(member);
-
-        d->resolveContactReference(reference, d->mMembers.count() - 1);
-    }
-
     d->normalizeMemberList();
 
     endResetModel();
+
+    // The references are added all at once when their contacts are fetched
+    QVector<KContacts::ContactGroup::ContactReference> references;
+    references.reserve(d->mGroup.contactReferenceCount());
+    for (int i = 0; i < d->mGroup.contactReferenceCount(); ++i) {
+        references.append(d->mGroup.contactReference(i));
+    }
+    d->resolveContactReferences(references);
 }
 
 bool ContactGroupModel::storeContactGroup(KContacts::ContactGroup &group) const
@@ -188,6 +294,10 @@ bool ContactGroupModel::storeContactGroup(KContacts::ContactGroup &group) const
             group.append(member.data);
         }
     }
+    // References of a group still being loaded
+    for (const auto &reference : std::as_const(d->mPendingReferences)) {
+        group.append(reference);
+    }
 
     return true;
 }
@@ -7,6 +7,7 @@
 
 #include "contactcollectionmodel.h"
 #include "contactconfig.h"
+#include "contactsearchfiltermodel.h"
 #include "globalcontactmodel.h"
 #include "kalendar_contact_debug.h"
 #include <Akonadi/AgentManager>
@@ -91,11 +92,10 @@ ContactManager::ContactManager(QObject *parent)
     entityMimeTypeFilterModel->addMimeTypeExclusionFilter(Akonadi::Collection::mimeType());
     entityMimeTypeFilterModel->setHeaderGroup(Akonadi::EntityTreeModel::ItemListHeaders);
 
-    m_filteredContacts = new QSortFilterProxyModel(this);
+    m_filteredContacts = new ContactSearchFilterModel(this);
     m_filteredContacts->setSourceModel(entityMimeTypeFilterModel);
     m_filteredContacts->setSortLocaleAware(true);
     m_filteredContacts->setSortCaseSensitivity(Qt::CaseInsensitive);
-    m_filteredContacts->setFilterCaseSensitivity(Qt::CaseInsensitive);
     m_filteredContacts->sort(0);
 }
 
@@ -208,6 +208,7 @@ QVariantMap ContactManager::getCollectionDetails(const Akonadi::Collection &coll
     collectionDetails[QLatin1String("readOnly")] = collection.rights().testFlag(Akonadi::Collection::ReadOnly);
     collectionDetails[QLatin1String("canChange")] = collection.rights().testFlag(Akonadi::Collection::CanChangeCollection);
     collectionDetails[QLatin1String("canCreate")] = collection.rights().testFlag(Akonadi::Collection::CanCreateCollection);
+    collectionDetails[QLatin1String("canCreateItems")] = collection.rights().testFlag(Akonadi::Collection::CanCreateItem);
     collectionDetails[QLatin1String("canDelete")] =
         collection.rights().testFlag(Akonadi::Collection::CanDeleteCollection) && !Akonadi::CollectionUtils::isResource(collection);
 
@@ -18,6 +18,7 @@ class KCheckableProxyModel;
 class QAbstractItemModel;
 class QItemSelectionModel;
 class ColorProxyModel;
+class ContactSearchFilterModel;
 
 class ContactManager : public QObject
 {
@@ -53,7 +54,7 @@ private:
     QItemSelectionModel *m_collectionSelectionModel;
     Akonadi::CollectionFilterProxyModel *m_contactMimeTypeFilterModel = nullptr;
     Akonadi::ETMViewStateSaver *m_collectionSelectionModelStateSaver;
-    QSortFilterProxyModel *m_filteredContacts;
+    ContactSearchFilterModel *m_filteredContacts;
     KCheckableProxyModel *m_checkableProxyModel;
     ColorProxyModel *m_colorProxy;
 };
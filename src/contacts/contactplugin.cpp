@@ -12,6 +12,7 @@
 #include "contactmanager.h"
 #include "contactsmodel.h"
 #include "emailmodel.h"
+#include "vcardtransfer.h"
 
 #include <QQmlEngine>
 
@@ -44,6 +45,7 @@ void CalendarPlugin::registerTypes(const char *uri)
     qmlRegisterType<ContactGroupWrapper>("org.kde.kalendar.contact", 1, 0, "ContactGroupWrapper");
     qmlRegisterType<ContactGroupEditor>("org.kde.kalendar.contact", 1, 0, "ContactGroupEditor");
     qmlRegisterType<ContactsModel>("org.kde.kalendar.contact", 1, 0, "ContactsModel");
+    qmlRegisterType<VCardTransfer>("org.kde.kalendar.contact", 1, 0, "VCardTransfer");
     qRegisterMetaType<KContacts::Picture>("KContacts::Picture");
     qRegisterMetaType<KContacts::PhoneNumber::List>("KContacts::PhoneNumber::List");
     qRegisterMetaType<KContacts::PhoneNumber>("KContacts::PhoneNumber");
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "contactsearchfiltermodel.h"
+
+#include "contactsearchindex.h"
+
+ContactSearchFilterModel::ContactSearchFilterModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+}
+
+void ContactSearchFilterModel::setSearchIndex(ContactSearchIndex *index)
+{
+    if (m_index) {
+        disconnect(m_index, nullptr, this, nullptr);
+    }
+    m_index = index;
+    connect(m_index, &ContactSearchIndex::changed, this, [this] {
+        // Without a search nothing depends on the index
+        if (isSearching()) {
+            updateResults();
+            invalidate();
+        }
+    });
+    updateResults();
+    invalidate();
+}
+
+QString ContactSearchFilterModel::searchText() const
+{
+    return m_searchText;
+}
+
+void ContactSearchFilterModel::setSearchText(const QString &searchText)
+{
+    if (m_searchText == searchText) {
+        return;
+    }
+    m_searchText = searchText;
+    if (!m_index) {
+        setSearchIndex(ContactSearchIndex::instance());
+    } else {
+        updateResults();
+        invalidate();
+    }
+    Q_EMIT searchTextChanged();
+}
+
+bool ContactSearchFilterModel::isSearching() const
+{
+    return !m_searchText.trimmed().isEmpty();
+}
+
+void ContactSearchFilterModel::updateResults()
+{
+    m_ranks.clear();
+    if (isSearching()) {
+        const auto ids = m_index->search(m_searchText);
+        m_ranks.reserve(ids.size());
+        for (int rank = 0; rank < ids.size(); ++rank) {
+            m_ranks.insert(ids.at(rank), rank);
+        }
+    }
+}
+
+QVariant ContactSearchFilterModel::data(const QModelIndex &index, int role) const
+{
+    if (role == SearchRankRole) {
+        if (!isSearching()) {
+            return -1;
+        }
+        return m_ranks.value(QSortFilterProxyModel::data(index, Akonadi::EntityTreeModel::ItemIdRole).value<Akonadi::Item::Id>(), -1);
+    }
+    return QSortFilterProxyModel::data(index, role);
+}
+
+bool ContactSearchFilterModel::filterAcceptsRow(int row, const QModelIndex &sourceParent) const
+{
+    if (!isSearching()) {
+        return true;
+    }
+    const auto id = sourceModel()->index(row, 0, sourceParent).data(Akonadi::EntityTreeModel::ItemIdRole);
+    return id.isValid() && m_ranks.contains(id.value<Akonadi::Item::Id>());
+}
+
+bool ContactSearchFilterModel::lessThan(const QModelIndex &sourceLeft, const QModelIndex &sourceRight) const
+{
+    if (isSearching()) {
+        const auto leftRank = m_ranks.value(sourceLeft.data(Akonadi::EntityTreeModel::ItemIdRole).value<Akonadi::Item::Id>(), -1);
+        const auto rightRank = m_ranks.value(sourceRight.data(Akonadi::EntityTreeModel::ItemIdRole).value<Akonadi::Item::Id>(), -1);
+        if (leftRank != rightRank) {
+            return leftRank < rightRank;
+        }
+    }
+    return QSortFilterProxyModel::lessThan(sourceLeft, sourceRight);
+}
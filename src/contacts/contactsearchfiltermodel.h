@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <Akonadi/EntityTreeModel>
+#include <Akonadi/Item>
+#include <QHash>
+#include <QPointer>
+#include <QSortFilterProxyModel>
+
+class ContactSearchIndex;
+
+/// Filters a model of contacts with a ContactSearchIndex, sorting the matches by relevance
+class ContactSearchFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString searchText READ searchText WRITE setSearchText NOTIFY searchTextChanged)
+public:
+    enum ExtraRoles {
+        /// Position of the contact in the search results, -1 without a search
+        SearchRankRole = Akonadi::EntityTreeModel::UserRole + 10,
+    };
+    Q_ENUM(ExtraRoles)
+
+    explicit ContactSearchFilterModel(QObject *parent = nullptr);
+
+    /// The index to search, ContactSearchIndex::instance() by default
+    void setSearchIndex(ContactSearchIndex *index);
+
+    QString searchText() const;
+    void setSearchText(const QString &searchText);
+
+    QVariant data(const QModelIndex &index, int role) const override;
+
+Q_SIGNALS:
+    void searchTextChanged();
+
+protected:
+    bool filterAcceptsRow(int row, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &sourceLeft, const QModelIndex &sourceRight) const override;
+
+private:
+    bool isSearching() const;
+    void updateResults();
+
+    QPointer<ContactSearchIndex> m_index;
+    QString m_searchText;
+    QHash<Akonadi::Item::Id, int> m_ranks;
+};
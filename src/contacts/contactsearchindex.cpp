@@ -0,0 +1,337 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "contactsearchindex.h"
+
+#include "globalcontactmodel.h"
+#include <Akonadi/ContactsTreeModel>
+#include <Akonadi/EntityTreeModel>
+#include <KContacts/Addressee>
+#include <KContacts/ContactGroup>
+#include <QSet>
+
+#include <algorithm>
+
+namespace
+{
+QStringList splitWords(const QString &normalized)
+{
+    QStringList words;
+    int start = -1;
+    for (int i = 0; i <= normalized.size(); ++i) {
+        const bool isWordCharacter = i < normalized.size() && normalized.at(i).isLetterOrNumber();
+        if (isWordCharacter && start < 0) {
+            start = i;
+        } else if (!isWordCharacter && start >= 0) {
+            words << normalized.mid(start, i - start);
+            start = -1;
+        }
+    }
+    return words;
+}
+
+/// Grams a token is found by: its first one and two characters, and all of its trigrams
+QSet<QString> tokenGrams(const QString &token)
+{
+    QSet<QString> grams;
+    grams.insert(QLatin1Char('^') + token.left(1));
+    if (token.size() > 1) {
+        grams.insert(QLatin1Char('^') + token.left(2));
+    }
+    for (int i = 0; i + 3 <= token.size(); ++i) {
+        grams.insert(token.mid(i, 3));
+    }
+    return grams;
+}
+
+/// Grams a contact needs to have for a query word to match it
+QStringList queryGrams(const QString &word)
+{
+    if (word.size() < 3) {
+        return {QLatin1Char('^') + word};
+    }
+    QStringList grams;
+    for (int i = 0; i + 3 <= word.size(); ++i) {
+        grams << word.mid(i, 3);
+    }
+    return grams;
+}
+
+int matchScore(const QStringList &tokens, const QString &word)
+{
+    int score = 0;
+    for (const auto &token : tokens) {
+        if (token == word) {
+            return 3;
+        } else if (token.startsWith(word)) {
+            score = 2;
+        } else if (score == 0 && word.size() >= 3 && token.contains(word)) {
+            score = 1;
+        }
+    }
+    return score;
+}
+}
+
+ContactSearchIndex::ContactSearchIndex(QAbstractItemModel *model, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+{
+    connect(model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &parent, int first, int last) {
+        addRows(parent, first, last);
+        Q_EMIT changed();
+    });
+    connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &ContactSearchIndex::removeRows);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, &ContactSearchIndex::changed);
+    connect(model, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        updateRows(topLeft, bottomRight);
+        Q_EMIT changed();
+    });
+    connect(model, &QAbstractItemModel::modelReset, this, [this] {
+        rebuild();
+        Q_EMIT changed();
+    });
+
+    rebuild();
+}
+
+ContactSearchIndex::~ContactSearchIndex() = default;
+
+ContactSearchIndex *ContactSearchIndex::instance()
+{
+    static auto index = new ContactSearchIndex(GlobalContactModel::instance()->model());
+    return index;
+}
+
+QString ContactSearchIndex::normalize(const QString &text)
+{
+    const QString decomposed = text.normalized(QString::NormalizationForm_KD).toCaseFolded();
+    QString normalized;
+    normalized.reserve(decomposed.size());
+    for (const QChar c : decomposed) {
+        if (c.category() != QChar::Mark_NonSpacing) {
+            normalized += c;
+        }
+    }
+    return normalized;
+}
+
+int ContactSearchIndex::count() const
+{
+    return m_documentForItem.size();
+}
+
+void ContactSearchIndex::rebuild()
+{
+    m_documents.clear();
+    m_removedDocuments.clear();
+    m_freeDocuments.clear();
+    m_documentForItem.clear();
+    m_postings.clear();
+
+    const int rows = m_model->rowCount();
+    if (rows > 0) {
+        addRows({}, 0, rows - 1);
+    }
+}
+
+void ContactSearchIndex::addRows(const QModelIndex &parent, int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        const QModelIndex index = m_model->index(row, 0, parent);
+        const auto item = index.data(Akonadi::EntityTreeModel::ItemRole).value<Akonadi::Item>();
+        if (item.isValid()) {
+            insert(item);
+        }
+        const int childRows = m_model->rowCount(index);
+        if (childRows > 0) {
+            addRows(index, 0, childRows - 1);
+        }
+    }
+}
+
+void ContactSearchIndex::removeRows(const QModelIndex &parent, int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        const QModelIndex index = m_model->index(row, 0, parent);
+        const auto id = index.data(Akonadi::EntityTreeModel::ItemIdRole);
+        if (id.isValid()) {
+            remove(id.value<Akonadi::Item::Id>());
+        }
+        const int childRows = m_model->rowCount(index);
+        if (childRows > 0) {
+            removeRows(index, 0, childRows - 1);
+        }
+    }
+}
+
+void ContactSearchIndex::updateRows(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const auto item = m_model->index(row, 0, topLeft.parent()).data(Akonadi::EntityTreeModel::ItemRole).value<Akonadi::Item>();
+        if (item.isValid()) {
+            insert(item);
+        }
+    }
+}
+
+void ContactSearchIndex::insert(const Akonadi::Item &item)
+{
+    remove(item.id());
+
+    Document document;
+    document.id = item.id();
+    QSet<QString> tokens;
+    if (item.hasPayload<KContacts::Addressee>()) {
+        const auto addressee = item.payload<KContacts::Addressee>();
+        document.name = addressee.formattedName().isEmpty() ? addressee.realName() : addressee.formattedName();
+        const QStringList texts{
+            addressee.formattedName(),
+            addressee.givenName(),
+            addressee.familyName(),
+            addressee.additionalName(),
+            addressee.nickName(),
+            addressee.organization(),
+        };
+        for (const auto &text : texts) {
+            const auto words = splitWords(normalize(text));
+            tokens.unite(QSet<QString>(words.cbegin(), words.cend()));
+        }
+        const auto emails = addressee.emails();
+        for (const auto &email : emails) {
+            // The complete address too, so typing one matches it as a whole
+            const auto normalized = normalize(email);
+            const auto words = splitWords(normalized);
+            tokens.unite(QSet<QString>(words.cbegin(), words.cend()));
+            tokens.insert(normalized);
+        }
+    } else if (item.hasPayload<KContacts::ContactGroup>()) {
+        document.name = item.payload<KContacts::ContactGroup>().name();
+        const auto words = splitWords(normalize(document.name));
+        tokens.unite(QSet<QString>(words.cbegin(), words.cend()));
+    } else {
+        return;
+    }
+    tokens.remove(QString());
+    document.tokens = QStringList(tokens.cbegin(), tokens.cend());
+
+    int documentIndex;
+    if (m_freeDocuments.isEmpty()) {
+        documentIndex = m_documents.size();
+        m_documents.append(document);
+    } else {
+        documentIndex = m_freeDocuments.takeLast();
+        m_documents[documentIndex] = document;
+    }
+    m_documentForItem.insert(document.id, documentIndex);
+
+    QSet<QString> grams;
+    for (const auto &token : std::as_const(document.tokens)) {
+        grams.unite(tokenGrams(token));
+    }
+    for (const auto &gram : std::as_const(grams)) {
+        m_postings[gram].append(documentIndex);
+    }
+}
+
+void ContactSearchIndex::remove(Akonadi::Item::Id id)
+{
+    const auto it = m_documentForItem.find(id);
+    if (it == m_documentForItem.end()) {
+        return;
+    }
+    const int documentIndex = it.value();
+    m_documentForItem.erase(it);
+
+    // Searching skips removed documents, so they are only taken out of the postings once a good share of
+    // them is removed, instead of looking for each of them in the postings of all of its grams
+    m_documents[documentIndex] = Document{};
+    m_removedDocuments.append(documentIndex);
+    if (m_removedDocuments.size() > 64 && m_removedDocuments.size() * 4 > m_documents.size()) {
+        purgeRemovedDocuments();
+    }
+}
+
+void ContactSearchIndex::purgeRemovedDocuments()
+{
+    for (auto posting = m_postings.begin(); posting != m_postings.end();) {
+        const auto removed = std::remove_if(posting->begin(), posting->end(), [this](int documentIndex) {
+            return m_documents.at(documentIndex).id < 0;
+        });
+        posting->erase(removed, posting->end());
+        if (posting->isEmpty()) {
+            posting = m_postings.erase(posting);
+        } else {
+            ++posting;
+        }
+    }
+    m_freeDocuments += m_removedDocuments;
+    m_removedDocuments.clear();
+}
+
+QVector<Akonadi::Item::Id> ContactSearchIndex::search(const QString &text, int limit) const
+{
+    const auto words = splitWords(normalize(text));
+    if (words.isEmpty()) {
+        return {};
+    }
+
+    // Every match has all grams of the query, so only the documents of the rarest one need to be looked at
+    const QVector<int> *candidates = nullptr;
+    for (const auto &word : words) {
+        const auto grams = queryGrams(word);
+        for (const auto &gram : grams) {
+            const auto posting = m_postings.constFind(gram);
+            if (posting == m_postings.constEnd()) {
+                return {};
+            }
+            if (!candidates || posting->size() < candidates->size()) {
+                candidates = &posting.value();
+            }
+        }
+    }
+
+    struct Match {
+        int score;
+        const Document *document;
+    };
+    std::vector<Match> matches;
+    for (const int documentIndex : *candidates) {
+        const auto &document = m_documents.at(documentIndex);
+        if (document.id < 0) {
+            continue;
+        }
+        int score = 0;
+        for (const auto &word : words) {
+            const int wordScore = matchScore(document.tokens, word);
+            if (wordScore == 0) {
+                score = 0;
+                break;
+            }
+            score += wordScore;
+        }
+        if (score > 0) {
+            matches.push_back({score, &document});
+        }
+    }
+
+    const auto better = [](const Match &left, const Match &right) {
+        if (left.score != right.score) {
+            return left.score > right.score;
+        }
+        return left.document->name.compare(right.document->name, Qt::CaseInsensitive) < 0;
+    };
+    if (limit >= 0 && limit < int(matches.size())) {
+        std::partial_sort(matches.begin(), matches.begin() + limit, matches.end(), better);
+        matches.resize(limit);
+    } else {
+        std::sort(matches.begin(), matches.end(), better);
+    }
+
+    QVector<Akonadi::Item::Id> ids;
+    ids.reserve(matches.size());
+    for (const auto &match : matches) {
+        ids.append(match.document->id);
+    }
+    return ids;
+}
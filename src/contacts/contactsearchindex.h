@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <Akonadi/Item>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+class QAbstractItemModel;
+
+/**
+ * In-memory search index over the contacts and contact groups of an Akonadi::EntityTreeModel.
+ *
+ * Names, nicknames, organizations and email addresses are split into normalized tokens
+ * (case folded, without diacritics). Every token is indexed by its trigrams and by its
+ * first one and two characters, so a query only has to look at the contacts sharing the
+ * rarest gram of the query instead of all of them.
+ *
+ * The index follows the changes of the model, so it stays up to date with the
+ * Akonadi::ChangeRecorder of the model. Removed contacts stay in the postings until
+ * enough of them piled up to purge them all in one pass over the postings.
+ */
+class ContactSearchIndex : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ContactSearchIndex(QAbstractItemModel *model, QObject *parent = nullptr);
+    ~ContactSearchIndex() override;
+
+    /// Index over the contacts of the GlobalContactModel
+    static ContactSearchIndex *instance();
+
+    /**
+     * Returns the ids of the items matching all words of @p text, best matches first.
+     *
+     * A word matches a contact if one of its tokens is equal to, starts with or, for words
+     * of at least three characters, contains the word, in that order of preference.
+     */
+    QVector<Akonadi::Item::Id> search(const QString &text, int limit = -1) const;
+
+    int count() const;
+
+    static QString normalize(const QString &text);
+
+Q_SIGNALS:
+    /// Emitted after contacts were added, changed or removed
+    void changed();
+
+private:
+    struct Document {
+        Akonadi::Item::Id id = -1;
+        QString name;
+        QStringList tokens;
+    };
+
+    void rebuild();
+    void addRows(const QModelIndex &parent, int first, int last);
+    void removeRows(const QModelIndex &parent, int first, int last);
+    void updateRows(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+
+    void insert(const Akonadi::Item &item);
+    void remove(Akonadi::Item::Id id);
+    void purgeRemovedDocuments();
+
+    QPointer<QAbstractItemModel> m_model;
+    QVector<Document> m_documents;
+    /// Documents that were removed but are still in the postings
+    QVector<int> m_removedDocuments;
+    /// Documents that can be reused
+    QVector<int> m_freeDocuments;
+    QHash<Akonadi::Item::Id, int> m_documentForItem;
+    QHash<QString, QVector<int>> m_postings;
+};
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include "contactsmodel.h"
+#include "contactsearchfiltermodel.h"
 #include <akonadi/entitytreemodel.h>
 
 #include <Akonadi/ContactsFilterProxyModel>
@@ -12,7 +13,8 @@
 #include <KDescendantsProxyModel>
 
 ContactsModel::ContactsModel(QObject *parent)
-    : QSortFilterProxyModel(parent)
+    : DeduplicatingProxyModel(Akonadi::EntityTreeModel::ItemIdRole, parent)
+    , m_searchModel(new ContactSearchFilterModel(this))
 {
     auto sourceModel = new Akonadi::EmailAddressSelectionModel(this);
     auto filterModel = new Akonadi::ContactsFilterProxyModel(this);
@@ -26,24 +28,15 @@ ContactsModel::ContactsModel(QObject *parent)
     addresseeOnlyModel->setSourceModel(flatModel);
     addresseeOnlyModel->addMimeTypeInclusionFilter(KContacts::Addressee::mimeType());
 
-    setSourceModel(addresseeOnlyModel);
+    m_searchModel->setSourceModel(addresseeOnlyModel);
+    connect(m_searchModel, &ContactSearchFilterModel::searchTextChanged, this, &ContactsModel::searchTextChanged);
+
+    setSourceModel(m_searchModel);
     setDynamicSortFilter(true);
     setFilterCaseSensitivity(Qt::CaseInsensitive);
     sort(0);
 }
 
-bool ContactsModel::filterAcceptsRow(int row, const QModelIndex &sourceParent) const
-{
-    // Eliminate duplicate Akonadi items
-    const QModelIndex sourceIndex = sourceModel()->index(row, 0, sourceParent);
-    Q_ASSERT(sourceIndex.isValid());
-
-    auto data = sourceIndex.data(Akonadi::EntityTreeModel::ItemIdRole);
-    auto matches = match(index(0, 0), Akonadi::EntityTreeModel::ItemIdRole, data, 2, Qt::MatchExactly | Qt::MatchWrap | Qt::MatchRecursive);
-
-    return matches.length() < 1;
-}
-
 QVariant ContactsModel::data(const QModelIndex &idx, int role) const
 {
     if (role == AllEmailsRole) {
@@ -90,3 +83,15 @@ QHash<int, QByteArray> ContactsModel::roleNames() const
     roles[GidRole] = "gid";
     return roles;
 }
+
+QString ContactsModel::searchText() const
+{
+    return m_searchModel->searchText();
+}
+
+void ContactsModel::setSearchText(const QString &searchText)
+{
+    m_searchModel->setSearchText(searchText);
+    // Show the best matches first while searching
+    setSortRole(m_searchModel->searchText().trimmed().isEmpty() ? Qt::DisplayRole : int(ContactSearchFilterModel::SearchRankRole));
+}
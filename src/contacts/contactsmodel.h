@@ -3,13 +3,16 @@
 
 #pragma once
 
+#include "deduplicatingproxymodel.h"
 #include <Akonadi/EntityTreeModel>
-#include <QSortFilterProxyModel>
+
+class ContactSearchFilterModel;
 
 /// Contacts model with an email addreess
-class ContactsModel : public QSortFilterProxyModel
+class ContactsModel : public DeduplicatingProxyModel
 {
     Q_OBJECT
+    Q_PROPERTY(QString searchText READ searchText WRITE setSearchText NOTIFY searchTextChanged)
 public:
     enum ExtraRoles {
         EmailRole = Akonadi::EntityTreeModel::UserRole + 1,
@@ -22,6 +25,12 @@ public:
     QVariant data(const QModelIndex &idx, int role) const override;
     QHash<int, QByteArray> roleNames() const override;
 
-protected:
-    bool filterAcceptsRow(int row, const QModelIndex &sourceParent) const override;
+    QString searchText() const;
+    void setSearchText(const QString &searchText);
+
+Q_SIGNALS:
+    void searchTextChanged();
+
+private:
+    ContactSearchFilterModel *const m_searchModel;
 };
@@ -41,6 +41,66 @@ TapHandler {
         }
     }
 
+    // Only created once a transfer starts, and kept while it runs even if the sheet is closed
+    property Loader transferSheetLoader: Loader {
+        property bool exporting: false
+        property url url
+
+        active: false
+        onLoaded: {
+            if (exporting) {
+                item.title = i18nc("@title", "Exporting Contacts");
+                item.transfer.exportToUrl(url, handler.collection);
+            } else {
+                item.title = i18nc("@title", "Importing Contacts");
+                item.transfer.importFromUrl(url, handler.collection);
+            }
+            item.open();
+        }
+
+        sourceComponent: VCardTransferSheet {
+            parent: applicationWindow().overlay
+            onSheetOpenChanged: if (!sheetOpen && !transfer.running) {
+                transferSheetLoader.active = false;
+            }
+        }
+
+        property Connections transferConnections: Connections {
+            target: transferSheetLoader.item ? transferSheetLoader.item.transfer : null
+
+            function onFinished() {
+                if (!transferSheetLoader.item.sheetOpen) {
+                    transferSheetLoader.active = false;
+                }
+            }
+        }
+    }
+
+    property Loader vcardDialogLoader: Loader {
+        property bool exporting: false
+
+        active: false
+        onLoaded: item.open()
+
+        sourceComponent: FileDialog {
+            title: vcardDialogLoader.exporting ? i18nc("@title:window", "Export Address Book") : i18nc("@title:window", "Import Contacts")
+            nameFilters: [i18n("vCard files (*.vcf *.vcard)")]
+            selectExisting: !vcardDialogLoader.exporting
+            onAccepted: {
+                if (handler.transferSheetLoader.active) {
+                    // One transfer at a time, show the one still running
+                    handler.transferSheetLoader.item.open();
+                } else {
+                    handler.transferSheetLoader.exporting = vcardDialogLoader.exporting;
+                    handler.transferSheetLoader.url = fileUrl;
+                    handler.transferSheetLoader.active = true;
+                }
+                vcardDialogLoader.active = false;
+            }
+            onRejected: vcardDialogLoader.active = false
+        }
+    }
+
     property Component addressBookActions: Component {
         AddressBookMenu {
             parent: handler.parent
@@ -51,7 +51,8 @@ Kirigami.ScrollablePage {
         id: contactsList
         reuseItems: true
         section {
-            property: "display"
+            // Search results are sorted by relevance
+            property: ContactManager.filteredContacts.searchText.length === 0 ? "display" : ""
             criteria: ViewSection.FirstCharacter
             delegate: Kirigami.ListSectionHeader {
                 text: section
@@ -69,7 +69,7 @@ Kirigami.OverlayDrawer {
                     Layout.fillWidth: true
 
                     opacity: root.collapsed ? 0 : 1
-                    onTextChanged: Contact.ContactManager.filteredContacts.setFilterFixedString(text)
+                    onTextChanged: Contact.ContactManager.filteredContacts.searchText = text
 
                     Behavior on opacity {
                         OpacityAnimator {
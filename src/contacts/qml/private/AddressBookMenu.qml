@@ -45,6 +45,25 @@ QQC2.Menu {
             colorDialogLoader.item.open();
         }
     }
+    QQC2.MenuSeparator {
+    }
+    QQC2.MenuItem {
+        icon.name: "document-import"
+        text: i18nc("@action:inmenu", "Import contacts from vCard file…")
+        enabled: actionsPopup.collectionDetails.canCreateItems
+        onClicked: {
+            vcardDialogLoader.exporting = false;
+            vcardDialogLoader.active = true;
+        }
+    }
+    QQC2.MenuItem {
+        icon.name: "document-export"
+        text: i18nc("@action:inmenu", "Export address book as vCard file…")
+        onClicked: {
+            vcardDialogLoader.exporting = true;
+            vcardDialogLoader.active = true;
+        }
+    }
     QQC2.MenuSeparator {
         visible: collectionDetails.isResource
     }
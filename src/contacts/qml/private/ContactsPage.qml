@@ -25,7 +25,7 @@ Kirigami.ScrollablePage {
     header: Controls.Control {
         contentItem: Kirigami.SearchField {
             id: searchField
-            onTextChanged: root.model.setFilterFixedString(text)
+            onTextChanged: root.model.searchText = text
         }
     }
     property alias model: contactsList.model
@@ -35,7 +35,8 @@ Kirigami.ScrollablePage {
 
         reuseItems: true
 
-        section.property: "display"
+        // Search results are sorted by relevance
+        section.property: searchField.text.length === 0 ? "display" : ""
         section.criteria: ViewSection.FirstCharacter
         section.delegate: Kirigami.ListSectionHeader {text: section}
         clip: true
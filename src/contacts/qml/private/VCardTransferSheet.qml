@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+import QtQuick 2.15
+import QtQuick.Controls 2.15 as QQC2
+import QtQuick.Layouts 1.15
+import org.kde.kirigami 2.14 as Kirigami
+import org.kde.kalendar.contact 1.0
+
+Kirigami.OverlaySheet {
+    id: root
+
+    property string title
+    readonly property VCardTransfer transfer: VCardTransfer {}
+
+    header: Kirigami.Heading {
+        text: root.title
+    }
+
+    ColumnLayout {
+        Layout.preferredWidth: Kirigami.Units.gridUnit * 20
+
+        QQC2.ProgressBar {
+            Layout.fillWidth: true
+            from: 0
+            to: 1
+            value: Math.max(root.transfer.progress, 0)
+            indeterminate: root.transfer.running && root.transfer.progress < 0
+        }
+
+        QQC2.Label {
+            Layout.fillWidth: true
+            text: root.transfer.running
+                ? i18np("%1 contact, %2 per second", "%1 contacts, %2 per second", root.transfer.processedCount, Math.round(root.transfer.contactsPerSecond))
+                : i18np("%1 contact transferred", "%1 contacts transferred", root.transfer.processedCount)
+            visible: root.transfer.errorMessage.length === 0
+        }
+
+        Kirigami.InlineMessage {
+            Layout.fillWidth: true
+            type: Kirigami.MessageType.Error
+            text: root.transfer.errorMessage
+            visible: root.transfer.errorMessage.length > 0
+        }
+    }
+
+    footer: QQC2.DialogButtonBox {
+        standardButtons: QQC2.DialogButtonBox.Close
+        enabled: !root.transfer.running
+        onRejected: root.close()
+    }
+}
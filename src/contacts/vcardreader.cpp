@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "vcardreader.h"
+
+#include <KContacts/VCardConverter>
+#include <QIODevice>
+
+VCardReader::VCardReader(QIODevice *device)
+    : m_device(device)
+{
+}
+
+KContacts::Addressee::List VCardReader::read(int maxCount)
+{
+    QByteArray cards;
+    int count = 0;
+    while (count < maxCount && !m_device->atEnd()) {
+        QByteArray line = m_device->readLine();
+        if (m_atStart) {
+            // Files written on Windows often start with a UTF-8 byte order mark
+            m_atStart = false;
+            if (line.startsWith("\xEF\xBB\xBF")) {
+                line.remove(0, 3);
+            }
+        }
+        const QByteArray trimmed = line.trimmed();
+        if (!m_inCard) {
+            if (trimmed.compare("BEGIN:VCARD", Qt::CaseInsensitive) == 0) {
+                m_inCard = true;
+                m_card = line;
+            }
+            continue;
+        }
+
+        m_card += line;
+        if (trimmed.compare("END:VCARD", Qt::CaseInsensitive) == 0) {
+            if (!m_card.endsWith('\n')) {
+                m_card += "\r\n";
+            }
+            cards += m_card;
+            m_card.clear();
+            m_inCard = false;
+            ++count;
+        }
+    }
+
+    if (cards.isEmpty()) {
+        return {};
+    }
+    // Parsing many cards at once is much cheaper than one by one
+    KContacts::VCardConverter converter;
+    return converter.parseVCards(cards);
+}
+
+bool VCardReader::atEnd() const
+{
+    return m_device->atEnd();
+}
+
+qint64 VCardReader::position() const
+{
+    return m_device->pos();
+}
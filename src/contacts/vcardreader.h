@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <KContacts/Addressee>
+#include <QByteArray>
+
+class QIODevice;
+
+/**
+ * Reads the contacts of a vCard file in batches, so large files are never
+ * loaded into memory at once.
+ *
+ * A leading UTF-8 byte order mark is skipped, and an incomplete vCard at the
+ * end of the file is ignored.
+ */
+class VCardReader
+{
+public:
+    explicit VCardReader(QIODevice *device);
+
+    /// Reads and parses up to @p maxCount contacts, empty once the end is reached
+    KContacts::Addressee::List read(int maxCount);
+
+    bool atEnd() const;
+    /// The number of bytes read so far
+    qint64 position() const;
+
+private:
+    QIODevice *const m_device;
+    QByteArray m_card;
+    bool m_inCard = false;
+    bool m_atStart = true;
+};
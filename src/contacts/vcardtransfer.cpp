@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "vcardtransfer.h"
+#include "kalendar_contact_debug.h"
+#include "vcardreader.h"
+
+#include <Akonadi/CollectionStatistics>
+#include <Akonadi/CollectionStatisticsJob>
+#include <Akonadi/ItemCreateJob>
+#include <Akonadi/ItemFetchJob>
+#include <Akonadi/ItemFetchScope>
+#include <Akonadi/TransactionSequence>
+#include <KContacts/VCardConverter>
+#include <KLocalizedString>
+#include <QFile>
+#include <QSaveFile>
+
+// Contacts created per transaction
+static constexpr int importBatchSize = 200;
+
+VCardTransfer::VCardTransfer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+VCardTransfer::~VCardTransfer() = default;
+
+void VCardTransfer::importFromUrl(const QUrl &url, const Akonadi::Collection &collection)
+{
+    if (m_running) {
+        return;
+    }
+
+    m_importFile = std::make_unique<QFile>(url.toLocalFile());
+    if (!m_importFile->open(QIODevice::ReadOnly)) {
+        m_errorMessage = i18n("Unable to open %1: %2", url.toDisplayString(QUrl::PreferLocalFile), m_importFile->errorString());
+        Q_EMIT errorMessageChanged();
+        m_importFile.reset();
+        return;
+    }
+    m_reader = std::make_unique<VCardReader>(m_importFile.get());
+    m_collection = collection;
+    start();
+
+    importBatch(m_reader->read(importBatchSize));
+}
+
+void VCardTransfer::importBatch(const KContacts::Addressee::List &contacts)
+{
+    if (contacts.isEmpty()) {
+        finish();
+        return;
+    }
+
+    auto transaction = new Akonadi::TransactionSequence(this);
+    for (const auto &contact : contacts) {
+        Akonadi::Item item;
+        item.setMimeType(KContacts::Addressee::mimeType());
+        item.setPayload<KContacts::Addressee>(contact);
+        new Akonadi::ItemCreateJob(item, m_collection, transaction);
+    }
+
+    // Parsing is synchronous, the next batch is read now so it is ready to be sent as soon as this one is stored
+    const auto nextContacts = m_reader->read(importBatchSize);
+    const qint64 position = m_reader->position();
+    const int count = contacts.count();
+    connect(transaction, &KJob::result, this, [this, nextContacts, position, count](KJob *job) {
+        if (job->error()) {
+            qCWarning(KALENDAR_LOG) << "Error importing contacts:" << job->errorString();
+            finish(i18n("Unable to import the contacts: %1", job->errorString()));
+            return;
+        }
+        setProgress(m_importFile->size() > 0 ? qreal(position) / m_importFile->size() : 1, m_processedCount + count);
+        importBatch(nextContacts);
+    });
+}
+
+void VCardTransfer::exportToUrl(const QUrl &url, const Akonadi::Collection &collection)
+{
+    if (m_running) {
+        return;
+    }
+
+    m_exportFile = std::make_unique<QSaveFile>(url.toLocalFile());
+    if (!m_exportFile->open(QIODevice::WriteOnly)) {
+        m_errorMessage = i18n("Unable to write %1: %2", url.toDisplayString(QUrl::PreferLocalFile), m_exportFile->errorString());
+        Q_EMIT errorMessageChanged();
+        m_exportFile.reset();
+        return;
+    }
+    m_collection = collection;
+    start();
+
+    auto statisticsJob = new Akonadi::CollectionStatisticsJob(collection, this);
+    connect(statisticsJob, &KJob::result, this, [this, statisticsJob]() {
+        if (!statisticsJob->error() && m_running) {
+            m_totalCount = int(statisticsJob->statistics().count());
+            setProgress(m_totalCount > 0 ? qreal(m_fetchedCount) / m_totalCount : -1, m_processedCount);
+        }
+    });
+
+    auto job = new Akonadi::ItemFetchJob(collection, this);
+    job->fetchScope().fetchFullPayload();
+    job->setDeliveryOption(Akonadi::ItemFetchJob::EmitItemsInBatches);
+    connect(job, &Akonadi::ItemFetchJob::itemsReceived, this, [this](const Akonadi::Item::List &items) {
+        KContacts::Addressee::List contacts;
+        contacts.reserve(items.count());
+        for (const auto &item : items) {
+            // Contact groups have no vCard representation
+            if (item.hasPayload<KContacts::Addressee>()) {
+                contacts.append(item.payload<KContacts::Addressee>());
+            }
+        }
+
+        KContacts::VCardConverter converter;
+        m_exportFile->write(converter.exportVCards(contacts, KContacts::VCardConverter::v3_0));
+
+        // The progress is over all items, but only contacts are counted as transferred
+        m_fetchedCount += items.count();
+        setProgress(m_totalCount > 0 ? qreal(m_fetchedCount) / m_totalCount : -1, m_processedCount + contacts.count());
+    });
+    connect(job, &KJob::result, this, [this](KJob *job) {
+        if (job->error()) {
+            qCWarning(KALENDAR_LOG) << "Error exporting contacts:" << job->errorString();
+            m_exportFile->cancelWriting();
+            finish(i18n("Unable to export the contacts: %1", job->errorString()));
+            return;
+        }
+        if (!m_exportFile->commit()) {
+            finish(i18n("Unable to write the contacts: %1", m_exportFile->errorString()));
+            return;
+        }
+        finish();
+    });
+}
+
+void VCardTransfer::start()
+{
+    m_running = true;
+    m_totalCount = -1;
+    m_fetchedCount = 0;
+    m_errorMessage.clear();
+    m_timer.start();
+    Q_EMIT runningChanged();
+    Q_EMIT errorMessageChanged();
+    setProgress(0, 0);
+}
+
+void VCardTransfer::finish(const QString &errorMessage)
+{
+    m_reader.reset();
+    m_importFile.reset();
+    m_exportFile.reset();
+
+    if (errorMessage.isEmpty()) {
+        setProgress(1, m_processedCount);
+    } else {
+        m_errorMessage = errorMessage;
+        Q_EMIT errorMessageChanged();
+    }
+
+    m_running = false;
+    Q_EMIT runningChanged();
+    Q_EMIT finished(errorMessage.isEmpty());
+}
+
+void VCardTransfer::setProgress(qreal progress, int processedCount)
+{
+    m_progress = progress;
+    m_processedCount = processedCount;
+    Q_EMIT progressChanged();
+}
+
+bool VCardTransfer::running() const
+{
+    return m_running;
+}
+
+qreal VCardTransfer::progress() const
+{
+    return m_progress;
+}
+
+int VCardTransfer::processedCount() const
+{
+    return m_processedCount;
+}
+
+qreal VCardTransfer::contactsPerSecond() const
+{
+    const qint64 elapsed = m_timer.isValid() ? m_timer.elapsed() : 0;
+    return elapsed > 0 ? m_processedCount * 1000.0 / elapsed : 0;
+}
+
+QString VCardTransfer::errorMessage() const
+{
+    return m_errorMessage;
+}
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <Akonadi/Collection>
+#include <KContacts/Addressee>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QUrl>
+
+#include <memory>
+
+class QFile;
+class QSaveFile;
+class VCardReader;
+
+/**
+ * Imports and exports the contacts of an address book as vCard files.
+ *
+ * Files are read and written incrementally. Imported contacts are created in
+ * batches, each in its own transaction.
+ */
+class VCardTransfer : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    /// Between 0 and 1, or -1 while unknown
+    Q_PROPERTY(qreal progress READ progress NOTIFY progressChanged)
+    /// The number of contacts imported or exported, contact groups are not exported
+    Q_PROPERTY(int processedCount READ processedCount NOTIFY progressChanged)
+    Q_PROPERTY(qreal contactsPerSecond READ contactsPerSecond NOTIFY progressChanged)
+    Q_PROPERTY(QString errorMessage READ errorMessage NOTIFY errorMessageChanged)
+
+public:
+    explicit VCardTransfer(QObject *parent = nullptr);
+    ~VCardTransfer() override;
+
+    Q_INVOKABLE void importFromUrl(const QUrl &url, const Akonadi::Collection &collection);
+    Q_INVOKABLE void exportToUrl(const QUrl &url, const Akonadi::Collection &collection);
+
+    bool running() const;
+    qreal progress() const;
+    int processedCount() const;
+    qreal contactsPerSecond() const;
+    QString errorMessage() const;
+
+Q_SIGNALS:
+    void runningChanged();
+    void progressChanged();
+    void errorMessageChanged();
+    void finished(bool success);
+
+private:
+    void start();
+    void finish(const QString &errorMessage = {});
+    void importBatch(const KContacts::Addressee::List &contacts);
+    void setProgress(qreal progress, int processedCount);
+
+    Akonadi::Collection m_collection;
+    std::unique_ptr<QFile> m_importFile;
+    std::unique_ptr<VCardReader> m_reader;
+    std::unique_ptr<QSaveFile> m_exportFile;
+    QElapsedTimer m_timer;
+
+    bool m_running = false;
+    qreal m_progress = 0;
+    int m_processedCount = 0;
+    int m_fetchedCount = 0;
+    int m_totalCount = -1;
+    QString m_errorMessage;
+};
@@ -39,7 +39,9 @@ void fillRows(QVector<KalCommandBarModel::Item> &rows, const QString &title, con
         }
 
         if (uniqueActions.insert(action).second) {
-            rows.push_back(KalCommandBarModel::Item{title, action, -1});
+            const QString displayName =
+                KLocalizedString::removeAcceleratorMarker(title) + QStringLiteral(": ") + KLocalizedString::removeAcceleratorMarker(action->text());
+            rows.push_back(KalCommandBarModel::Item{title, action, -1, displayName});
         }
     }
 }
@@ -102,9 +104,7 @@ QVariant KalCommandBarModel::data(const QModelIndex &index, int role) const
     switch (role) {
     case Qt::DisplayRole:
         if (col == 0) {
-            QString groupName = KLocalizedString::removeAcceleratorMarker(entry.groupName);
-            QString actionText = KLocalizedString::removeAcceleratorMarker(entry.action->text());
-            return QString(groupName + QStringLiteral(": ") + actionText);
+            return entry.displayName;
         } else {
             return entry.action->shortcut().toString();
         }
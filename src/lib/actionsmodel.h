@@ -16,6 +16,8 @@ public:
         QString groupName;
         QAction *action = nullptr;
         int score = 0;
+        /// "Group: Action" without accelerator markers
+        QString displayName;
     };
 
     /**
@@ -57,20 +59,6 @@ public:
         return 2;
     }
 
-    /**
-     * reimplemented function to update score that is calculated by KFuzzyMatcher
-     */
-    bool setData(const QModelIndex &index, const QVariant &value, int role) override
-    {
-        if (!index.isValid())
-            return false;
-        if (role == Role::Score) {
-            auto row = index.row();
-            m_rows[row].score = value.toInt();
-        }
-        return QAbstractTableModel::setData(index, value, role);
-    }
-
     QVariant data(const QModelIndex &index, int role) const override;
 
     /**
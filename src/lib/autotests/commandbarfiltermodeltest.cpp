@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include "actionsmodel.h"
+#include "commandbarfiltermodel.h"
+#include <QAction>
+#include <QObject>
+#include <QTest>
+
+class CommandBarFilterModelTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QStringList rows(const QAbstractItemModel &model)
+    {
+        QStringList rows;
+        for (int row = 0; row < model.rowCount(); ++row) {
+            rows << model.index(row, 0).data().toString();
+        }
+        return rows;
+    }
+
+    static QStringList sorted(QStringList rows)
+    {
+        rows.sort();
+        return rows;
+    }
+
+    QAction *createAction(const QString &text, bool enabled = true)
+    {
+        auto action = new QAction(text, this);
+        action->setEnabled(enabled);
+        return action;
+    }
+
+private Q_SLOTS:
+    void testDisplayName()
+    {
+        KalCommandBarModel model;
+        model.refresh({{QStringLiteral("&File"), {createAction(QStringLiteral("&Open"))}}});
+        QCOMPARE(rows(model), QStringList{QStringLiteral("File: Open")});
+    }
+
+    void testFilter()
+    {
+        KalCommandBarModel model;
+        const auto disabled = createAction(QStringLiteral("Copy Link"));
+        model.refresh({{QStringLiteral("Edit"),
+                        {createAction(QStringLiteral("Copy")),
+                         createAction(QStringLiteral("Cut")),
+                         createAction(QStringLiteral("Paste")),
+                         createAction(QStringLiteral("Configure Shortcuts")),
+                         disabled}}});
+        // The model doesn't list disabled actions, they can get disabled after a refresh too
+        disabled->setEnabled(false);
+
+        CommandBarFilterModel filterModel;
+        filterModel.setSourceModel(&model);
+        QCOMPARE(filterModel.rowCount(), 5);
+
+        filterModel.setFilterString(QStringLiteral("c"));
+        QCOMPARE(sorted(rows(filterModel)),
+                 (QStringList{QStringLiteral("Edit: Configure Shortcuts"), QStringLiteral("Edit: Copy"), QStringLiteral("Edit: Cut")}));
+
+        // Extending the pattern only looks at the previous matches
+        filterModel.setFilterString(QStringLiteral("co"));
+        QCOMPARE(sorted(rows(filterModel)), (QStringList{QStringLiteral("Edit: Configure Shortcuts"), QStringLiteral("Edit: Copy")}));
+        filterModel.setFilterString(QStringLiteral("copy"));
+        QCOMPARE(rows(filterModel), QStringList{QStringLiteral("Edit: Copy")});
+
+        filterModel.setFilterString(QStringLiteral("paste"));
+        QCOMPARE(rows(filterModel), QStringList{QStringLiteral("Edit: Paste")});
+
+        filterModel.setFilterString({});
+        QCOMPARE(filterModel.rowCount(), 5);
+    }
+
+    void testBestMatchFirst()
+    {
+        KalCommandBarModel model;
+        model.refresh({{QStringLiteral("View"), {createAction(QStringLiteral("Show Month View")), createAction(QStringLiteral("Month"))}}});
+
+        CommandBarFilterModel filterModel;
+        filterModel.setSourceModel(&model);
+        filterModel.setFilterString(QStringLiteral("month"));
+        QCOMPARE(rows(filterModel), (QStringList{QStringLiteral("View: Month"), QStringLiteral("View: Show Month View")}));
+    }
+
+    void testRefresh()
+    {
+        KalCommandBarModel model;
+        model.refresh({{QStringLiteral("Edit"), {createAction(QStringLiteral("Copy"))}}});
+
+        CommandBarFilterModel filterModel;
+        filterModel.setSourceModel(&model);
+        filterModel.setFilterString(QStringLiteral("paste"));
+        QCOMPARE(filterModel.rowCount(), 0);
+
+        model.refresh({{QStringLiteral("Edit"), {createAction(QStringLiteral("Copy")), createAction(QStringLiteral("Paste"))}}});
+        QCOMPARE(rows(filterModel), QStringList{QStringLiteral("Edit: Paste")});
+    }
+
+    void testLastUsedFirst()
+    {
+        KalCommandBarModel model;
+        model.setLastUsedActions({QStringLiteral("Paste")});
+        model.refresh({{QStringLiteral("Edit"), {createAction(QStringLiteral("Copy")), createAction(QStringLiteral("Paste"))}}});
+
+        CommandBarFilterModel filterModel;
+        filterModel.setSourceModel(&model);
+        QCOMPARE(rows(filterModel).constFirst(), QStringLiteral("Edit: Paste"));
+    }
+};
+
+QTEST_MAIN(CommandBarFilterModelTest)
+#include "commandbarfiltermodeltest.moc"
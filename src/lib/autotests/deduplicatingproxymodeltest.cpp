@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include "deduplicatingproxymodel.h"
+#include <QObject>
+#include <QStandardItemModel>
+#include <QTest>
+
+class DeduplicatingProxyModelTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    static constexpr int idRole = Qt::UserRole + 1;
+
+    static QStandardItem *createItem(const QString &text, int id)
+    {
+        auto item = new QStandardItem(text);
+        item->setData(id, idRole);
+        return item;
+    }
+
+    static QStringList rows(const QAbstractItemModel &model)
+    {
+        QStringList rows;
+        for (int row = 0; row < model.rowCount(); ++row) {
+            rows << model.index(row, 0).data().toString();
+        }
+        rows.sort();
+        return rows;
+    }
+
+private Q_SLOTS:
+    void testDeduplication()
+    {
+        QStandardItemModel sourceModel;
+        sourceModel.appendRow(createItem(QStringLiteral("a"), 1));
+        sourceModel.appendRow(createItem(QStringLiteral("b"), 2));
+        sourceModel.appendRow(createItem(QStringLiteral("c"), 1));
+        sourceModel.appendRow(createItem(QStringLiteral("d"), 3));
+
+        DeduplicatingProxyModel model(idRole);
+        model.setSourceModel(&sourceModel);
+        QCOMPARE(rows(model), (QStringList{QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("d")}));
+
+        // Duplicates of rows that are already there are filtered out when they are inserted
+        sourceModel.appendRow(createItem(QStringLiteral("e"), 2));
+        sourceModel.appendRow(createItem(QStringLiteral("f"), 4));
+        QCOMPARE(rows(model), (QStringList{QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("d"), QStringLiteral("f")}));
+
+        // Changing data doesn't filter out the row itself
+        sourceModel.item(0)->setText(QStringLiteral("g"));
+        QCOMPARE(rows(model), (QStringList{QStringLiteral("b"), QStringLiteral("d"), QStringLiteral("f"), QStringLiteral("g")}));
+    }
+
+    void testRemovingOwner()
+    {
+        QStandardItemModel sourceModel;
+        sourceModel.appendRow(createItem(QStringLiteral("a"), 1));
+        sourceModel.appendRow(createItem(QStringLiteral("b"), 1));
+        sourceModel.appendRow(createItem(QStringLiteral("c"), 2));
+
+        DeduplicatingProxyModel model(idRole);
+        model.setSourceModel(&sourceModel);
+        QCOMPARE(rows(model), (QStringList{QStringLiteral("a"), QStringLiteral("c")}));
+
+        // The duplicate takes the place of the removed row
+        sourceModel.removeRow(0);
+        QCOMPARE(rows(model), (QStringList{QStringLiteral("b"), QStringLiteral("c")}));
+
+        sourceModel.removeRow(0);
+        QCOMPARE(rows(model), QStringList{QStringLiteral("c")});
+    }
+
+    void testReset()
+    {
+        QStandardItemModel sourceModel;
+        sourceModel.appendRow(createItem(QStringLiteral("a"), 1));
+
+        DeduplicatingProxyModel model(idRole);
+        model.setSourceModel(&sourceModel);
+        QCOMPARE(model.rowCount(), 1);
+
+        sourceModel.clear();
+        QCOMPARE(model.rowCount(), 0);
+
+        sourceModel.appendRow(createItem(QStringLiteral("b"), 1));
+        sourceModel.appendRow(createItem(QStringLiteral("c"), 1));
+        QCOMPARE(rows(model), QStringList{QStringLiteral("b")});
+    }
+};
+
+QTEST_MAIN(DeduplicatingProxyModelTest)
+#include "deduplicatingproxymodeltest.moc"
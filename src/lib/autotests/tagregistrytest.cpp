@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include "tagregistry.h"
+
+#include <KCalendarCore/Event>
+#include <QSignalSpy>
+#include <QTest>
+
+#include <algorithm>
+
+class TagRegistryTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    static Akonadi::Tag akonadiTag(Akonadi::Tag::Id id, const QString &name)
+    {
+        Akonadi::Tag tag(name);
+        tag.setId(id);
+        return tag;
+    }
+
+private Q_SLOTS:
+    void testIntern()
+    {
+        TagRegistry registry;
+        const int work = registry.intern(QStringLiteral("work"));
+        QCOMPARE(registry.intern(QStringLiteral("work")), work);
+        QCOMPARE(registry.id(QStringLiteral("work")), work);
+        QCOMPARE(registry.name(work), QStringLiteral("work"));
+        QCOMPARE(registry.id(QStringLiteral("never registered")), -1);
+
+        const auto tags = registry.intern(QStringList{QStringLiteral("work"), QStringLiteral("home"), QStringLiteral("work")});
+        QCOMPARE(tags.count(), 2);
+        QVERIFY(std::is_sorted(tags.cbegin(), tags.cend()));
+    }
+
+    void testContainsAny()
+    {
+        TagRegistry registry;
+        const auto tags = registry.intern(QStringList{QStringLiteral("sport"), QStringLiteral("family")});
+
+        QVERIFY(registry.containsAny({QStringLiteral("music"), QStringLiteral("family")}, tags));
+        QVERIFY(!registry.containsAny({QStringLiteral("music")}, tags));
+        QVERIFY(!registry.containsAny({}, tags));
+        QCOMPARE(registry.id(QStringLiteral("music")), -1);
+    }
+
+    void testIntersects()
+    {
+        TagRegistry registry;
+        const auto tags = registry.intern(QStringList{QStringLiteral("sport"), QStringLiteral("family"), QStringLiteral("work")});
+
+        QVERIFY(TagRegistry::intersects(tags, registry.intern(QStringList{QStringLiteral("music"), QStringLiteral("work")})));
+        QVERIFY(!TagRegistry::intersects(tags, registry.intern(QStringList{QStringLiteral("music")})));
+        QVERIFY(!TagRegistry::intersects(tags, {}));
+    }
+
+    void testIncidenceTagCache()
+    {
+        KCalendarCore::Event event;
+        event.setCategories({QStringLiteral("sport"), QStringLiteral("family")});
+
+        IncidenceTagCache cache;
+        const auto tags = cache.tags(event);
+        QCOMPARE(tags, TagRegistry::instance()->intern(QStringList{QStringLiteral("sport"), QStringLiteral("family")}));
+        QCOMPARE(cache.tags(event), tags);
+
+        // Changed categories are interned again
+        event.setCategories({QStringLiteral("music")});
+        QCOMPARE(cache.tags(event), TagRegistry::instance()->intern(QStringList{QStringLiteral("music")}));
+
+        event.setCategories({});
+        QVERIFY(cache.tags(event).isEmpty());
+    }
+
+    void testRename()
+    {
+        TagRegistry registry;
+        QSignalSpy tagRenamed(&registry, &TagRegistry::tagRenamed);
+
+        registry.setAkonadiTag(akonadiTag(42, QStringLiteral("holidays")));
+        const int holidays = registry.intern(QStringLiteral("holidays"));
+        QCOMPARE(tagRenamed.count(), 0);
+
+        registry.setAkonadiTag(akonadiTag(42, QStringLiteral("vacation")));
+        QCOMPARE(tagRenamed.count(), 1);
+        QCOMPARE(tagRenamed.at(0).at(0).toString(), QStringLiteral("holidays"));
+        QCOMPARE(tagRenamed.at(0).at(1).toString(), QStringLiteral("vacation"));
+
+        // Both names keep standing for themselves
+        QCOMPARE(registry.id(QStringLiteral("holidays")), holidays);
+        QCOMPARE(registry.name(holidays), QStringLiteral("holidays"));
+        const auto vacation = registry.intern(QStringList{QStringLiteral("vacation")});
+        QVERIFY(!registry.containsAny({QStringLiteral("holidays")}, vacation));
+
+        // A new tag can take over the old name without being confused with the renamed one
+        registry.setAkonadiTag(akonadiTag(43, QStringLiteral("holidays")));
+        QCOMPARE(tagRenamed.count(), 1);
+        QVERIFY(registry.containsAny({QStringLiteral("holidays")}, registry.intern(QStringList{QStringLiteral("holidays")})));
+        QVERIFY(!registry.containsAny({QStringLiteral("holidays")}, vacation));
+    }
+
+    void testRenameToExistingName()
+    {
+        TagRegistry registry;
+        QSignalSpy tagRenamed(&registry, &TagRegistry::tagRenamed);
+        const int work = registry.intern(QStringLiteral("work"));
+
+        registry.setAkonadiTag(akonadiTag(1, QStringLiteral("office")));
+        registry.setAkonadiTag(akonadiTag(1, QStringLiteral("work")));
+        QCOMPARE(tagRenamed.count(), 1);
+        QCOMPARE(registry.id(QStringLiteral("work")), work);
+
+        // Setting the same name again is no rename
+        registry.setAkonadiTag(akonadiTag(1, QStringLiteral("work")));
+        QCOMPARE(tagRenamed.count(), 1);
+    }
+};
+
+QTEST_GUILESS_MAIN(TagRegistryTest)
+#include "tagregistrytest.moc"
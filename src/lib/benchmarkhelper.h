@@ -0,0 +1,20 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#pragma once
+
+#include <QByteArray>
+#include <QTest>
+
+/**
+ * Skips the current test function if it is a benchmark and the test runs as part of the
+ * test suite, to be called from the init() slot of tests added with add_benchmark_test().
+ *
+ * Benchmarks are run by hand, by running the test directly.
+ */
+#define KALENDAR_SKIP_BENCHMARKS()                                                                                                                             \
+    do {                                                                                                                                                       \
+        if (qEnvironmentVariableIsSet("KALENDAR_SKIP_BENCHMARKS") && QByteArray(QTest::currentTestFunction()).startsWith("benchmark")) {                       \
+            QSKIP("Benchmarks are run by hand");                                                                                                               \
+        }                                                                                                                                                      \
+    } while (false)
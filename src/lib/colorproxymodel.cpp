@@ -42,6 +42,15 @@ static bool hasCompatibleMimeTypes(const Akonadi::Collection &collection)
 
     return false;
 }
+
+static bool hasColorMimeTypes(const Akonadi::Collection &collection)
+{
+    const auto mimeTypes = collection.contentMimeTypes();
+    return mimeTypes.contains(QLatin1String("application/x-vnd.akonadi.calendar.event"))
+        || mimeTypes.contains(QLatin1String("application/x-vnd.akonadi.calendar.todo"))
+        || mimeTypes.contains(QLatin1String("application/x-vnd.akonadi.calendar.journal")) || mimeTypes.contains(KContacts::Addressee::mimeType())
+        || mimeTypes.contains(KContacts::ContactGroup::mimeType());
+}
 }
 
 ColorProxyModel::ColorProxyModel(QObject *parent)
@@ -50,6 +59,87 @@ ColorProxyModel::ColorProxyModel(QObject *parent)
 {
     // Needed to read colorattribute of collections for incidence colors
     Akonadi::AttributeFactory::registerAttribute<Akonadi::CollectionColorAttribute>();
+
+    // The offline suffix follows the resources
+    connect(Akonadi::AgentManager::self(), &Akonadi::AgentManager::instanceOnline, this, [this](const Akonadi::AgentInstance &instance) {
+        invalidateResource(instance.identifier());
+    });
+}
+
+void ColorProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    if (this->sourceModel()) {
+        disconnect(this->sourceModel(), nullptr, this, nullptr);
+    }
+    m_metadataCache.clear();
+
+    // Connected before the proxy forwards the changes, so views never read stale entries
+    if (sourceModel) {
+        connect(sourceModel, &QAbstractItemModel::dataChanged, this, &ColorProxyModel::invalidateSourceRows);
+        connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this, [this]() {
+            m_metadataCache.clear();
+        });
+    }
+
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
+void ColorProxyModel::invalidateSourceRows(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const auto index = topLeft.sibling(row, 0);
+        m_metadataCache.remove(index.data(Akonadi::EntityTreeModel::CollectionIdRole).toLongLong());
+    }
+}
+
+void ColorProxyModel::invalidateResource(const QString &resource, const QModelIndex &parent)
+{
+    for (int row = 0, count = rowCount(parent); row < count; ++row) {
+        const auto idx = index(row, 0, parent);
+        const auto id = idx.data(Akonadi::EntityTreeModel::CollectionIdRole).toLongLong();
+        const auto it = m_metadataCache.constFind(id);
+        if (it != m_metadataCache.constEnd() && it->resource == resource) {
+            m_metadataCache.erase(it);
+            Q_EMIT dataChanged(idx, idx, {Qt::DisplayRole});
+        }
+        invalidateResource(resource, idx);
+    }
+}
+
+const ColorProxyModel::CollectionMetadata &ColorProxyModel::metadata(const QModelIndex &index) const
+{
+    static const CollectionMetadata noCollection;
+
+    const auto id = index.data(Akonadi::EntityTreeModel::CollectionIdRole).toLongLong();
+    const auto it = m_metadataCache.constFind(id);
+    if (it != m_metadataCache.constEnd()) {
+        return *it;
+    }
+
+    const Akonadi::Collection collection = Akonadi::CollectionUtils::fromIndex(index);
+    if (!collection.isValid()) {
+        return noCollection;
+    }
+
+    CollectionMetadata metadata;
+    metadata.resource = collection.resource();
+    metadata.isResource = Akonadi::CollectionUtils::isResource(collection);
+    metadata.hasColor = hasColorMimeTypes(collection);
+    metadata.isDefault =
+        !collection.contentMimeTypes().isEmpty() && collection.id() == m_standardCollectionId && collection.rights() & Akonadi::Collection::CanCreateItem;
+
+    if (hasCompatibleMimeTypes(collection) && collection.hasAttribute<Akonadi::EntityDisplayAttribute>()) {
+        metadata.iconName = collection.attribute<Akonadi::EntityDisplayAttribute>()->iconName();
+    }
+
+    const Akonadi::AgentInstance instance = Akonadi::AgentManager::self()->instance(collection.resource());
+    if (!instance.isOnline() && !collection.isVirtual()) {
+        metadata.displayName = i18nc("@item this is the default calendar", "%1 (Offline)", collection.displayName());
+    } else if (collection.id() == m_standardCollectionId) {
+        metadata.displayName = i18nc("@item this is the default calendar", "%1 (Default)", collection.displayName());
+    }
+
+    return *m_metadataCache.insert(collection.id(), metadata);
 }
 
 QVariant ColorProxyModel::data(const QModelIndex &index, int role) const
@@ -59,33 +149,27 @@ QVariant ColorProxyModel::data(const QModelIndex &index, int role) const
     }
 
     if (role == Qt::DecorationRole) {
-        const Akonadi::Collection collection = Akonadi::CollectionUtils::fromIndex(index);
-
-        if (hasCompatibleMimeTypes(collection)) {
-            if (collection.hasAttribute<Akonadi::EntityDisplayAttribute>() && !collection.attribute<Akonadi::EntityDisplayAttribute>()->iconName().isEmpty()) {
-                return collection.attribute<Akonadi::EntityDisplayAttribute>()->iconName();
-            }
+        const auto &iconName = metadata(index).iconName;
+        if (!iconName.isEmpty()) {
+            return iconName;
         }
     } else if (role == Qt::FontRole) {
-        const Akonadi::Collection collection = Akonadi::CollectionUtils::fromIndex(index);
-        if (!collection.contentMimeTypes().isEmpty() && collection.id() == m_standardCollectionId && collection.rights() & Akonadi::Collection::CanCreateItem) {
+        if (metadata(index).isDefault) {
             auto font = qvariant_cast<QFont>(QSortFilterProxyModel::data(index, Qt::FontRole));
             font.setBold(true);
             return font;
         }
     } else if (role == Qt::DisplayRole) {
-        const Akonadi::Collection collection = Akonadi::CollectionUtils::fromIndex(index);
-        const Akonadi::Collection::Id colId = collection.id();
-        const Akonadi::AgentInstance instance = Akonadi::AgentManager::self()->instance(collection.resource());
-
-        if (!instance.isOnline() && !collection.isVirtual()) {
-            return i18nc("@item this is the default calendar", "%1 (Offline)", collection.displayName());
-        }
-        if (colId == m_standardCollectionId) {
-            return i18nc("@item this is the default calendar", "%1 (Default)", collection.displayName());
+        const auto &displayName = metadata(index).displayName;
+        if (!displayName.isEmpty()) {
+            return displayName;
         }
     } else if (role == Qt::BackgroundRole) {
-        auto color = getCollectionColor(Akonadi::CollectionUtils::fromIndex(index));
+        if (!metadata(index).hasColor) {
+            return {};
+        }
+        const auto id = index.data(Akonadi::EntityTreeModel::CollectionIdRole).toLongLong();
+        auto color = colorCache.contains(id) ? colorCache.value(id) : getCollectionColor(Akonadi::CollectionUtils::fromIndex(index));
         // Otherwise QML will get black
         if (color.isValid()) {
             return color;
@@ -93,7 +177,7 @@ QVariant ColorProxyModel::data(const QModelIndex &index, int role) const
             return {};
         }
     } else if (role == isResource) {
-        return Akonadi::CollectionUtils::isResource(Akonadi::CollectionUtils::fromIndex(index));
+        return metadata(index).isResource;
     }
 
     return QSortFilterProxyModel::data(index, role);
@@ -116,20 +200,14 @@ QHash<int, QByteArray> ColorProxyModel::roleNames() const
 QColor ColorProxyModel::getCollectionColor(Akonadi::Collection collection) const
 {
     const auto id = collection.id();
-    auto supportsMimeType = collection.contentMimeTypes().contains(QLatin1String("application/x-vnd.akonadi.calendar.event"))
-        || collection.contentMimeTypes().contains(QLatin1String("application/x-vnd.akonadi.calendar.todo"))
-        || collection.contentMimeTypes().contains(QLatin1String("application/x-vnd.akonadi.calendar.journal"))
-        || collection.contentMimeTypes().contains(KContacts::Addressee::mimeType())
-        || collection.contentMimeTypes().contains(KContacts::ContactGroup::mimeType());
-
-    if (!supportsMimeType) {
-        return {};
-    }
-
     if (colorCache.contains(id)) {
         return colorCache[id];
     }
 
+    if (!hasColorMimeTypes(collection)) {
+        return {};
+    }
+
     if (collection.hasAttribute<Akonadi::CollectionColorAttribute>()) {
         const auto colorAttr = collection.attribute<Akonadi::CollectionColorAttribute>();
         if (colorAttr && colorAttr->color().isValid()) {
@@ -151,8 +229,8 @@ QColor ColorProxyModel::getCollectionColor(Akonadi::Collection collection) const
 
     if (!color.isValid()) {
         color.setRgb(QRandomGenerator::global()->bounded(256), QRandomGenerator::global()->bounded(256), QRandomGenerator::global()->bounded(256));
-        colorCache[id] = color;
     }
+    colorCache[id] = color;
 
     auto colorAttr = collection.attribute<Akonadi::CollectionColorAttribute>(Akonadi::Collection::AddIfMissing);
     colorAttr->setColor(color);
@@ -179,5 +257,7 @@ void ColorProxyModel::setColor(Akonadi::Collection::Id collectionId, const QColo
 
 void ColorProxyModel::setStandardCollectionId(Akonadi::Collection::Id standardCollectionId)
 {
+    m_metadataCache.remove(m_standardCollectionId);
+    m_metadataCache.remove(standardCollectionId);
     m_standardCollectionId = standardCollectionId;
 }
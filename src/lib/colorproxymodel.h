@@ -8,7 +8,12 @@
 #include <QColor>
 #include <QSortFilterProxyModel>
 
-/// Despite the name, this handles the presentation of collections including display text and icons, not just colors.
+/**
+ * Despite the name, this handles the presentation of collections including display text and icons, not just colors.
+ *
+ * The presentation of each collection is cached until the collection or its resource changes,
+ * so painting does no Akonadi or agent lookups.
+ */
 class ColorProxyModel : public QSortFilterProxyModel
 {
     Q_OBJECT
@@ -20,6 +25,7 @@ public:
     Q_ENUM(Roles);
 
     explicit ColorProxyModel(QObject *parent = nullptr);
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
     QVariant data(const QModelIndex &index, int role) const override;
     Qt::ItemFlags flags(const QModelIndex &index) const override;
     QHash<int, QByteArray> roleNames() const override;
@@ -30,7 +36,21 @@ public:
     void setStandardCollectionId(Akonadi::Collection::Id standardCollectionId);
 
 private:
+    struct CollectionMetadata {
+        QString displayName; // Empty when the source's is used
+        QString iconName; // Empty when the source's is used
+        QString resource;
+        bool isDefault = false;
+        bool isResource = false;
+        bool hasColor = false;
+    };
+
+    const CollectionMetadata &metadata(const QModelIndex &index) const;
+    void invalidateSourceRows(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void invalidateResource(const QString &resource, const QModelIndex &parent = {});
+
     mutable bool mInitDefaultCalendar;
+    mutable QHash<Akonadi::Collection::Id, CollectionMetadata> m_metadataCache;
     mutable QHash<Akonadi::Collection::Id, QColor> colorCache;
     Akonadi::Collection::Id m_standardCollectionId = -1;
 };
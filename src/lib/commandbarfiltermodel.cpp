@@ -7,9 +7,15 @@
 #include <KFuzzyMatcher>
 #include <QAction>
 
+#include <limits>
+
+static constexpr int noMatch = std::numeric_limits<int>::min();
+
 CommandBarFilterModel::CommandBarFilterModel(QObject *parent)
     : QSortFilterProxyModel(parent)
 {
+    // Best matches, or the most recently used actions without pattern, first
+    sort(0, Qt::DescendingOrder);
 }
 
 QString CommandBarFilterModel::filterString() const
@@ -22,34 +28,81 @@ void CommandBarFilterModel::setFilterString(const QString &string)
     if (m_pattern == string) {
         return;
     }
-    // MUST reset the model here, we want to repopulate
-    // invalidateFilter() will not work here
-    beginResetModel();
+
+    // A fuzzy pattern only matches a subset of what its prefixes matched
+    const bool refine = !m_pattern.isEmpty() && string.startsWith(m_pattern);
     m_pattern = string;
-    endResetModel();
+    updateScores(refine);
+    invalidate();
     Q_EMIT filterStringChanged();
 }
 
-bool CommandBarFilterModel::lessThan(const QModelIndex &sourceLeft, const QModelIndex &sourceRight) const
+void CommandBarFilterModel::setSourceModel(QAbstractItemModel *sourceModel)
 {
-    const int l = sourceLeft.data(KalCommandBarModel::Score).toInt();
-    const int r = sourceRight.data(KalCommandBarModel::Score).toInt();
-    return l < r;
+    if (this->sourceModel()) {
+        disconnect(this->sourceModel(), nullptr, this, nullptr);
+    }
+    m_scores.clear();
+
+    // Stale scores are dropped before the proxy filters the new rows, which scores them again
+    if (sourceModel) {
+        const auto clearScores = [this]() {
+            m_scores.clear();
+        };
+        connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this, clearScores);
+        connect(sourceModel, &QAbstractItemModel::rowsAboutToBeInserted, this, clearScores);
+        connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, clearScores);
+        connect(sourceModel, &QAbstractItemModel::rowsAboutToBeMoved, this, clearScores);
+        connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged, this, clearScores);
+    }
+
+    QSortFilterProxyModel::setSourceModel(sourceModel);
 }
 
-bool CommandBarFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+void CommandBarFilterModel::updateScores(bool refine) const
 {
-    if (m_pattern.isEmpty()) {
-        return true;
+    const int rowCount = sourceModel() ? sourceModel()->rowCount() : 0;
+    if (m_scores.count() != rowCount) {
+        m_scores.fill(noMatch, rowCount);
+        refine = false;
+    }
+
+    for (int row = 0; row < rowCount; ++row) {
+        if (refine && m_scores[row] == noMatch) {
+            continue;
+        }
+
+        const QModelIndex idx = sourceModel()->index(row, 0);
+        if (m_pattern.isEmpty()) {
+            m_scores[row] = idx.data(KalCommandBarModel::Score).toInt();
+            continue;
+        }
+        if (!(qvariant_cast<QAction *>(idx.data(Qt::UserRole))->isEnabled())) {
+            m_scores[row] = noMatch;
+            continue;
+        }
+
+        const QString actionName = idx.data(Qt::DisplayRole).toString();
+        const KFuzzyMatcher::Result res = KFuzzyMatcher::match(m_pattern, actionName);
+        m_scores[row] = res.matched ? res.score : noMatch;
     }
+}
 
-    const QModelIndex idx = sourceModel()->index(sourceRow, 0, sourceParent);
-    if (!(qvariant_cast<QAction *>(idx.data(Qt::UserRole))->isEnabled())) {
-        return false;
+int CommandBarFilterModel::score(int sourceRow) const
+{
+    if (m_scores.count() != sourceModel()->rowCount()) {
+        updateScores(false);
     }
+    return m_scores[sourceRow];
+}
 
-    const QString actionName = idx.data(Qt::DisplayRole).toString();
-    KFuzzyMatcher::Result res = KFuzzyMatcher::match(m_pattern, actionName);
-    sourceModel()->setData(idx, res.score, KalCommandBarModel::Score);
-    return res.matched;
+bool CommandBarFilterModel::lessThan(const QModelIndex &sourceLeft, const QModelIndex &sourceRight) const
+{
+    return score(sourceLeft.row()) < score(sourceRight.row());
+}
+
+bool CommandBarFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent)
+    return score(sourceRow) != noMatch;
 }
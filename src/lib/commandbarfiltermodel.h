@@ -4,6 +4,7 @@
 #pragma once
 
 #include <QSortFilterProxyModel>
+#include <QVector>
 
 class CommandBarFilterModel final : public QSortFilterProxyModel
 {
@@ -16,6 +17,8 @@ public:
 
     void setFilterString(const QString &string);
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
 Q_SIGNALS:
     void filterStringChanged();
 
@@ -25,5 +28,15 @@ protected:
     bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
 
 private:
+    /**
+     * Scores the source rows against the pattern. When @p refine is true only the
+     * rows that matched the previous pattern, which the current one extends, are scored again.
+     */
+    void updateScores(bool refine) const;
+    int score(int sourceRow) const;
+
     QString m_pattern;
+
+    // Scores of the source rows, the rows not matching the pattern have noMatch
+    mutable QVector<int> m_scores;
 };
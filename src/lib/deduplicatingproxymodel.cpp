@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "deduplicatingproxymodel.h"
+
+DeduplicatingProxyModel::DeduplicatingProxyModel(int deduplicationRole, QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_deduplicationRole(deduplicationRole)
+{
+}
+
+void DeduplicatingProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    if (this->sourceModel()) {
+        disconnect(this->sourceModel(), nullptr, this, nullptr);
+    }
+    m_owners.clear();
+
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+
+    if (!sourceModel) {
+        return;
+    }
+    // Connected after the base class, so duplicates are only filtered again once the proxy dropped the removed rows
+    connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &DeduplicatingProxyModel::sourceRowsAboutToBeRemoved);
+    connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &DeduplicatingProxyModel::sourceRowsRemoved);
+    connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this, [this] {
+        m_owners.clear();
+    });
+}
+
+bool DeduplicatingProxyModel::filterAcceptsRow(int row, const QModelIndex &sourceParent) const
+{
+    const QModelIndex sourceIndex = sourceModel()->index(row, 0, sourceParent);
+    Q_ASSERT(sourceIndex.isValid());
+
+    const auto value = sourceIndex.data(m_deduplicationRole);
+    if (!value.isValid()) {
+        return true;
+    }
+
+    auto it = m_owners.find(value.toString());
+    if (it == m_owners.end()) {
+        m_owners.insert(value.toString(), Owner{QPersistentModelIndex(sourceIndex)});
+        return true;
+    }
+    if (it->index == sourceIndex) {
+        return true;
+    }
+    // The owner might have changed its value in the meantime
+    if (!it->index.isValid() || it->index.data(m_deduplicationRole) != value) {
+        it->index = QPersistentModelIndex(sourceIndex);
+        return true;
+    }
+    it->hasDuplicates = true;
+    return false;
+}
+
+void DeduplicatingProxyModel::sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        forgetOwner(sourceModel()->index(row, 0, parent));
+    }
+}
+
+void DeduplicatingProxyModel::forgetOwner(const QModelIndex &sourceIndex)
+{
+    const auto value = sourceIndex.data(m_deduplicationRole);
+    if (value.isValid()) {
+        const auto it = m_owners.find(value.toString());
+        if (it != m_owners.end() && it->index == sourceIndex) {
+            m_revealDuplicates |= it->hasDuplicates;
+            m_owners.erase(it);
+        }
+    }
+
+    const int rows = sourceModel()->rowCount(sourceIndex);
+    for (int row = 0; row < rows; ++row) {
+        forgetOwner(sourceModel()->index(row, 0, sourceIndex));
+    }
+}
+
+void DeduplicatingProxyModel::sourceRowsRemoved()
+{
+    if (m_revealDuplicates) {
+        m_revealDuplicates = false;
+        invalidateFilter();
+    }
+}
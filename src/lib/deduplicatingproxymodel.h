@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <QHash>
+#include <QPersistentModelIndex>
+#include <QSortFilterProxyModel>
+
+/// Proxy model only accepting the first source row for each value of the deduplication role.
+///
+/// The source row owning a value is kept in a hash, so filtering a row doesn't need to search
+/// the already accepted rows. When the owner of a value is removed, its duplicates are filtered
+/// again so one of them can take its place.
+class DeduplicatingProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+public:
+    explicit DeduplicatingProxyModel(int deduplicationRole, QObject *parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+protected:
+    bool filterAcceptsRow(int row, const QModelIndex &sourceParent) const override;
+
+private:
+    void sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void sourceRowsRemoved();
+    void forgetOwner(const QModelIndex &sourceIndex);
+
+    struct Owner {
+        QPersistentModelIndex index;
+        bool hasDuplicates = false;
+    };
+
+    const int m_deduplicationRole;
+    mutable QHash<QString, Owner> m_owners;
+    bool m_revealDuplicates = false;
+};
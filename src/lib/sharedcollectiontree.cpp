@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include "sharedcollectiontree.h"
+#include "colorproxymodel.h"
+
+#include <Akonadi/CollectionFetchScope>
+#include <Akonadi/EntityTreeModel>
+#include <Akonadi/Monitor>
+#include <KCalendarCore/Event>
+#include <KCalendarCore/Journal>
+#include <KCalendarCore/Todo>
+#include <KContacts/Addressee>
+#include <KContacts/ContactGroup>
+
+SharedCollectionTree::SharedCollectionTree()
+    : m_monitor(new Akonadi::Monitor(this))
+{
+    m_monitor->setObjectName(QStringLiteral("SharedCollectionTreeMonitor"));
+    m_monitor->fetchCollection(true);
+    m_monitor->setCollectionMonitored(Akonadi::Collection::root());
+    // The users filter the collections by mimetype themselves
+    const QStringList mimeTypes{
+        QStringLiteral("text/calendar"),
+        KCalendarCore::Event::eventMimeType(),
+        KCalendarCore::Todo::todoMimeType(),
+        KCalendarCore::Journal::journalMimeType(),
+        KContacts::Addressee::mimeType(),
+        KContacts::ContactGroup::mimeType(),
+    };
+    for (const QString &mimeType : mimeTypes) {
+        m_monitor->setMimeTypeMonitored(mimeType, true);
+    }
+
+    m_entityTreeModel = new Akonadi::EntityTreeModel(m_monitor, this);
+    m_entityTreeModel->setItemPopulationStrategy(Akonadi::EntityTreeModel::NoItemPopulation);
+    m_entityTreeModel->setListFilter(Akonadi::CollectionFetchScope::Display);
+
+    // Display color
+    m_colorProxy = new ColorProxyModel(this);
+    m_colorProxy->setObjectName(QStringLiteral("Show collection colors"));
+    m_colorProxy->setDynamicSortFilter(true);
+    m_colorProxy->setSourceModel(m_entityTreeModel);
+}
+
+SharedCollectionTree::~SharedCollectionTree() = default;
+
+SharedCollectionTree::Ptr SharedCollectionTree::instance()
+{
+    static QWeakPointer<SharedCollectionTree> sharedTree;
+
+    auto tree = sharedTree.toStrongRef();
+    if (!tree) {
+        // Deleted later, as the last reference can go away while handling one of its signals
+        tree = Ptr(new SharedCollectionTree, &QObject::deleteLater);
+        sharedTree = tree;
+    }
+    return tree;
+}
+
+QAbstractItemModel *SharedCollectionTree::model() const
+{
+    return m_colorProxy;
+}
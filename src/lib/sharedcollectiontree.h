@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#pragma once
+
+#include <QObject>
+#include <QSharedPointer>
+
+namespace Akonadi
+{
+class EntityTreeModel;
+class Monitor;
+}
+class ColorProxyModel;
+class QAbstractItemModel;
+
+/**
+ * The tree of all Akonadi collections, without items, shared by the whole process.
+ *
+ * Collection pickers and combo boxes hold a reference to it and put their own filter
+ * proxies on top of model(), instead of each listing and monitoring all collections.
+ * The collections of calendars, tasks, journals and contacts are all monitored from the
+ * start, as changing the monitored mimetypes lists all collections again and resets every
+ * picker. The tree is destroyed with its last reference.
+ */
+class SharedCollectionTree : public QObject
+{
+    Q_OBJECT
+public:
+    using Ptr = QSharedPointer<SharedCollectionTree>;
+
+    static Ptr instance();
+    ~SharedCollectionTree() override;
+
+    /// The collections with their colors and display names, see ColorProxyModel
+    QAbstractItemModel *model() const;
+
+private:
+    SharedCollectionTree();
+
+    Akonadi::Monitor *const m_monitor;
+    Akonadi::EntityTreeModel *m_entityTreeModel = nullptr;
+    ColorProxyModel *m_colorProxy = nullptr;
+};
@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include "tagregistry.h"
+
+#include <algorithm>
+
+TagRegistry::TagRegistry(QObject *parent)
+    : QObject(parent)
+{
+}
+
+TagRegistry *TagRegistry::instance()
+{
+    static auto registry = new TagRegistry;
+    return registry;
+}
+
+int TagRegistry::intern(const QString &name)
+{
+    const auto it = m_ids.constFind(name);
+    if (it != m_ids.constEnd()) {
+        return *it;
+    }
+    const int id = m_names.count();
+    m_names.append(name);
+    m_ids.insert(name, id);
+    return id;
+}
+
+int TagRegistry::id(const QString &name) const
+{
+    return m_ids.value(name, -1);
+}
+
+QString TagRegistry::name(int id) const
+{
+    return m_names.value(id);
+}
+
+TagRegistry::TagSet TagRegistry::intern(const QStringList &names)
+{
+    TagSet tags;
+    tags.reserve(names.count());
+    for (const auto &name : names) {
+        tags.append(intern(name));
+    }
+    std::sort(tags.begin(), tags.end());
+    tags.erase(std::unique(tags.begin(), tags.end()), tags.end());
+    return tags;
+}
+
+bool TagRegistry::containsAny(const QStringList &names, const TagSet &tags) const
+{
+    return std::any_of(names.cbegin(), names.cend(), [this, &tags](const QString &name) {
+        const int tag = id(name);
+        return tag >= 0 && std::binary_search(tags.cbegin(), tags.cend(), tag);
+    });
+}
+
+bool TagRegistry::intersects(const TagSet &tags, const TagSet &otherTags)
+{
+    auto it = tags.cbegin();
+    auto otherIt = otherTags.cbegin();
+    while (it != tags.cend() && otherIt != otherTags.cend()) {
+        if (*it == *otherIt) {
+            return true;
+        }
+        if (*it < *otherIt) {
+            ++it;
+        } else {
+            ++otherIt;
+        }
+    }
+    return false;
+}
+
+void TagRegistry::setAkonadiTag(const Akonadi::Tag &tag)
+{
+    auto it = m_akonadiTags.find(tag.id());
+    if (it == m_akonadiTags.end()) {
+        m_akonadiTags.insert(tag.id(), tag.name());
+        return;
+    }
+    if (it.value() == tag.name()) {
+        return;
+    }
+    // The old name keeps its number, categories with it are still around until they are changed too
+    const QString oldName = it.value();
+    it.value() = tag.name();
+    Q_EMIT tagRenamed(oldName, tag.name());
+}
+
+const TagRegistry::TagSet &IncidenceTagCache::tags(const KCalendarCore::Incidence &incidence)
+{
+    // Comparing lists sharing their data doesn't compare the strings
+    const auto categories = incidence.categories();
+    auto &entry = m_entries[&incidence];
+    if (entry.categories != categories) {
+        entry.categories = categories;
+        entry.tags = TagRegistry::instance()->intern(categories);
+    }
+    return entry.tags;
+}
+
+void IncidenceTagCache::clear()
+{
+    m_entries.clear();
+}
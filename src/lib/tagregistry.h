@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#pragma once
+
+#include <Akonadi/Tag>
+#include <KCalendarCore/Incidence>
+#include <QHash>
+#include <QObject>
+#include <QVector>
+
+/**
+ * Interns tag and category names as small integers, so tag filters compare
+ * numbers instead of strings.
+ *
+ * Every name has its own number. Renaming an Akonadi tag doesn't change the numbers, the tag
+ * just stands for the number of its new name from then on, and tagRenamed() lets filters on
+ * the old name also match the new one.
+ */
+class TagRegistry : public QObject
+{
+    Q_OBJECT
+public:
+    /// Sorted tag numbers without duplicates
+    using TagSet = QVector<int>;
+
+    /// Normally the registry shared through instance() is used
+    explicit TagRegistry(QObject *parent = nullptr);
+
+    static TagRegistry *instance();
+
+    /// The number of @p name, registering it if needed
+    int intern(const QString &name);
+    /// The number of @p name, or -1 if it was never registered
+    int id(const QString &name) const;
+    /// The name of the tag @p id
+    QString name(int id) const;
+
+    TagSet intern(const QStringList &names);
+
+    /// Whether any of @p names is in @p tags, without registering them
+    bool containsAny(const QStringList &names, const TagSet &tags) const;
+    /// Whether @p tags and @p otherTags have a tag in common
+    static bool intersects(const TagSet &tags, const TagSet &otherTags);
+
+    /// Registers the name of an Akonadi tag, emitting tagRenamed() if the tag was known under another name
+    void setAkonadiTag(const Akonadi::Tag &tag);
+
+Q_SIGNALS:
+    void tagRenamed(const QString &oldName, const QString &newName);
+
+private:
+    QHash<QString, int> m_ids;
+    QVector<QString> m_names;
+    QHash<Akonadi::Tag::Id, QString> m_akonadiTags;
+};
+
+/**
+ * The tag numbers of the categories of incidences, interned once per incidence
+ * and again only when its categories change.
+ *
+ * Incidences are not kept alive by the cache, their categories are compared to
+ * tell a changed or a new incidence at the same address apart.
+ */
+class IncidenceTagCache
+{
+public:
+    const TagRegistry::TagSet &tags(const KCalendarCore::Incidence &incidence);
+    void clear();
+
+private:
+    struct Entry {
+        QStringList categories;
+        TagRegistry::TagSet tags;
+    };
+    QHash<const KCalendarCore::Incidence *, Entry> m_entries;
+};
@@ -3,17 +3,12 @@
 
 #include "contactimageprovider.h"
 
-#include <Akonadi/ContactSearchJob>
-#include <KIO/TransferJob>
+#include "contactphotocache.h"
+
 #include <QApplication>
-#include <QDebug>
-#include <QDir>
-#include <QFileInfo>
-#include <QStandardPaths>
 #include <QThread>
 
 #include <KLocalizedString>
-#include <kjob.h>
 
 QQuickImageResponse *ContactImageProvider::requestImageResponse(const QString &email, const QSize &requestedSize)
 {
@@ -23,15 +18,20 @@ QQuickImageResponse *ContactImageProvider::requestImageResponse(const QString &e
 ThumbnailResponse::ThumbnailResponse(QString email, QSize size)
     : m_email(std::move(email))
     , requestedSize(size)
-    , localFile(QStringLiteral("%1/contact_picture_provider/%2.png").arg(QStandardPaths::writableLocation(QStandardPaths::CacheLocation), m_email))
     , errorStr(QStringLiteral("Image request hasn't started"))
 {
-    QImage cachedImage;
-    if (cachedImage.load(localFile)) {
-        m_image = cachedImage;
+    switch (ContactPhotoCache::instance()->lookup(m_email, requestedSize, m_image)) {
+    case ContactPhotoCache::Found:
         errorStr.clear();
-        Q_EMIT finished();
+        // Nobody is connected to us yet
+        QMetaObject::invokeMethod(this, &ThumbnailResponse::finished, Qt::QueuedConnection);
+        return;
+    case ContactPhotoCache::NoPhoto:
+        errorStr = QStringLiteral("No image found");
+        QMetaObject::invokeMethod(this, &ThumbnailResponse::finished, Qt::QueuedConnection);
         return;
+    case ContactPhotoCache::NotCached:
+        break;
     }
 
     // Execute a request on the main thread asynchronously
@@ -41,105 +41,33 @@ ThumbnailResponse::ThumbnailResponse(QString email, QSize size)
 
 void ThumbnailResponse::startRequest()
 {
-    job = new Akonadi::ContactSearchJob();
-    job->setQuery(Akonadi::ContactSearchJob::Email, m_email.toLower(), Akonadi::ContactSearchJob::ExactMatch);
-
     // Runs in the main thread, not QML thread
     Q_ASSERT(QThread::currentThread() == QApplication::instance()->thread());
 
-    // Connect to any possible outcome including abandonment
-    // to make sure the QML thread is not left stuck forever.
-    connect(job, &Akonadi::ContactSearchJob::finished, this, &ThumbnailResponse::prepareResult);
+    ContactPhotoCache::instance()->fetch(m_email, requestedSize, this, [this](const QImage &image) {
+        setResult(image, image.isNull() ? QStringLiteral("No image found") : QString());
+    });
 }
 
-bool ThumbnailResponse::searchPhoto(const KContacts::AddresseeList &list)
+void ThumbnailResponse::setResult(const QImage &image, const QString &error)
 {
-    bool foundPhoto = false;
-    for (const KContacts::Addressee &addressee : list) {
-        const KContacts::Picture photo = addressee.photo();
-        if (!photo.isEmpty()) {
-            m_photo = photo;
-            foundPhoto = true;
-            break;
-        }
+    if (m_finished) {
+        return;
     }
-    return foundPhoto;
-}
-
-void ThumbnailResponse::prepareResult()
-{
-    Q_ASSERT(QThread::currentThread() == job->thread());
-    auto searchJob = static_cast<Akonadi::ContactSearchJob *>(job);
+    m_finished = true;
     {
         QWriteLocker _(&lock);
-        if (job->error() == KJob::NoError) {
-            bool ok = false;
-            const int contactSize(searchJob->contacts().size());
-            if (contactSize >= 1) {
-                if (contactSize > 1) {
-                    qWarning() << " more than 1 contact was found we return first contact";
-                }
-
-                const KContacts::Addressee addressee = searchJob->contacts().at(0);
-                if (searchPhoto(searchJob->contacts())) {
-                    // We have a data raw => we can update message
-                    if (m_photo.isIntern()) {
-                        m_image = m_photo.data();
-                        ok = true;
-                    } else {
-                        const QUrl url = QUrl::fromUserInput(m_photo.url(), QString(), QUrl::AssumeLocalFile);
-                        if (!url.isEmpty()) {
-                            if (url.isLocalFile()) {
-                                if (m_image.load(url.toLocalFile())) {
-                                    ok = true;
-                                }
-                            } else {
-                                QByteArray imageData;
-                                KIO::TransferJob *jobTransfert = KIO::get(url, KIO::NoReload);
-                                QObject::connect(jobTransfert, &KIO::TransferJob::data, [&imageData](KIO::Job *, const QByteArray &data) {
-                                    imageData.append(data);
-                                });
-                                if (jobTransfert->exec()) {
-                                    if (m_image.loadFromData(imageData)) {
-                                        ok = true;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            QString localPath = QFileInfo(localFile).absolutePath();
-            QDir dir;
-            if (!dir.exists(localPath)) {
-                dir.mkpath(localPath);
-            }
-
-            m_image.save(localFile);
-
-            if (ok) {
-                errorStr.clear();
-            } else {
-                errorStr = QStringLiteral("No image found");
-            }
-        } else if (job->error() == Akonadi::Job::UserCanceled) {
-            errorStr = i18n("Image request has been cancelled");
-        } else {
-            errorStr = job->errorString();
-            qWarning() << "ThumbnailResponse: no valid image for" << m_email << "-" << errorStr;
-        }
-        job = nullptr;
+        m_image = image;
+        errorStr = error;
     }
     Q_EMIT finished();
 }
 
 void ThumbnailResponse::doCancel()
 {
-    // Runs in the main thread, not QML thread
-    if (job) {
-        Q_ASSERT(QThread::currentThread() == job->thread());
-        job->kill();
-    }
+    // Runs in the main thread, not QML thread. The search itself is shared with other requests
+    // and keeps running, its result only ends up in the cache.
+    setResult({}, i18n("Image request has been cancelled"));
 }
 
 QQuickTextureFactory *ThumbnailResponse::textureFactory() const
@@ -5,14 +5,9 @@
 
 #include <QQuickAsyncImageProvider>
 
-#include <KContacts/Addressee>
+#include <QImage>
 #include <QReadWriteLock>
 
-namespace Akonadi
-{
-class ContactSearchJob;
-}
-
 class ThumbnailResponse : public QQuickImageResponse
 {
     Q_OBJECT
@@ -22,20 +17,18 @@ public:
 
 private Q_SLOTS:
     void startRequest();
-    void prepareResult();
     void doCancel();
 
 private:
-    bool searchPhoto(const KContacts::AddresseeList &list);
+    void setResult(const QImage &image, const QString &error);
+
     const QString m_email;
     QSize requestedSize;
-    const QString localFile;
 
     QImage m_image;
-    KContacts::Picture m_photo;
     QString errorStr;
-    Akonadi::ContactSearchJob *job = nullptr;
     mutable QReadWriteLock lock; // Guards ONLY these two members above
+    bool m_finished = false; // Only used in the main thread
 
     QQuickTextureFactory *textureFactory() const override;
     QString errorString() const override;
@@ -0,0 +1,193 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include "contactphotocache.h"
+
+#include <Akonadi/ContactSearchJob>
+#include <KContacts/Addressee>
+#include <KContacts/Picture>
+#include <KIO/StoredTransferJob>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QThread>
+
+#include <algorithm>
+
+namespace
+{
+// Addresses without a photo are searched again after this time, in case one was added
+constexpr int noPhotoTimeout = 30 * 60;
+// Photos are searched again after this time, in case the contact changed
+constexpr int photoTimeout = 24 * 60 * 60;
+constexpr int memoryCacheSizeKiB = 32 * 1024;
+
+QString cacheKey(const QString &email, const QSize &size)
+{
+    return QStringLiteral("%1 %2x%3").arg(email).arg(size.width()).arg(size.height());
+}
+}
+
+ContactPhotoCache::ContactPhotoCache(QObject *parent)
+    : QObject(parent)
+    , m_cacheDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/contact_picture_provider"))
+    , m_images(memoryCacheSizeKiB)
+{
+}
+
+ContactPhotoCache *ContactPhotoCache::instance()
+{
+    static ContactPhotoCache *cache = [] {
+        auto cache = new ContactPhotoCache;
+        // The searches are started from the main thread
+        cache->moveToThread(QCoreApplication::instance()->thread());
+        return cache;
+    }();
+    return cache;
+}
+
+QString ContactPhotoCache::localFile(const QString &email) const
+{
+    // Addresses can contain anything, including slashes
+    const auto hash = QCryptographicHash::hash(email.toUtf8(), QCryptographicHash::Sha256).toHex();
+    return QStringLiteral("%1/%2.png").arg(m_cacheDirectory, QString::fromLatin1(hash));
+}
+
+ContactPhotoCache::LookupResult ContactPhotoCache::lookup(const QString &email, const QSize &size, QImage &image)
+{
+    const QString address = email.toLower();
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto key = cacheKey(address, size);
+        if (const auto cached = m_images.object(key)) {
+            if (cached->expires > QDateTime::currentDateTimeUtc()) {
+                image = cached->image;
+                return Found;
+            }
+            m_images.remove(key);
+        }
+        const auto noPhoto = m_noPhoto.find(address);
+        if (noPhoto != m_noPhoto.end()) {
+            if (noPhoto.value() > QDateTime::currentDateTimeUtc()) {
+                return NoPhoto;
+            }
+            m_noPhoto.erase(noPhoto);
+        }
+    }
+
+    const QFileInfo file(localFile(address));
+    const auto expires = file.lastModified().toUTC().addSecs(photoTimeout);
+    QImage original;
+    if (file.exists() && expires > QDateTime::currentDateTimeUtc() && original.load(file.filePath())) {
+        image = insert(address, size, original, expires);
+        return Found;
+    }
+    return NotCached;
+}
+
+QImage ContactPhotoCache::insert(const QString &email, const QSize &size, const QImage &image, const QDateTime &expires)
+{
+    QImage scaled = image;
+    if (!size.isEmpty() && (image.width() > size.width() || image.height() > size.height())) {
+        scaled = image.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    const int cost = int(std::max<qint64>(1, scaled.sizeInBytes() / 1024));
+
+    QMutexLocker locker(&m_mutex);
+    m_images.insert(cacheKey(email, size), new CachedPhoto{scaled, expires}, cost);
+    return scaled;
+}
+
+void ContactPhotoCache::fetch(const QString &email, const QSize &size, QObject *context, const std::function<void(const QImage &)> &callback)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    const QString address = email.toLower();
+    auto &requests = m_pendingRequests[address];
+    requests.append({size, context, callback});
+    if (requests.size() > 1) {
+        // Already searching for this address
+        return;
+    }
+
+    auto job = new Akonadi::ContactSearchJob(this);
+    job->setQuery(Akonadi::ContactSearchJob::Email, address, Akonadi::ContactSearchJob::ExactMatch);
+    connect(job, &KJob::result, this, [this, job, address]() {
+        if (job->error()) {
+            qWarning() << "ContactPhotoCache: searching the contact failed for" << address << "-" << job->errorString();
+            finish(address, {}, false);
+            return;
+        }
+
+        const auto contacts = job->contacts();
+        if (contacts.size() > 1) {
+            qWarning() << "more than 1 contact was found we use the first photo";
+        }
+        for (const KContacts::Addressee &addressee : contacts) {
+            const KContacts::Picture photo = addressee.photo();
+            if (!photo.isEmpty()) {
+                loadPicture(address, photo);
+                return;
+            }
+        }
+        finish(address, {}, true);
+    });
+}
+
+void ContactPhotoCache::loadPicture(const QString &email, const KContacts::Picture &photo)
+{
+    if (photo.isIntern()) {
+        const QImage image = photo.data();
+        finish(email, image, image.isNull());
+        return;
+    }
+
+    const QUrl url = QUrl::fromUserInput(photo.url(), QString(), QUrl::AssumeLocalFile);
+    if (url.isEmpty()) {
+        finish(email, {}, true);
+        return;
+    }
+    if (url.isLocalFile()) {
+        QImage image;
+        image.load(url.toLocalFile());
+        finish(email, image, image.isNull());
+        return;
+    }
+
+    auto job = KIO::storedGet(url, KIO::NoReload, KIO::HideProgressInfo);
+    connect(job, &KJob::result, this, [this, job, email]() {
+        QImage image;
+        if (job->error()) {
+            qWarning() << "ContactPhotoCache: downloading the photo failed for" << email << "-" << job->errorString();
+        } else {
+            image.loadFromData(job->data());
+        }
+        // A failed download might work next time
+        finish(email, image, !job->error() && image.isNull());
+    });
+}
+
+void ContactPhotoCache::finish(const QString &email, const QImage &image, bool noPhoto)
+{
+    if (!image.isNull()) {
+        QDir().mkpath(m_cacheDirectory);
+        image.save(localFile(email));
+    } else if (noPhoto) {
+        // The photo might have been removed from the contact
+        QFile::remove(localFile(email));
+        QMutexLocker locker(&m_mutex);
+        m_noPhoto.insert(email, QDateTime::currentDateTimeUtc().addSecs(noPhotoTimeout));
+    }
+
+    const auto expires = QDateTime::currentDateTimeUtc().addSecs(photoTimeout);
+    const auto requests = m_pendingRequests.take(email);
+    for (const auto &request : requests) {
+        if (request.context) {
+            request.callback(image.isNull() ? QImage() : insert(email, request.size, image, expires));
+        }
+    }
+}
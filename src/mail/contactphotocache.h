@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#pragma once
+
+#include <QCache>
+#include <QDateTime>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+#include <functional>
+
+namespace KContacts
+{
+class Picture;
+}
+
+/**
+ * Photos of contacts by email address, shared by all ContactImageProvider requests.
+ *
+ * Decoded photos are kept in memory, scaled to the requested size, with the originals stored in
+ * the cache directory. Addresses without a photo are remembered for a while, so only the first
+ * request for an address searches Akonadi, and concurrent requests for it share that search.
+ * Photos are searched again after a while too, in case the contact changed.
+ */
+class ContactPhotoCache : public QObject
+{
+    Q_OBJECT
+public:
+    enum LookupResult {
+        Found,
+        NoPhoto,
+        NotCached,
+    };
+
+    /// The cache lives in the main thread
+    static ContactPhotoCache *instance();
+
+    /**
+     * Looks up the photo for @p email from memory or disk, without searching for it.
+     * This is thread-safe.
+     */
+    LookupResult lookup(const QString &email, const QSize &size, QImage &image);
+
+    /**
+     * Searches the photo for @p email and calls @p callback with it scaled to @p size, or with a
+     * null image if there is none. The callback is dropped if @p context is destroyed before.
+     * This has to be called from the main thread.
+     */
+    void fetch(const QString &email, const QSize &size, QObject *context, const std::function<void(const QImage &)> &callback);
+
+private:
+    explicit ContactPhotoCache(QObject *parent = nullptr);
+
+    struct CachedPhoto {
+        QImage image;
+        QDateTime expires;
+    };
+
+    struct Request {
+        QSize size;
+        QPointer<QObject> context;
+        std::function<void(const QImage &)> callback;
+    };
+
+    void loadPicture(const QString &email, const KContacts::Picture &photo);
+    void finish(const QString &email, const QImage &image, bool noPhoto);
+    QImage insert(const QString &email, const QSize &size, const QImage &image, const QDateTime &expires);
+    QString localFile(const QString &email) const;
+
+    const QString m_cacheDirectory;
+
+    QMutex m_mutex; // Guards the two caches below
+    QCache<QString, CachedPhoto> m_images;
+    QHash<QString, QDateTime> m_noPhoto;
+
+    QHash<QString, QVector<Request>> m_pendingRequests;
+};
@@ -10,10 +10,15 @@
 #include <gpgme.h>
 #endif
 
+#include <QCache>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QFile>
+#include <QHash>
 
+#include <chrono>
 #include <future>
+#include <mutex>
 #include <utility>
 
 using namespace Crypto;
@@ -123,30 +128,198 @@ gpgme_error_t gpgme_passphrase(void *hook, const char *uid_hint, const char *pas
     return 0;
 }
 
+namespace
+{
+// Setting up a context involves an engine check and a couple of gpgme calls. Since we verify every signed message
+// we display, contexts are kept around and reused instead.
+class ContextPool
+{
+public:
+    ~ContextPool()
+    {
+        for (auto &contexts : mContexts) {
+            for (auto context : contexts) {
+                gpgme_release(context);
+            }
+        }
+    }
+
+    std::pair<gpgme_error_t, gpgme_ctx_t> acquire(CryptoProtocol protocol)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto &contexts = mContexts[protocol];
+            if (!contexts.empty()) {
+                const auto context = contexts.back();
+                contexts.pop_back();
+                return std::make_pair(GPG_ERR_NO_ERROR, context);
+            }
+        }
+        return createForProtocol(protocol);
+    }
+
+    void release(CryptoProtocol protocol, gpgme_ctx_t context)
+    {
+        // Undo what operations might have changed, the rest is reset by the next operation
+        gpgme_signers_clear(context);
+        gpgme_set_keylist_mode(context, GPGME_KEYLIST_MODE_LOCAL);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto &contexts = mContexts[protocol];
+        if (contexts.size() < maxPooledContexts) {
+            contexts.push_back(context);
+        } else {
+            gpgme_release(context);
+        }
+    }
+
+private:
+    static constexpr std::size_t maxPooledContexts = 4;
+    std::mutex mMutex;
+    std::vector<gpgme_ctx_t> mContexts[CMS + 1];
+};
+
+ContextPool &contextPool()
+{
+    static ContextPool pool;
+    return pool;
+}
+}
+
 namespace Crypto
 {
 struct Context {
     Context(CryptoProtocol protocol = OpenPGP)
+        : protocol(protocol)
     {
         gpgme_error_t code;
-        std::tie(code, context) = createForProtocol(protocol);
+        std::tie(code, context) = contextPool().acquire(protocol);
         error = Error{code};
     }
 
     ~Context()
     {
-        gpgme_release(context);
+        if (context) {
+            contextPool().release(protocol, context);
+        }
     }
 
     operator bool() const
     {
         return !error;
     }
+    CryptoProtocol protocol;
     Error error;
     gpgme_ctx_t context;
 };
 }
 
+namespace
+{
+struct CachedVerification {
+    VerificationResult result;
+    QByteArray outdata;
+    std::chrono::steady_clock::time_point time;
+};
+
+struct CachedKeys {
+    std::vector<Key> keys;
+    std::chrono::steady_clock::time_point time;
+};
+
+// Verification results by a digest of the signature and the signed data, so displaying a message again doesn't
+// involve gpg. Importing keys can change the results, so the caches are cleared whenever that happens.
+// Keys also expire, get revoked or are changed by other applications, which we don't notice, so entries
+// are only used for a limited time.
+class VerificationCache
+{
+public:
+    static constexpr std::chrono::minutes maximumAge{5};
+
+    static QByteArray key(CryptoProtocol protocol, const QByteArray &signature, const QByteArray &signedData = {})
+    {
+        QCryptographicHash hash(QCryptographicHash::Sha256);
+        hash.addData(QByteArray::number(protocol) + ':' + QByteArray::number(signature.size()) + ':');
+        hash.addData(signature);
+        hash.addData(signedData);
+        return hash.result();
+    }
+
+    bool find(const QByteArray &key, CachedVerification &verification)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (const auto cached = mVerifications.object(key)) {
+            if (isFresh(cached->time)) {
+                verification = *cached;
+                return true;
+            }
+            mVerifications.remove(key);
+        }
+        return false;
+    }
+
+    void insert(const QByteArray &key, const CachedVerification &verification)
+    {
+        // Only cache actual results, not failures to run the verification at all
+        if (verification.result.signatures.empty()) {
+            return;
+        }
+        auto cached = new CachedVerification(verification);
+        cached->time = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(mMutex);
+        mVerifications.insert(key, cached);
+    }
+
+    bool findKeys(const QByteArray &key, std::vector<Key> &keys)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto it = mKeys.find(key);
+        if (it == mKeys.end()) {
+            return false;
+        }
+        if (!isFresh(it->time)) {
+            mKeys.erase(it);
+            return false;
+        }
+        keys = it->keys;
+        return true;
+    }
+
+    void insertKeys(const QByteArray &key, const std::vector<Key> &keys)
+    {
+        // Not finding a key is not cached, it might show up later
+        if (keys.empty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mMutex);
+        mKeys.insert(key, {keys, std::chrono::steady_clock::now()});
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mVerifications.clear();
+        mKeys.clear();
+    }
+
+private:
+    static bool isFresh(std::chrono::steady_clock::time_point time)
+    {
+        return std::chrono::steady_clock::now() - time < maximumAge;
+    }
+
+    std::mutex mMutex;
+    QCache<QByteArray, CachedVerification> mVerifications{1000};
+    QHash<QByteArray, CachedKeys> mKeys;
+};
+
+VerificationCache &verificationCache()
+{
+    static VerificationCache cache;
+    return cache;
+}
+}
+
 static QByteArray toBA(gpgme_data_t out)
 {
     size_t length = 0;
@@ -190,18 +363,59 @@ static std::vector<Signature> copySignatures(gpgme_verify_result_t result)
     return signatures;
 }
 
+static VerificationResult verifyDetached(gpgme_ctx_t ctx, const QByteArray &signature, const QByteArray &text)
+{
+    auto err = gpgme_op_verify(ctx, Data{signature}.data, Data{text}.data, nullptr);
+    gpgme_verify_result_t res = gpgme_op_verify_result(ctx);
+    return {copySignatures(res), {err}};
+}
+
 VerificationResult Crypto::verifyDetachedSignature(CryptoProtocol protocol, const QByteArray &signature, const QByteArray &text)
 {
+    const auto key = VerificationCache::key(protocol, signature, text);
+    CachedVerification cached;
+    if (verificationCache().find(key, cached)) {
+        return cached.result;
+    }
+
     Context context{protocol};
     if (!context) {
         qWarning() << "Failed to create context " << context.error;
         return {{}, context.error};
     }
-    auto ctx = context.context;
 
-    auto err = gpgme_op_verify(ctx, Data{signature}.data, Data{text}.data, nullptr);
-    gpgme_verify_result_t res = gpgme_op_verify_result(ctx);
-    return {copySignatures(res), {err}};
+    const auto result = verifyDetached(context.context, signature, text);
+    verificationCache().insert(key, {result, {}});
+    return result;
+}
+
+std::vector<VerificationResult> Crypto::verifyDetachedSignatures(CryptoProtocol protocol, const std::vector<DetachedSignature> &signatures)
+{
+    std::vector<VerificationResult> results;
+    results.reserve(signatures.size());
+
+    // Only set up a context once we know there is something left to verify
+    std::unique_ptr<Context> context;
+    for (const auto &signature : signatures) {
+        const auto key = VerificationCache::key(protocol, signature.signature, signature.signedData);
+        CachedVerification cached;
+        if (verificationCache().find(key, cached)) {
+            results.push_back(cached.result);
+            continue;
+        }
+        if (!context) {
+            context = std::make_unique<Context>(protocol);
+        }
+        if (!*context) {
+            qWarning() << "Failed to create context " << context->error;
+            results.push_back({{}, context->error});
+            continue;
+        }
+        const auto result = verifyDetached(context->context, signature.signature, signature.signedData);
+        verificationCache().insert(key, {result, {}});
+        results.push_back(result);
+    }
+    return results;
 }
 
 static DecryptionResult::Result toResult(gpgme_error_t err)
@@ -219,6 +433,13 @@ static DecryptionResult::Result toResult(gpgme_error_t err)
 
 VerificationResult Crypto::verifyOpaqueSignature(CryptoProtocol protocol, const QByteArray &signature, QByteArray &outdata)
 {
+    const auto key = VerificationCache::key(protocol, signature);
+    CachedVerification cached;
+    if (verificationCache().find(key, cached)) {
+        outdata = cached.outdata;
+        return cached.result;
+    }
+
     Context context{protocol};
     if (!context) {
         qWarning() << "Failed to create context " << context.error;
@@ -237,6 +458,7 @@ VerificationResult Crypto::verifyOpaqueSignature(CryptoProtocol protocol, const
     }
 
     outdata = toBA(out);
+    verificationCache().insert(key, {result, outdata});
     return result;
 }
 
@@ -327,6 +549,8 @@ ImportResult Crypto::importKey(CryptoProtocol protocol, const QByteArray &certDa
         qWarning() << "Import failed";
         return {0, 0, 0};
     }
+    // A new key can turn unverifiable signatures into verified ones
+    verificationCache().clear();
     if (auto result = gpgme_op_import_result(context.context)) {
         return {result->considered, result->imported, result->unchanged};
     } else {
@@ -418,6 +642,7 @@ static KeyListResult listKeys(CryptoProtocol protocol, const std::vector<const c
         if (auto err = gpgme_op_import_keys(ctx, const_cast<gpgme_key_t *>(listedKeys.data()))) {
             qWarning() << "Error while importing keys" << gpgme_strerror(err);
         }
+        verificationCache().clear();
     }
     return result;
 }
@@ -560,6 +785,16 @@ Expected<Error, std::pair<QByteArray, QString>> Crypto::sign(const QByteArray &c
 
 std::vector<Key> Crypto::findKeys(const QStringList &patterns, bool findPrivate, bool remote)
 {
+    // Looking up the signer of every message we display is common enough to remember the local single key lookups
+    const bool cacheable = patterns.size() == 1 && !findPrivate && !remote;
+    const auto cacheKey = cacheable ? patterns.first().toUtf8() : QByteArray{};
+    if (cacheable) {
+        std::vector<Key> keys;
+        if (verificationCache().findKeys(cacheKey, keys)) {
+            return keys;
+        }
+    }
+
     QByteArrayList list;
     std::transform(patterns.constBegin(), patterns.constEnd(), std::back_inserter(list), [](const QString &s) {
         return s.toUtf8();
@@ -589,6 +824,9 @@ std::vector<Key> Crypto::findKeys(const QStringList &patterns, bool findPrivate,
         }
         usableKeys.push_back(key);
     }
+    if (cacheable) {
+        verificationCache().insertKeys(cacheKey, usableKeys);
+    }
     return usableKeys;
 }
 
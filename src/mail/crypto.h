@@ -69,6 +69,11 @@ struct KeyListResult {
     Error error;
 };
 
+struct DetachedSignature {
+    QByteArray signature;
+    QByteArray signedData;
+};
+
 struct ImportResult {
     int considered;
     int imported;
@@ -94,6 +99,14 @@ std::pair<DecryptionResult, VerificationResult> decryptAndVerify(CryptoProtocol
 DecryptionResult decrypt(CryptoProtocol protocol, const QByteArray &ciphertext, QByteArray &outdata);
 VerificationResult verifyDetachedSignature(CryptoProtocol protocol, const QByteArray &signature, const QByteArray &outdata);
 VerificationResult verifyOpaqueSignature(CryptoProtocol protocol, const QByteArray &signature, QByteArray &outdata);
+
+/**
+ * Verifies all @p signatures with a single context.
+ *
+ * Verification results are cached, so verifying the signatures of a message up front makes
+ * subsequent calls to verifyDetachedSignature() for the same data cheap.
+ */
+std::vector<VerificationResult> verifyDetachedSignatures(CryptoProtocol protocol, const std::vector<DetachedSignature> &signatures);
 };
 #endif
 
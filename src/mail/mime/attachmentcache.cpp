@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include "attachmentcache.h"
+
+#include "attachmentsavejob.h"
+
+#include <KMime/Content>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+// Removed when the application quits, the caches of the single messages only create subdirectories
+Q_GLOBAL_STATIC_WITH_ARGS(QTemporaryDir, attachmentDir, (QStandardPaths::writableLocation(QStandardPaths::TempLocation) + QStringLiteral("/kalendar-XXXXXX")))
+
+AttachmentCache::AttachmentCache()
+{
+    QTemporaryDir dir(attachmentDir->path() + QStringLiteral("/message-XXXXXX"));
+    if (!dir.isValid()) {
+        qWarning() << "Failed to create a directory for attachments:" << dir.errorString();
+    }
+    dir.setAutoRemove(false);
+    mDir = dir.path();
+}
+
+AttachmentCache::~AttachmentCache() = default;
+
+bool AttachmentCache::contains(KMime::Content *node) const
+{
+    const auto it = mEntries.constFind(node);
+    return it != mEntries.constEnd() && it->complete;
+}
+
+QString AttachmentCache::filePath(KMime::Content *node, const QString &fileName)
+{
+    auto it = mEntries.find(node);
+    if (it == mEntries.end()) {
+        // Attachments can share a name, so each gets its own directory
+        const auto dir = mDir + QLatin1Char('/') + QString::number(mEntries.size());
+        QDir{}.mkpath(dir);
+        Entry entry;
+        entry.path = dir + QLatin1Char('/') + (fileName.isEmpty() ? QStringLiteral("unnamed") : fileName);
+        it = mEntries.insert(node, entry);
+    }
+    return it->path;
+}
+
+bool AttachmentCache::insert(KMime::Content *node)
+{
+    auto it = mEntries.find(node);
+    if (it == mEntries.end()) {
+        return false;
+    }
+    if (it->complete) {
+        return true;
+    }
+
+    auto file = std::make_shared<QFile>(it->path);
+    if (!file->open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open cached attachment:" << it->path << file->errorString();
+        return false;
+    }
+    it->size = file->size();
+    // Mapping an empty file fails, but there is nothing to map then anyway
+    if (it->size > 0) {
+        it->data = file->map(0, it->size);
+        if (!it->data) {
+            qWarning() << "Failed to map cached attachment:" << it->path << file->errorString();
+            return false;
+        }
+    }
+    it->file = std::move(file);
+    it->complete = true;
+    return true;
+}
+
+void AttachmentCache::decode(KMime::Content *node, QObject *context, const std::function<void(bool)> &onDecoded)
+{
+    if (contains(node)) {
+        onDecoded(true);
+        return;
+    }
+
+    QString fileName;
+    if (const auto disposition = node->contentDisposition(false)) {
+        fileName = disposition->filename();
+    }
+    if (fileName.isEmpty() && node->contentType(false)) {
+        fileName = node->contentType(false)->name();
+    }
+    const auto path = filePath(node, fileName);
+    auto &entry = mEntries[node];
+    if (!entry.job) {
+        // The job deletes itself once done
+        entry.job = new AttachmentSaveJob(node, false, path, true);
+        entry.job->start();
+    }
+    QObject::connect(entry.job, &AttachmentSaveJob::result, context, [this, node, onDecoded](bool success) {
+        onDecoded(success && insert(node));
+    });
+}
+
+QByteArray AttachmentCache::data(KMime::Content *node) const
+{
+    const auto it = mEntries.constFind(node);
+    if (it == mEntries.constEnd() || !it->complete) {
+        return {};
+    }
+    const auto &entry = *it;
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(entry.data), entry.size);
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#pragma once
+
+#include <QHash>
+#include <QPointer>
+#include <QString>
+
+#include <functional>
+#include <memory>
+
+class AttachmentSaveJob;
+class QFile;
+class QObject;
+
+namespace KMime
+{
+class Content;
+}
+
+/**
+ * Decoded attachments of a single message.
+ *
+ * Every attachment is decoded at most once into a file, which is then memory mapped. The files
+ * are used to open attachments in external applications and the mappings to display inline images.
+ *
+ * The files are kept in a directory that is only removed when the application quits, as an
+ * external application may still read an attachment after its message is no longer shown.
+ */
+class AttachmentCache
+{
+public:
+    AttachmentCache();
+    ~AttachmentCache();
+
+    /// Whether the decoded content of @p node is available
+    bool contains(KMime::Content *node) const;
+
+    /// The path of the file the decoded content of @p node is, or should be, written to
+    QString filePath(KMime::Content *node, const QString &fileName);
+
+    /// Maps the file that was completely written to filePath() for @p node
+    bool insert(KMime::Content *node);
+
+    /**
+     * Decodes @p node on a worker thread and calls @p onDecoded in the thread of @p context once done,
+     * unless @p context is gone by then. @p context must keep the cache alive.
+     *
+     * Requests for a node that is already being decoded wait for the same job.
+     */
+    void decode(KMime::Content *node, QObject *context, const std::function<void(bool success)> &onDecoded);
+
+    /**
+     * The decoded content of @p node, or an empty byte array if it isn't cached yet.
+     *
+     * The returned byte array doesn't own its data but points into the mapped file, it must
+     * not outlive the cache.
+     */
+    QByteArray data(KMime::Content *node) const;
+
+private:
+    struct Entry {
+        QString path;
+        std::shared_ptr<QFile> file;
+        const uchar *data = nullptr;
+        qint64 size = 0;
+        bool complete = false;
+        QPointer<AttachmentSaveJob> job;
+    };
+
+    QString mDir;
+    QHash<KMime::Content *, Entry> mEntries;
+};
@@ -5,6 +5,8 @@
 #include "attachmentmodel.h"
 
 #include "../mimetreeparser/objecttreeparser.h"
+#include "attachmentcache.h"
+#include "attachmentsavejob.h"
 #include <QString>
 
 #include <KLocalizedString>
@@ -14,6 +16,7 @@
 #include <QDir>
 #include <QFile>
 #include <QMimeDatabase>
+#include <QPointer>
 #include <QStandardPaths>
 #include <QUrl>
 
@@ -42,27 +45,48 @@ QString sizeHuman(float size)
 class AttachmentModelPrivate
 {
 public:
-    AttachmentModelPrivate(AttachmentModel *q_ptr, const std::shared_ptr<MimeTreeParser::ObjectTreeParser> &parser);
+    AttachmentModelPrivate(AttachmentModel *q_ptr,
+                           const std::shared_ptr<MimeTreeParser::ObjectTreeParser> &parser,
+                           const std::shared_ptr<AttachmentCache> &attachmentCache);
+
+    bool saveAttachment(MimeTreeParser::MessagePart *part, const QString &fileName, bool readonly, const std::function<void()> &onSaved = {});
+    void emitSaveChanged(MimeTreeParser::MessagePart *part);
+
+    struct Save {
+        QPointer<AttachmentSaveJob> job;
+        qreal progress = 0;
+    };
 
     AttachmentModel *q;
     std::shared_ptr<MimeTreeParser::ObjectTreeParser> mParser;
+    std::shared_ptr<AttachmentCache> mAttachmentCache;
     QVector<MimeTreeParser::MessagePartPtr> mAttachments;
+    QHash<MimeTreeParser::MessagePart *, Save> mSaves;
 };
 
-AttachmentModelPrivate::AttachmentModelPrivate(AttachmentModel *q_ptr, const std::shared_ptr<MimeTreeParser::ObjectTreeParser> &parser)
+AttachmentModelPrivate::AttachmentModelPrivate(AttachmentModel *q_ptr,
+                                               const std::shared_ptr<MimeTreeParser::ObjectTreeParser> &parser,
+                                               const std::shared_ptr<AttachmentCache> &attachmentCache)
     : q(q_ptr)
     , mParser(parser)
+    , mAttachmentCache(attachmentCache)
 {
     mAttachments = mParser->collectAttachmentParts();
 }
 
-AttachmentModel::AttachmentModel(std::shared_ptr<MimeTreeParser::ObjectTreeParser> parser)
-    : d(std::unique_ptr<AttachmentModelPrivate>(new AttachmentModelPrivate(this, parser)))
+AttachmentModel::AttachmentModel(std::shared_ptr<MimeTreeParser::ObjectTreeParser> parser, std::shared_ptr<AttachmentCache> attachmentCache)
+    : d(std::unique_ptr<AttachmentModelPrivate>(new AttachmentModelPrivate(this, parser, attachmentCache)))
 {
 }
 
 AttachmentModel::~AttachmentModel()
 {
+    // The jobs clean up after themselves once the worker thread is done
+    for (const auto &save : std::as_const(d->mSaves)) {
+        if (save.job) {
+            save.job->cancel();
+        }
+    }
 }
 
 QHash<int, QByteArray> AttachmentModel::roleNames() const
@@ -74,6 +98,8 @@ QHash<int, QByteArray> AttachmentModel::roleNames() const
         {IconRole, QByteArrayLiteral("iconName")},
         {IsEncryptedRole, QByteArrayLiteral("encrypted")},
         {IsSignedRole, QByteArrayLiteral("signed")},
+        {IsSavingRole, QByteArrayLiteral("saving")},
+        {SaveProgressRole, QByteArrayLiteral("saveProgress")},
     };
 }
 
@@ -123,61 +149,63 @@ QVariant AttachmentModel::data(const QModelIndex &index, int role) const
             return part->encryptions().size() > 0;
         case IsSignedRole:
             return part->signatures().size() > 0;
+        case IsSavingRole:
+            return d->mSaves.contains(part);
+        case SaveProgressRole:
+            return d->mSaves.value(part).progress;
         }
     }
     return QVariant();
 }
 
-static QString internalSaveAttachmentToDisk(const QModelIndex &index, const QString &path, bool readonly = false)
+void AttachmentModelPrivate::emitSaveChanged(MimeTreeParser::MessagePart *part)
 {
-    if (index.internalPointer()) {
-        const auto part = static_cast<MimeTreeParser::MessagePart *>(index.internalPointer());
-        Q_ASSERT(part);
-        auto node = part->node();
-        auto data = node->decodedContent();
-        // This is necessary to store messages embedded messages (EncapsulatedRfc822MessagePart)
-        if (data.isEmpty()) {
-            data = node->encodedContent();
-        }
-        if (part->isText()) {
-            // convert CRLF to LF before writing text attachments to disk
-            data = KMime::CRLFtoLF(data);
-        }
-        const auto name = part->filename();
-        QString fname = path + name;
-
-        // Fallback name should we end up with an empty name
-        if (name.isEmpty()) {
-            fname = path + QStringLiteral("unnamed");
-            while (QFileInfo::exists(fname)) {
-                fname = fname + QStringLiteral("_1");
-            }
+    for (int row = 0; row < mAttachments.size(); ++row) {
+        if (mAttachments.at(row).data() == part) {
+            const auto index = q->index(row, 0);
+            Q_EMIT q->dataChanged(index, index, {AttachmentModel::IsSavingRole, AttachmentModel::SaveProgressRole});
+            return;
         }
+    }
+}
 
-        // A file with that name already exists, we assume it's the right file
-        if (QFileInfo::exists(fname)) {
-            return fname;
-        }
-        QFile f(fname);
-        if (!f.open(QIODevice::ReadWrite)) {
-            qWarning() << "Failed to write attachment to file:" << fname << " Error: " << f.errorString();
-            // Kube::Fabric::Fabric{}.postMessage("notification", {{"message", QObject::tr("Failed to save attachment.")}});
-            return {};
+bool AttachmentModelPrivate::saveAttachment(MimeTreeParser::MessagePart *part, const QString &fileName, bool readonly, const std::function<void()> &onSaved)
+{
+    if (mSaves.contains(part)) {
+        qWarning() << "The attachment is already being saved:" << part->filename();
+        return false;
+    }
+
+    // The job deletes itself once done, it must not be owned by the model since we might be gone before the worker thread is done.
+    auto job = new AttachmentSaveJob(part->node(), part->isText(), fileName, readonly);
+    mSaves.insert(part, Save{job});
+    QObject::connect(job, &AttachmentSaveJob::progress, q, [this, part](qint64 processed, qint64 total) {
+        auto it = mSaves.find(part);
+        if (it != mSaves.end() && total > 0) {
+            it->progress = qreal(processed) / total;
+            emitSaveChanged(part);
         }
-        f.write(data);
-        if (readonly) {
-            // make file read-only so that nobody gets the impression that he migh edit attached files
-            f.setPermissions(QFileDevice::ReadUser);
+    });
+    QObject::connect(job, &AttachmentSaveJob::result, q, [this, part, onSaved](bool success) {
+        mSaves.remove(part);
+        emitSaveChanged(part);
+        if (success && onSaved) {
+            onSaved();
         }
-        f.close();
-        qInfo() << "Wrote attachment to file: " << fname;
-        return fname;
-    }
-    return {};
+    });
+    job->start();
+    emitSaveChanged(part);
+    return true;
 }
 
 bool AttachmentModel::saveAttachmentToDisk(const QModelIndex &index)
 {
+    if (!index.internalPointer()) {
+        return false;
+    }
+    const auto part = static_cast<MimeTreeParser::MessagePart *>(index.internalPointer());
+    Q_ASSERT(part);
+
     QString downloadDir = QStandardPaths::writableLocation(QStandardPaths::DownloadLocation);
     if (downloadDir.isEmpty()) {
         downloadDir = QStringLiteral("~");
@@ -185,28 +213,62 @@ bool AttachmentModel::saveAttachmentToDisk(const QModelIndex &index)
     downloadDir += QStringLiteral("/kalendar/");
     QDir{}.mkpath(downloadDir);
 
-    auto path = internalSaveAttachmentToDisk(index, downloadDir);
-    if (path.isEmpty()) {
-        return false;
+    const auto name = part->filename();
+    QString fname = downloadDir + name;
+
+    // Fallback name should we end up with an empty name
+    if (name.isEmpty()) {
+        fname = downloadDir + QStringLiteral("unnamed");
+        while (QFileInfo::exists(fname)) {
+            fname = fname + QStringLiteral("_1");
+        }
+    }
+
+    // A file with that name already exists, we assume it's the right file
+    if (QFileInfo::exists(fname)) {
+        return true;
     }
+
     // Kube::Fabric::Fabric{}.postMessage("notification", {{"message", tr("Saved the attachment to disk: %1").arg(path)}});
-    return true;
+    return d->saveAttachment(part, fname, false);
 }
 
 bool AttachmentModel::openAttachment(const QModelIndex &index)
 {
-    QString downloadDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation) + QStringLiteral("/kalendar/");
-    QDir{}.mkpath(downloadDir);
-    const auto filePath = internalSaveAttachmentToDisk(index, downloadDir, true);
-    if (!filePath.isEmpty()) {
+    if (!index.internalPointer()) {
+        return false;
+    }
+    const auto part = static_cast<MimeTreeParser::MessagePart *>(index.internalPointer());
+    Q_ASSERT(part);
+
+    const auto openFile = [](const QString &filePath) {
         if (!QDesktopServices::openUrl(QUrl(QStringLiteral("file://") + filePath))) {
             // Kube::Fabric::Fabric{}.postMessage("notification", {{"message", tr("Failed to open attachment.")}});
-            return false;
+            qWarning() << "Failed to open attachment:" << filePath;
         }
+    };
+
+    // Attachments are decoded once per message, opening them again just opens the same file
+    const auto node = part->node();
+    const auto filePath = d->mAttachmentCache->filePath(node, part->filename());
+    if (d->mAttachmentCache->contains(node)) {
+        openFile(filePath);
         return true;
     }
-    // Kube::Fabric::Fabric{}.postMessage("notification", {{"message", tr("Failed to save attachment for opening.")}});
-    return false;
+    return d->saveAttachment(part, filePath, true, [this, node, filePath, openFile]() {
+        if (d->mAttachmentCache->insert(node)) {
+            openFile(filePath);
+        }
+    });
+}
+
+void AttachmentModel::cancelSave(const QModelIndex &index)
+{
+    const auto part = static_cast<MimeTreeParser::MessagePart *>(index.internalPointer());
+    const auto save = d->mSaves.value(part);
+    if (save.job) {
+        save.job->cancel();
+    }
 }
 
 bool AttachmentModel::importPublicKey(const QModelIndex &index)
@@ -14,16 +14,17 @@ namespace MimeTreeParser
 class ObjectTreeParser;
 }
 class AttachmentModelPrivate;
+class AttachmentCache;
 
 class AttachmentModel : public QAbstractItemModel
 {
     Q_OBJECT
 public:
-    AttachmentModel(std::shared_ptr<MimeTreeParser::ObjectTreeParser> parser);
+    AttachmentModel(std::shared_ptr<MimeTreeParser::ObjectTreeParser> parser, std::shared_ptr<AttachmentCache> attachmentCache);
     ~AttachmentModel();
 
 public:
-    enum Roles { TypeRole = Qt::UserRole + 1, IconRole, NameRole, SizeRole, IsEncryptedRole, IsSignedRole };
+    enum Roles { TypeRole = Qt::UserRole + 1, IconRole, NameRole, SizeRole, IsEncryptedRole, IsSignedRole, IsSavingRole, SaveProgressRole };
 
     QHash<int, QByteArray> roleNames() const Q_DECL_OVERRIDE;
     QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
@@ -34,6 +35,7 @@ public:
 
     Q_INVOKABLE bool saveAttachmentToDisk(const QModelIndex &parent);
     Q_INVOKABLE bool openAttachment(const QModelIndex &index);
+    Q_INVOKABLE void cancelSave(const QModelIndex &index);
 
     Q_INVOKABLE bool importPublicKey(const QModelIndex &index);
 
@@ -0,0 +1,264 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include "attachmentsavejob.h"
+
+#include <KCodecs>
+#include <KMime/Content>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <memory>
+
+#include "async.h"
+
+namespace
+{
+// Writes chunks of decoded data to a device, optionally dropping the very last newline
+// and converting CRLF to LF on the way. Chunks are modified in place.
+class ChunkWriter
+{
+public:
+    ChunkWriter(QIODevice *device, bool crlfToLf, bool removeTrailingNewline)
+        : mDevice(device)
+        , mCrlfToLf(crlfToLf)
+        , mRemoveTrailingNewline(removeTrailingNewline)
+    {
+    }
+
+    bool write(char *data, qint64 size)
+    {
+        if (size == 0) {
+            return true;
+        }
+        if (mHeldBackNewline) {
+            // It wasn't the last newline after all
+            mHeldBackNewline = false;
+            char newline = '\n';
+            if (!convert(&newline, 1)) {
+                return false;
+            }
+        }
+        if (mRemoveTrailingNewline && size > 0 && data[size - 1] == '\n') {
+            mHeldBackNewline = true;
+            --size;
+        }
+        return convert(data, size);
+    }
+
+    bool finish()
+    {
+        if (mPendingCarriageReturn) {
+            mPendingCarriageReturn = false;
+            return writeAll("\r", 1);
+        }
+        return true;
+    }
+
+private:
+    bool convert(char *data, qint64 size)
+    {
+        if (!mCrlfToLf) {
+            return writeAll(data, size);
+        }
+        if (size == 0) {
+            return true;
+        }
+        if (mPendingCarriageReturn) {
+            mPendingCarriageReturn = false;
+            if (data[0] != '\n' && !writeAll("\r", 1)) {
+                return false;
+            }
+        }
+        qint64 out = 0;
+        for (qint64 i = 0; i < size; ++i) {
+            if (data[i] == '\r') {
+                // We only know what to do with a carriage return at the end of a chunk once we have the next one
+                if (i + 1 == size) {
+                    mPendingCarriageReturn = true;
+                    break;
+                }
+                if (data[i + 1] == '\n') {
+                    continue;
+                }
+            }
+            data[out++] = data[i];
+        }
+        return writeAll(data, out);
+    }
+
+    bool writeAll(const char *data, qint64 size)
+    {
+        return size == 0 || mDevice->write(data, size) == size;
+    }
+
+    QIODevice *mDevice;
+    bool mCrlfToLf;
+    bool mRemoveTrailingNewline;
+    bool mHeldBackNewline = false;
+    bool mPendingCarriageReturn = false;
+};
+}
+
+AttachmentSaveJob::AttachmentSaveJob(KMime::Content *node, bool isText, const QString &fileName, bool readOnly, QObject *parent)
+    : QObject(parent)
+    , mBody(node->body())
+    , mEncoding(node->contentTransferEncoding()->encoding())
+    , mIsDecoded(node->contentTransferEncoding()->isDecoded())
+    , mIsText(isText)
+    , mFileName(fileName)
+    , mReadOnly(readOnly)
+{
+    if (mBody.isEmpty()) {
+        // This is necessary to store messages embedded messages (EncapsulatedRfc822MessagePart)
+        mBody = node->encodedContent();
+        mEncoding = KMime::Headers::CEbinary;
+        mIsDecoded = false;
+    } else if (mEncoding == KMime::Headers::CEuuenc) {
+        // There is no incremental uudecode, this is rare enough to not matter
+        mBody = node->decodedContent();
+        mEncoding = KMime::Headers::CEbinary;
+        mIsDecoded = false;
+    }
+}
+
+QString AttachmentSaveJob::fileName() const
+{
+    return mFileName;
+}
+
+QString AttachmentSaveJob::errorString() const
+{
+    return mErrorString;
+}
+
+void AttachmentSaveJob::cancel()
+{
+    mCanceled = true;
+}
+
+void AttachmentSaveJob::start()
+{
+    asyncRun<bool>(
+        this,
+        [this] {
+            return run();
+        },
+        [this](bool success) {
+            Q_EMIT result(success);
+            deleteLater();
+        });
+}
+
+bool AttachmentSaveJob::exec()
+{
+    return run();
+}
+
+bool AttachmentSaveJob::run()
+{
+    // Only rename the file into place once it's complete, so a canceled or failed save doesn't leave a partial file behind
+    QSaveFile file(mFileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        mErrorString = file.errorString();
+        qWarning() << "Failed to write attachment to file:" << mFileName << " Error: " << mErrorString;
+        return false;
+    }
+    const qint64 total = mBody.size();
+    // convert CRLF to LF before writing text attachments to disk
+    const bool success = decode(mBody, mEncoding, mIsDecoded, mIsText, &file, [this, total](qint64 processed) {
+        Q_EMIT progress(processed, total);
+        return !mCanceled;
+    });
+    if (!success || !file.commit()) {
+        if (!mCanceled) {
+            mErrorString = file.errorString();
+            qWarning() << "Failed to write attachment to file:" << mFileName << " Error: " << mErrorString;
+        }
+        file.cancelWriting();
+        return false;
+    }
+    if (mReadOnly) {
+        // make file read-only so that nobody gets the impression that he migh edit attached files
+        QFile::setPermissions(mFileName, QFileDevice::ReadUser);
+    }
+    qInfo() << "Wrote attachment to file: " << mFileName;
+    return true;
+}
+
+bool AttachmentSaveJob::decode(const QByteArray &body,
+                               KMime::Headers::contentEncoding encoding,
+                               bool isDecoded,
+                               bool crlfToLf,
+                               QIODevice *device,
+                               const std::function<bool(qint64)> &progress)
+{
+    // Same as KMime::Content::decodedContent(): a decoded body, which 7bit and 8bit bodies always are,
+    // is copied as is without its last newline, and only binary bodies keep theirs
+    std::unique_ptr<KCodecs::Decoder> decoder;
+    bool removeTrailingNewline = false;
+    if (isDecoded) {
+        removeTrailingNewline = true;
+    } else {
+        switch (encoding) {
+        case KMime::Headers::CEbase64:
+            decoder.reset(KCodecs::Codec::codecForName("base64")->makeDecoder());
+            break;
+        case KMime::Headers::CEquPr:
+            decoder.reset(KCodecs::Codec::codecForName("quoted-printable")->makeDecoder());
+            removeTrailingNewline = true;
+            break;
+        case KMime::Headers::CEbinary:
+            break;
+        default:
+            removeTrailingNewline = true;
+            break;
+        }
+    }
+
+    ChunkWriter writer(device, crlfToLf, removeTrailingNewline);
+    QByteArray buffer(chunkSize, Qt::Uninitialized);
+    char *const bufferBegin = buffer.data();
+    const char *const bufferEnd = bufferBegin + buffer.size();
+
+    const char *input = body.constData();
+    const char *const inputEnd = input + body.size();
+    while (input != inputEnd) {
+        const char *const chunkEnd = input + std::min<qint64>(chunkSize, inputEnd - input);
+        const char *const chunkBegin = input;
+        char *output = bufferBegin;
+        if (decoder) {
+            decoder->decode(input, chunkEnd, output, bufferEnd);
+        } else {
+            output = std::copy(input, chunkEnd, output);
+            input = chunkEnd;
+        }
+        if (input == chunkBegin && output == bufferBegin) {
+            qWarning() << "Decoder made no progress, aborting";
+            return false;
+        }
+        if (!writer.write(bufferBegin, output - bufferBegin)) {
+            return false;
+        }
+        if (progress && !progress(input - body.constData())) {
+            return false;
+        }
+    }
+
+    if (decoder) {
+        char *output = bufferBegin;
+        while (!decoder->finish(output, bufferEnd)) {
+            if (!writer.write(bufferBegin, output - bufferBegin)) {
+                return false;
+            }
+            output = bufferBegin;
+        }
+        if (!writer.write(bufferBegin, output - bufferBegin)) {
+            return false;
+        }
+    }
+
+    return writer.finish();
+}
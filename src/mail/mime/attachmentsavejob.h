@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#pragma once
+
+#include <KMime/Headers>
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <functional>
+
+class QIODevice;
+
+namespace KMime
+{
+class Content;
+}
+
+/**
+ * Writes the decoded body of a mime part to a file on a worker thread.
+ *
+ * The body is decoded in chunks of chunkSize bytes which are written out directly, so saving
+ * a large attachment doesn't keep decoded copies of it in memory.
+ */
+class AttachmentSaveJob : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr qint64 chunkSize = 256 * 1024;
+
+    AttachmentSaveJob(KMime::Content *node, bool isText, const QString &fileName, bool readOnly, QObject *parent = nullptr);
+
+    void start();
+    /// Saves synchronously, without emitting result()
+    bool exec();
+    void cancel();
+
+    QString fileName() const;
+    QString errorString() const;
+
+    /**
+     * Decodes @p body, encoded with @p encoding unless @p isDecoded is set, and writes it to @p device chunk by chunk.
+     *
+     * This matches KMime::Content::decodedContent(), followed by KMime::CRLFtoLF() if @p crlfToLf is set.
+     * @p progress is called with the number of processed bytes of @p body after each chunk, returning
+     * false from it cancels the decoding.
+     * @return false if writing failed or was canceled
+     */
+    static bool decode(const QByteArray &body,
+                       KMime::Headers::contentEncoding encoding,
+                       bool isDecoded,
+                       bool crlfToLf,
+                       QIODevice *device,
+                       const std::function<bool(qint64)> &progress = {});
+
+Q_SIGNALS:
+    void progress(qint64 processed, qint64 total);
+    void result(bool success);
+
+private:
+    bool run();
+
+    QByteArray mBody;
+    KMime::Headers::contentEncoding mEncoding;
+    bool mIsDecoded;
+    bool mIsText;
+    QString mFileName;
+    bool mReadOnly;
+    QString mErrorString;
+    std::atomic<bool> mCanceled{false};
+};
@@ -3,12 +3,12 @@
 
 #include "htmlutils.h"
 
-#include <QMap>
 #include <QUrl>
 
 static QString resolveEntities(const QString &in)
 {
     QString out;
+    out.reserve(in.length());
 
     for (int i = 0; i < (int)in.length(); ++i) {
         if (in[i] == QLatin1Char('&')) {
@@ -41,23 +41,23 @@ static QString resolveEntities(const QString &in)
     return out;
 }
 
-static bool linkify_pmatch(const QString &str1, int at, const QString &str2)
+static bool linkify_pmatch(const QString &str1, int at, QLatin1String str2)
 {
-    if (str2.length() > (str1.length() - at))
+    if (str2.size() > (str1.length() - at))
         return false;
 
-    for (int n = 0; n < (int)str2.length(); ++n) {
-        if (str1.at(n + at).toLower() != str2.at(n).toLower())
+    for (int n = 0; n < (int)str2.size(); ++n) {
+        if (str1.at(n + at).toLower() != QLatin1Char(str2.at(n)))
             return false;
     }
 
     return true;
 }
 
-static bool linkify_isOneOf(const QChar &c, const QString &charlist)
+static bool linkify_isOneOf(const QChar &c, QLatin1String charlist)
 {
-    for (int i = 0; i < (int)charlist.length(); ++i) {
-        if (c == charlist.at(i))
+    for (int i = 0; i < (int)charlist.size(); ++i) {
+        if (c == QLatin1Char(charlist.at(i)))
             return true;
     }
 
@@ -68,9 +68,10 @@ static bool linkify_isOneOf(const QChar &c, const QString &charlist)
 static QString linkify_htmlsafe(const QString &in)
 {
     QString out;
+    out.reserve(in.length());
 
     for (int n = 0; n < in.length(); ++n) {
-        if (linkify_isOneOf(in.at(n), QStringLiteral("\"\'`<>"))) {
+        if (linkify_isOneOf(in.at(n), QLatin1String("\"\'`<>"))) {
             // hex encode
             QString hex;
             hex.asprintf("%%%02X", in.at(n).toLatin1());
@@ -109,140 +110,212 @@ static bool linkify_okEmail(const QString &addy)
     return true;
 }
 
+static bool linkify_isEmailChar(const QChar &c)
+{
+    return c.isLetterOrNumber() || linkify_isOneOf(c, QLatin1String("_.-+"));
+}
+
+// characters that terminate an url
+static bool linkify_isUrlEnd(const QString &str, int at)
+{
+    const QChar c = str.at(at);
+    if (c.isSpace() || linkify_isOneOf(c, QLatin1String("\"\'`<>"))) {
+        return true;
+    }
+    if (c == QLatin1Char('&')) {
+        return linkify_pmatch(str, at, QLatin1String("&quot;")) || linkify_pmatch(str, at, QLatin1String("&apos;"))
+            || linkify_pmatch(str, at, QLatin1String("&gt;")) || linkify_pmatch(str, at, QLatin1String("&lt;"));
+    }
+    return false;
+}
+
+namespace
+{
+enum class Prefix {
+    None,
+    Url,
+    AtStyle,
+};
+
+struct PrefixMatch {
+    Prefix kind = Prefix::None;
+    int skip = 0; // characters of the prefix that are consumed before scanning for the end of the url
+    QLatin1String href;
+};
+
+// Dispatches on the first character, so each position is compared against at most two prefixes.
+PrefixMatch linkify_matchPrefix(const QString &str, int at)
+{
+    const auto url = [](int skip, QLatin1String href = QLatin1String()) {
+        return PrefixMatch{Prefix::Url, skip, href};
+    };
+
+    switch (str.at(at).toLower().unicode()) {
+    case 'x':
+        if (linkify_pmatch(str, at, QLatin1String("xmpp:")))
+            return url(5);
+        break;
+    case 'm':
+        if (linkify_pmatch(str, at, QLatin1String("mailto:")))
+            return url(7);
+        if (linkify_pmatch(str, at, QLatin1String("magnet:")))
+            return url(7);
+        break;
+    case 'h':
+        if (linkify_pmatch(str, at, QLatin1String("http://")))
+            return url(7);
+        if (linkify_pmatch(str, at, QLatin1String("https://")))
+            return url(8);
+        break;
+    case 'f':
+        if (linkify_pmatch(str, at, QLatin1String("ftp://")))
+            return url(6);
+        if (linkify_pmatch(str, at, QLatin1String("ftp.")))
+            return url(0, QLatin1String("ftp://"));
+        break;
+    case 'n':
+        if (linkify_pmatch(str, at, QLatin1String("news://")))
+            return url(7);
+        break;
+    case 'e':
+        if (linkify_pmatch(str, at, QLatin1String("ed2k://")))
+            return url(7);
+        break;
+    case 'w':
+        if (linkify_pmatch(str, at, QLatin1String("www.")))
+            return url(0, QLatin1String("http://"));
+        break;
+    case '@':
+        return PrefixMatch{Prefix::AtStyle, 0, QLatin1String("x-psi-atstyle:")};
+    default:
+        break;
+    }
+    return {};
+}
+
+struct BracketCount {
+    int round = 0;
+    int square = 0;
+    int curly = 0;
+
+    int *counter(QChar c)
+    {
+        switch (c.unicode()) {
+        case '(':
+        case ')':
+            return &round;
+        case '[':
+        case ']':
+            return &square;
+        case '{':
+        case '}':
+            return &curly;
+        default:
+            return nullptr;
+        }
+    }
+};
+}
+
 /**
  * takes a richtext string and heuristically adds links for uris of common protocols
+ *
+ * The input is scanned once; unchanged text is copied over in spans, so the cost is
+ * linear in the input size rather than growing with the number of links found.
+ *
  * @return a richtext string with link markup added
  */
 QString HtmlUtils::linkify(const QString &in)
 {
-    QString out = in;
+    QString out;
+    out.reserve(in.length() + in.length() / 8);
+
+    // everything before this position in `in` has already been written to `out`
+    int copied = 0;
+    const auto flushUntil = [&](int pos) {
+        if (pos > copied) {
+            out.append(in.constData() + copied, pos - copied);
+            copied = pos;
+        }
+    };
+
+    const int length = in.length();
     int x1, x2;
-    QString linked, link, href;
 
-    for (int n = 0; n < (int)out.length(); ++n) {
-        bool isUrl = false;
-        bool isAtStyle = false;
+    for (int n = 0; n < length; ++n) {
         x1 = n;
-
-        if (linkify_pmatch(out, n, QStringLiteral("xmpp:"))) {
-            n += 5;
-            isUrl = true;
-            href = QString();
-        } else if (linkify_pmatch(out, n, QStringLiteral("mailto:"))) {
-            n += 7;
-            isUrl = true;
-            href = QString();
-        } else if (linkify_pmatch(out, n, QStringLiteral("http://"))) {
-            n += 7;
-            isUrl = true;
-            href = QString();
-        } else if (linkify_pmatch(out, n, QStringLiteral("https://"))) {
-            n += 8;
-            isUrl = true;
-            href = QString();
-        } else if (linkify_pmatch(out, n, QStringLiteral("ftp://"))) {
-            n += 6;
-            isUrl = true;
-            href = QString();
-        } else if (linkify_pmatch(out, n, QStringLiteral("news://"))) {
-            n += 7;
-            isUrl = true;
-            href = QString();
-        } else if (linkify_pmatch(out, n, QStringLiteral("ed2k://"))) {
-            n += 7;
-            isUrl = true;
-            href = QString();
-        } else if (linkify_pmatch(out, n, QStringLiteral("magnet:"))) {
-            n += 7;
-            isUrl = true;
-            href = QString();
-        } else if (linkify_pmatch(out, n, QStringLiteral("www."))) {
-            isUrl = true;
-            href = QStringLiteral("http://");
-        } else if (linkify_pmatch(out, n, QStringLiteral("ftp."))) {
-            isUrl = true;
-            href = QStringLiteral("ftp://");
-        } else if (linkify_pmatch(out, n, QStringLiteral("@"))) {
-            isAtStyle = true;
-            href = QStringLiteral("x-psi-atstyle:");
+        const PrefixMatch match = linkify_matchPrefix(in, n);
+        if (match.kind == Prefix::None) {
+            continue;
         }
 
-        if (isUrl) {
+        QString href = match.href;
+        n += match.skip;
+
+        if (match.kind == Prefix::Url) {
             // make sure the previous char is not alphanumeric
-            if (x1 > 0 && out.at(x1 - 1).isLetterOrNumber())
+            if (x1 > copied && in.at(x1 - 1).isLetterOrNumber())
                 continue;
 
-            // find whitespace (or end)
-            QMap<QChar, int> brackets;
-            brackets[QLatin1Char('(')] = brackets[QLatin1Char(')')] = brackets[QLatin1Char('[')] = brackets[QLatin1Char(']')] = brackets[QLatin1Char('{')] =
-                brackets[QLatin1Char('}')] = 0;
-            QMap<QChar, QChar> openingBracket;
-            openingBracket[QLatin1Char(')')] = QLatin1Char('(');
-            openingBracket[QLatin1Char(']')] = QLatin1Char('[');
-            openingBracket[QLatin1Char('}')] = QLatin1Char('{');
-            for (x2 = n; x2 < (int)out.length(); ++x2) {
-                if (out.at(x2).isSpace() || linkify_isOneOf(out.at(x2), QStringLiteral("\"\'`<>")) || linkify_pmatch(out, x2, QStringLiteral("&quot;"))
-                    || linkify_pmatch(out, x2, QStringLiteral("&apos;")) || linkify_pmatch(out, x2, QStringLiteral("&gt;"))
-                    || linkify_pmatch(out, x2, QStringLiteral("&lt;"))) {
+            // find whitespace (or end), counting brackets on the way. The closing brackets are
+            // counted together with their opening counterpart, positive for the opening one.
+            BracketCount opening, closing;
+            for (x2 = n; x2 < length; ++x2) {
+                if (linkify_isUrlEnd(in, x2)) {
                     break;
                 }
-                if (brackets.contains(out.at(x2))) {
-                    ++brackets[out.at(x2)];
+                const QChar c = in.at(x2);
+                if (int *count = linkify_isOneOf(c, QLatin1String("([{")) ? opening.counter(c) : closing.counter(c)) {
+                    ++*count;
                 }
             }
-            int len = x2 - x1;
-            QString pre = resolveEntities(out.mid(x1, x2 - x1));
+            const QString pre = resolveEntities(in.mid(x1, x2 - x1));
 
             // go backward hacking off unwanted punctuation
             int cutoff;
             for (cutoff = pre.length() - 1; cutoff >= 0; --cutoff) {
-                if (!linkify_isOneOf(pre.at(cutoff), QStringLiteral("!?,.()[]{}<>\"")))
+                const QChar c = pre.at(cutoff);
+                if (!linkify_isOneOf(c, QLatin1String("!?,.()[]{}<>\"")))
                     break;
-                if (linkify_isOneOf(pre.at(cutoff), QStringLiteral(")]}")) && brackets[pre.at(cutoff)] - brackets[openingBracket[pre.at(cutoff)]] <= 0) {
+                const bool isOpening = linkify_isOneOf(c, QLatin1String("([{"));
+                if (!isOpening && closing.counter(c) && *closing.counter(c) - *opening.counter(c) <= 0) {
                     break; // in theory, there could be == above, but these are urls, not math ;)
                 }
-                if (brackets.contains(pre.at(cutoff))) {
-                    --brackets[pre.at(cutoff)];
+                if (int *count = isOpening ? opening.counter(c) : closing.counter(c)) {
+                    --*count;
                 }
             }
             ++cutoff;
-            //++x2;
 
-            link = pre.mid(0, cutoff);
+            const QString link = pre.left(cutoff);
             if (!linkify_okUrl(link)) {
                 n = x1 + link.length();
                 continue;
             }
             href += link;
             // attributes need to be encoded too.
-            href = href.toHtmlEscaped();
-            href = linkify_htmlsafe(href);
-            // printf("link: [%s], href=[%s]\n", link.latin1(), href.latin1());
-            linked = QStringLiteral("<a href=\"%1\">").arg(href) + QUrl{link}.toDisplayString(QUrl::RemoveQuery) + QStringLiteral("</a>")
+            href = linkify_htmlsafe(href.toHtmlEscaped());
+
+            flushUntil(x1);
+            out += QLatin1String("<a href=\"") + href + QLatin1String("\">") + QUrl{link}.toDisplayString(QUrl::RemoveQuery) + QLatin1String("</a>")
                 + pre.mid(cutoff).toHtmlEscaped();
-            out.replace(x1, len, linked);
-            n = x1 + linked.length() - 1;
-        } else if (isAtStyle) {
-            // go backward till we find the beginning
+            copied = x2;
+            n = x2 - 1;
+        } else {
+            // go backward till we find the beginning, without running into an already emitted link
             if (x1 == 0)
                 continue;
-            --x1;
-            for (; x1 >= 0; --x1) {
-                if (!linkify_isOneOf(out.at(x1), QStringLiteral("_.-+")) && !out.at(x1).isLetterOrNumber())
-                    break;
+            while (x1 > copied && linkify_isEmailChar(in.at(x1 - 1))) {
+                --x1;
             }
-            ++x1;
 
             // go forward till we find the end
-            x2 = n + 1;
-            for (; x2 < (int)out.length(); ++x2) {
-                if (!linkify_isOneOf(out.at(x2), QStringLiteral("_.-+")) && !out.at(x2).isLetterOrNumber())
+            for (x2 = n + 1; x2 < length; ++x2) {
+                if (!linkify_isEmailChar(in.at(x2)))
                     break;
             }
 
-            int len = x2 - x1;
-            link = out.mid(x1, len);
-            // link = resolveEntities(link);
+            const QString link = in.mid(x1, x2 - x1);
 
             if (!linkify_okEmail(link)) {
                 n = x1 + link.length();
@@ -250,12 +323,13 @@ QString HtmlUtils::linkify(const QString &in)
             }
 
             href += link;
-            // printf("link: [%s], href=[%s]\n", link.latin1(), href.latin1());
-            linked = QStringLiteral("<a href=\"%1\">").arg(href) + link + QStringLiteral("</a>");
-            out.replace(x1, len, linked);
-            n = x1 + linked.length() - 1;
+            flushUntil(x1);
+            out += QLatin1String("<a href=\"") + href + QLatin1String("\">") + link + QLatin1String("</a>");
+            copied = x2;
+            n = x2 - 1;
         }
     }
 
+    flushUntil(length);
     return out;
 }
@@ -9,6 +9,7 @@
 #include <QElapsedTimer>
 
 #include "async.h"
+#include "attachmentcache.h"
 #include "attachmentmodel.h"
 #include "partmodel.h"
 
@@ -16,6 +17,8 @@ class MessagePartPrivate
 {
 public:
     std::shared_ptr<MimeTreeParser::ObjectTreeParser> mParser;
+    // Shared by the models of the current message, so attachments are decoded only once while it is open
+    std::shared_ptr<AttachmentCache> mAttachmentCache;
 };
 
 MessageParser::MessageParser(QObject *parent)
@@ -55,6 +58,7 @@ void MessageParser::setItem(const Akonadi::Item &item)
             parser->decryptParts();
             qDebug() << "Message parsing and decryption/verification: " << time.elapsed();
             d->mParser = parser;
+            d->mAttachmentCache = std::make_shared<AttachmentCache>();
             Q_EMIT htmlChanged();
         } else {
             qWarning() << "This is not a mime item.";
@@ -85,7 +89,7 @@ QAbstractItemModel *MessageParser::parts() const
     if (!d->mParser) {
         return nullptr;
     }
-    const auto model = new PartModel(d->mParser);
+    const auto model = new PartModel(d->mParser, d->mAttachmentCache);
     return model;
 }
 
@@ -94,6 +98,6 @@ QAbstractItemModel *MessageParser::attachments() const
     if (!d->mParser) {
         return nullptr;
     }
-    const auto model = new AttachmentModel(d->mParser);
+    const auto model = new AttachmentModel(d->mParser, d->mAttachmentCache);
     return model;
 }
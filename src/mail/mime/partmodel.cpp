@@ -4,6 +4,7 @@
 #include "partmodel.h"
 
 #include "../mimetreeparser/objecttreeparser.h"
+#include "attachmentcache.h"
 #include "htmlutils.h"
 #include <QStringLiteral>
 
@@ -11,44 +12,95 @@
 #include <QDebug>
 #include <QRegularExpression>
 
-// We return a pair containing the trimmed string, as well as a boolean indicating whether the string was trimmed or not
-std::pair<QString, bool> PartModel::trim(const QString &text)
+namespace
+{
+struct TrimDelimiter {
+    // A literal every match contains, checked before running the expression on a line
+    QLatin1String hint;
+    QRegularExpression expression;
+};
+
+// The delimiters in order of priority. They are compiled once and then only ever matched against a single line.
+const QVector<TrimDelimiter> &trimDelimiters()
 {
     // The delimiters have <p>.? prefixed including the .? because sometimes we get a byte order mark <feff> (seen with user-agent:
     // Microsoft-MacOutlook/10.1d.0.190908) We match both regulard withspace with \s and non-breaking spaces with \u00A0
-    const QList<QRegularExpression> delimiters{
-        // English
-        QRegularExpression{QStringLiteral("<p>.?-+Original(\\s|\u00A0)Message-+"), QRegularExpression::CaseInsensitiveOption},
-        // The remainder is not quoted
-        QRegularExpression{QStringLiteral("<p>.?On.*wrote:"), QRegularExpression::CaseInsensitiveOption},
-        // The remainder is quoted
-        QRegularExpression{QStringLiteral("&gt; On.*wrote:"), QRegularExpression::CaseInsensitiveOption},
-
-        // German
-        // Forwarded
-        QRegularExpression{QStringLiteral("<p>.?Von:.*</p>"), QRegularExpression::CaseInsensitiveOption},
-        // Reply
-        QRegularExpression{QStringLiteral("<p>.?Am.*schrieb.*:</p>"), QRegularExpression::CaseInsensitiveOption},
-        // Signature
-        QRegularExpression{QStringLiteral("<p>.?--(\\s|\u00A0)<br>"), QRegularExpression::CaseInsensitiveOption},
-    };
-
-    for (const auto &expression : delimiters) {
-        auto i = expression.globalMatch(text);
-        while (i.hasNext()) {
-            const auto match = i.next();
-            const int startOffset = match.capturedStart(0);
-            // This is a very simplistic detection for an inline reply where we would have the patterns before the actual message content.
-            // We simply ignore anything we find within the first few lines.
-            if (startOffset >= 5) {
-                return {text.mid(0, startOffset), true};
-            } else {
-                // Search for the next delimiter
+    static const QVector<TrimDelimiter> delimiters = [] {
+        QVector<TrimDelimiter> delimiters{
+            // English
+            {QLatin1String("original"),
+             QRegularExpression{QStringLiteral("<p>.?-+Original(\\s|\u00A0)Message-+"), QRegularExpression::CaseInsensitiveOption}},
+            // The remainder is not quoted
+            {QLatin1String("wrote:"), QRegularExpression{QStringLiteral("<p>.?On.*wrote:"), QRegularExpression::CaseInsensitiveOption}},
+            // The remainder is quoted
+            {QLatin1String("wrote:"), QRegularExpression{QStringLiteral("&gt; On.*wrote:"), QRegularExpression::CaseInsensitiveOption}},
+
+            // German
+            // Forwarded
+            {QLatin1String("von:"), QRegularExpression{QStringLiteral("<p>.?Von:.*</p>"), QRegularExpression::CaseInsensitiveOption}},
+            // Reply
+            {QLatin1String("schrieb"), QRegularExpression{QStringLiteral("<p>.?Am.*schrieb.*:</p>"), QRegularExpression::CaseInsensitiveOption}},
+            // Signature
+            {QLatin1String("--"), QRegularExpression{QStringLiteral("<p>.?--(\\s|\u00A0)<br>"), QRegularExpression::CaseInsensitiveOption}},
+        };
+        for (auto &delimiter : delimiters) {
+            delimiter.expression.optimize();
+        }
+        return delimiters;
+    }();
+    return delimiters;
+}
+}
+
+// We return a pair containing the trimmed string, as well as a boolean indicating whether the string was trimmed or not
+//
+// The text is scanned line by line and only once: for every line we only try the delimiters that have a higher priority than the
+// best match found so far, and only when the line contains the literal part of the delimiter. Since '.' doesn't match line breaks,
+// this gives the same result as matching each expression against the whole text.
+std::pair<QString, bool> PartModel::trim(const QString &text)
+{
+    const auto &delimiters = trimDelimiters();
+
+    int bestDelimiter = delimiters.size();
+    int bestOffset = -1;
+
+    int lineStart = 0;
+    while (lineStart < text.length() && bestDelimiter > 0) {
+        int lineEnd = text.indexOf(QLatin1Char('\n'), lineStart);
+        if (lineEnd < 0) {
+            lineEnd = text.length();
+        }
+        const auto line = QStringView(text).mid(lineStart, lineEnd - lineStart);
+
+        QString lineText;
+        for (int i = 0; i < bestDelimiter; ++i) {
+            const auto &delimiter = delimiters.at(i);
+            if (!line.contains(delimiter.hint, Qt::CaseInsensitive)) {
                 continue;
             }
+            if (lineText.isNull()) {
+                lineText = line.toString();
+            }
+            auto it = delimiter.expression.globalMatch(lineText);
+            while (it.hasNext()) {
+                const auto match = it.next();
+                const int startOffset = lineStart + match.capturedStart(0);
+                // This is a very simplistic detection for an inline reply where we would have the patterns before the actual message content.
+                // We simply ignore anything we find within the first few lines.
+                if (startOffset >= 5) {
+                    bestDelimiter = i;
+                    bestOffset = startOffset;
+                    break;
+                }
+            }
         }
+
+        lineStart = lineEnd + 1;
     }
 
+    if (bestOffset >= 0) {
+        return {text.left(bestOffset), true};
+    }
     return {text, false};
 }
 
@@ -81,9 +133,12 @@ static QString addCss(const QString &s)
 class PartModelPrivate
 {
 public:
-    PartModelPrivate(PartModel *q_ptr, const std::shared_ptr<MimeTreeParser::ObjectTreeParser> &parser)
+    PartModelPrivate(PartModel *q_ptr,
+                     const std::shared_ptr<MimeTreeParser::ObjectTreeParser> &parser,
+                     const std::shared_ptr<AttachmentCache> &attachmentCache)
         : q(q_ptr)
         , mParser(parser)
+        , mAttachmentCache(attachmentCache)
     {
         collectContents();
     }
@@ -123,7 +178,12 @@ public:
             // NOTE: this inserts non-breaking spaces instead of regular spaces.
             const auto html = Qt::convertFromPlainText(text);
             if (trimMail) {
-                const auto result = PartModel::trim(html);
+                // The text of a part doesn't change, so the (potentially expensive) trimming survives toggling the model options.
+                auto it = mTrimmed.constFind(messagePart);
+                if (it == mTrimmed.constEnd()) {
+                    it = mTrimmed.insert(messagePart, PartModel::trim(html));
+                }
+                const auto result = it.value();
                 isTrimmed = result.second;
                 Q_EMIT q->trimMailChanged();
                 return HtmlUtils::linkify(result.first);
@@ -139,11 +199,51 @@ public:
                     return preprocessPlaintext(messagePart->plaintextContent());
                 }
             }
-            return addCss(mParser->resolveCidLinks(messagePart->htmlContent()));
+            // Inline images are shared with the attachments, so they are only decoded once. That happens on a
+            // worker thread, and the content is updated once an image is ready.
+            return addCss(mParser->resolveCidLinks(messagePart->htmlContent(), [this, messagePart](KMime::Content *node) {
+                if (!mAttachmentCache->contains(node)) {
+                    mAttachmentCache->decode(node, q, [this, messagePart](bool success) {
+                        if (success) {
+                            updateContent(messagePart);
+                        }
+                    });
+                }
+                return mAttachmentCache->data(node);
+            }));
         }
         return preprocessPlaintext(messagePart->text());
     }
 
+    void updateContent(MimeTreeParser::MessagePart *messagePart)
+    {
+        if (!mContents.contains(messagePart)) {
+            return;
+        }
+        mContents.insert(messagePart, extractContent(messagePart));
+        const auto index = indexOf(messagePart);
+        Q_EMIT q->dataChanged(index, index, {PartModel::ContentRole});
+    }
+
+    QModelIndex indexOf(MimeTreeParser::MessagePart *messagePart) const
+    {
+        if (const auto parent = mParents.value(messagePart)) {
+            const auto parts = mEncapsulatedParts.value(parent);
+            for (int row = 0; row < parts.size(); ++row) {
+                if (parts.at(row).data() == messagePart) {
+                    return q->index(row, 0, indexOf(parent));
+                }
+            }
+            return {};
+        }
+        for (int row = 0; row < mParts.size(); ++row) {
+            if (mParts.at(row).data() == messagePart) {
+                return q->index(row, 0);
+            }
+        }
+        return {};
+    }
+
     QVariant contentForPart(MimeTreeParser::MessagePart *messagePart) const
     {
         return mContents.value(messagePart);
@@ -179,15 +279,17 @@ public:
     QHash<MimeTreeParser::MessagePart *, QVector<MimeTreeParser::MessagePartPtr>> mEncapsulatedParts;
     QHash<MimeTreeParser::MessagePart *, MimeTreeParser::MessagePart *> mParents;
     QMap<MimeTreeParser::MessagePart *, QVariant> mContents;
+    QHash<MimeTreeParser::MessagePart *, std::pair<QString, bool>> mTrimmed;
     std::shared_ptr<MimeTreeParser::ObjectTreeParser> mParser;
+    std::shared_ptr<AttachmentCache> mAttachmentCache;
     bool showHtml{false};
     bool containsHtmlAndPlain{false};
     bool trimMail{false};
     bool isTrimmed{false};
 };
 
-PartModel::PartModel(std::shared_ptr<MimeTreeParser::ObjectTreeParser> parser)
-    : d(std::unique_ptr<PartModelPrivate>(new PartModelPrivate(this, parser)))
+PartModel::PartModel(std::shared_ptr<MimeTreeParser::ObjectTreeParser> parser, std::shared_ptr<AttachmentCache> attachmentCache)
+    : d(std::unique_ptr<PartModelPrivate>(new PartModelPrivate(this, parser, attachmentCache)))
 {
 }
 
@@ -15,6 +15,7 @@ namespace MimeTreeParser
 class ObjectTreeParser;
 }
 class PartModelPrivate;
+class AttachmentCache;
 
 class PartModel : public QAbstractItemModel
 {
@@ -24,7 +25,7 @@ class PartModel : public QAbstractItemModel
     Q_PROPERTY(bool trimMail READ trimMail WRITE setTrimMail NOTIFY trimMailChanged)
     Q_PROPERTY(bool isTrimmed READ isTrimmed NOTIFY trimMailChanged)
 public:
-    PartModel(std::shared_ptr<MimeTreeParser::ObjectTreeParser> parser);
+    PartModel(std::shared_ptr<MimeTreeParser::ObjectTreeParser> parser, std::shared_ptr<AttachmentCache> attachmentCache);
     ~PartModel();
 
     static std::pair<QString, bool> trim(const QString &text);
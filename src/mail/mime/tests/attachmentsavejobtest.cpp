@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include <KCodecs>
+#include <KMime/Content>
+#include <QBuffer>
+#include <QRandomGenerator>
+#include <QTest>
+
+#include "../attachmentsavejob.h"
+
+class AttachmentSaveJobTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QByteArray decodeWithKMime(KMime::Content &content, bool crlfToLf)
+    {
+        const auto decoded = content.decodedContent();
+        return crlfToLf ? KMime::CRLFtoLF(decoded) : decoded;
+    }
+
+    static QByteArray decodeInChunks(KMime::Content &content, bool crlfToLf)
+    {
+        const auto header = content.contentTransferEncoding();
+        QByteArray result;
+        QBuffer buffer(&result);
+        buffer.open(QIODevice::WriteOnly);
+        if (!AttachmentSaveJob::decode(content.body(), header->encoding(), header->isDecoded(), crlfToLf, &buffer)) {
+            return QByteArray("decoding failed");
+        }
+        return result;
+    }
+
+    // Text with CRLF line endings that fall on every possible chunk boundary
+    static QByteArray generateText(qint64 minimumSize)
+    {
+        QByteArray text;
+        for (int i = 0; text.size() < minimumSize; ++i) {
+            text += QByteArray(i % 97, 'a') + "\r\n";
+            if (i % 13 == 0) {
+                text += "\r\r\n\r";
+            }
+        }
+        return text + "\r\n";
+    }
+
+private Q_SLOTS:
+    void testDecode_data()
+    {
+        QTest::addColumn<QByteArray>("encoded");
+        QTest::addColumn<int>("encoding");
+        QTest::addColumn<bool>("crlfToLf");
+
+        QByteArray binary(3 * AttachmentSaveJob::chunkSize + 17, Qt::Uninitialized);
+        QRandomGenerator random(42);
+        for (auto &byte : binary) {
+            byte = char(random.bounded(256));
+        }
+        const auto text = generateText(3 * AttachmentSaveJob::chunkSize);
+
+        QTest::newRow("empty") << QByteArray() << int(KMime::Headers::CEbase64) << false;
+        QTest::newRow("base64 binary") << KCodecs::base64Encode(binary) << int(KMime::Headers::CEbase64) << false;
+        QTest::newRow("base64 text") << KCodecs::base64Encode(text) << int(KMime::Headers::CEbase64) << true;
+        QTest::newRow("quoted-printable text") << KCodecs::quotedPrintableEncode(text, false) << int(KMime::Headers::CEquPr) << true;
+        QTest::newRow("8bit text") << text << int(KMime::Headers::CE8Bit) << true;
+        QTest::newRow("8bit trailing newline") << QByteArray("line\r\nline\n") << int(KMime::Headers::CE8Bit) << false;
+        QTest::newRow("binary") << binary << int(KMime::Headers::CEbinary) << false;
+    }
+
+    void testDecode()
+    {
+        QFETCH(QByteArray, encoded);
+        QFETCH(int, encoding);
+        QFETCH(bool, crlfToLf);
+
+        KMime::Headers::ContentTransferEncoding header;
+        header.setEncoding(static_cast<KMime::Headers::contentEncoding>(encoding));
+
+        KMime::Content content;
+        content.setContent("Content-Transfer-Encoding: " + header.as7BitString(false) + "\n\n" + encoded);
+        content.parse();
+        QCOMPARE(decodeInChunks(content, crlfToLf), decodeWithKMime(content, crlfToLf));
+    }
+
+    void testAlreadyDecoded()
+    {
+        // A body set on a new part is already decoded, whatever encoding it will be sent with
+        KMime::Content content;
+        content.setBody("line\r\nline\n");
+        content.contentTransferEncoding()->setEncoding(KMime::Headers::CEbase64);
+        content.contentTransferEncoding()->setDecoded(true);
+
+        QCOMPARE(decodeInChunks(content, false), decodeWithKMime(content, false));
+        QCOMPARE(decodeInChunks(content, false), QByteArray("line\r\nline"));
+    }
+
+    void testCancel()
+    {
+        const auto encoded = KCodecs::base64Encode(QByteArray(4 * AttachmentSaveJob::chunkSize, 'a'));
+        QByteArray result;
+        QBuffer buffer(&result);
+        buffer.open(QIODevice::WriteOnly);
+
+        int calls = 0;
+        QVERIFY(!AttachmentSaveJob::decode(encoded, KMime::Headers::CEbase64, false, false, &buffer, [&calls](qint64) {
+            return ++calls < 2;
+        }));
+        QCOMPARE(calls, 2);
+        QVERIFY(result.size() <= 2 * AttachmentSaveJob::chunkSize);
+    }
+};
+
+QTEST_GUILESS_MAIN(AttachmentSaveJobTest)
+#include "attachmentsavejobtest.moc"
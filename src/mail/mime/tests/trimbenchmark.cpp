@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+#include <QTest>
+#include <QTextDocument>
+#include <benchmarkhelper.h>
+
+#include "../partmodel.h"
+
+class TrimBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    // A reply on top of a long chain of quoted replies, as plain text converted to html like PartModel does.
+    static QString generateReply(int quoteLevels, int linesPerLevel)
+    {
+        QString text = QStringLiteral("Thanks, that works for me.\n\n");
+        for (int level = 1; level <= quoteLevels; ++level) {
+            const QString prefix = QStringLiteral("&gt; ").repeated(level - 1);
+            text += prefix + QStringLiteral("On Monday, 1 May 2023 12:00:00 CEST Someone wrote:\n");
+            for (int line = 0; line < linesPerLevel; ++line) {
+                text += prefix + QStringLiteral("> Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor.\n");
+            }
+            text += QLatin1Char('\n');
+        }
+        return Qt::convertFromPlainText(text);
+    }
+
+private Q_SLOTS:
+    void init()
+    {
+        KALENDAR_SKIP_BENCHMARKS();
+    }
+
+    void testTrim_data()
+    {
+        QTest::addColumn<QString>("text");
+        QTest::addColumn<QString>("expected");
+        QTest::addColumn<bool>("trimmed");
+
+        QTest::newRow("nothing to trim") << QStringLiteral("<p>Hello<br>\nWorld</p>") << QStringLiteral("<p>Hello<br>\nWorld</p>") << false;
+        QTest::newRow("original message") << QStringLiteral("<p>Hi</p>\n<p>-----Original Message-----<br>\nFrom: me</p>") << QStringLiteral("<p>Hi</p>\n")
+                                          << true;
+        QTest::newRow("on wrote") << QStringLiteral("<p>Hi</p>\n<p>On Monday you wrote:<br>\n&gt; text</p>") << QStringLiteral("<p>Hi</p>\n") << true;
+        QTest::newRow("german reply") << QStringLiteral("<p>Hallo</p>\n<p>Am Montag schrieb jemand:</p>") << QStringLiteral("<p>Hallo</p>\n") << true;
+        QTest::newRow("signature") << QStringLiteral("<p>Hi<br>\n</p>\n<p>-- <br>\nMe</p>") << QStringLiteral("<p>Hi<br>\n</p>\n") << true;
+        // The first delimiter wins even if a later one appears earlier in the text
+        QTest::newRow("priority") << QStringLiteral("<p>Hi</p>\n<p>-- <br>\nMe</p>\n<p>On Monday you wrote:</p>") << QStringLiteral("<p>Hi</p>\n<p>-- <br>\nMe</p>\n")
+                                  << true;
+        // Inline replies start with the quote header, which is ignored
+        QTest::newRow("inline reply") << QStringLiteral("<p>On Monday you wrote:</p>\n<p>Answer</p>") << QStringLiteral("<p>On Monday you wrote:</p>\n<p>Answer</p>")
+                                      << false;
+    }
+
+    void testTrim()
+    {
+        QFETCH(QString, text);
+        QFETCH(QString, expected);
+        QFETCH(bool, trimmed);
+
+        const auto result = PartModel::trim(text);
+        QCOMPARE(result.first, expected);
+        QCOMPARE(result.second, trimmed);
+    }
+
+    void benchmarkTrim_data()
+    {
+        QTest::addColumn<QString>("text");
+
+        QTest::newRow("short") << generateReply(2, 10);
+        QTest::newRow("long quote chain") << generateReply(50, 200);
+        QTest::newRow("no delimiter") << Qt::convertFromPlainText(QStringLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing elit.\n").repeated(50000));
+    }
+
+    void benchmarkTrim()
+    {
+        QFETCH(QString, text);
+        QBENCHMARK {
+            PartModel::trim(text);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(TrimBenchmark)
+#include "trimbenchmark.moc"
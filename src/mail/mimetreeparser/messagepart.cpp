@@ -714,13 +714,9 @@ void SignedMessagePart::startVerification()
 
     // If we have a mNode, this is a detached signature
     if (mNode) {
-        const auto signature = mNode->decodedContent();
-
-        // This is necessary in case the original data contained CRLF's. Otherwise the signature will not match the data (since KMIME normalizes to LF)
-        const QByteArray signedData = KMime::LFtoCRLF(mSignedData->encodedContent());
-
-        setVerificationResult(Crypto::verifyDetachedSignature(mProtocol, signature, signedData), signedData);
-        setText(codec->toUnicode(KMime::CRLFtoLF(signedData)));
+        const auto detached = detachedSignature();
+        setVerificationResult(Crypto::verifyDetachedSignature(mProtocol, detached.signature, detached.signedData), detached.signedData);
+        setText(codec->toUnicode(KMime::CRLFtoLF(detached.signedData)));
     } else {
         QByteArray outdata;
         setVerificationResult(Crypto::verifyOpaqueSignature(mProtocol, mSignedData->decodedContent(), outdata), outdata);
@@ -732,6 +728,23 @@ void SignedMessagePart::startVerification()
     }
 }
 
+CryptoProtocol SignedMessagePart::protocol() const
+{
+    return mProtocol;
+}
+
+const Crypto::DetachedSignature &SignedMessagePart::detachedSignature() const
+{
+    if (!mDetachedSignature) {
+        mDetachedSignature.emplace();
+        if (mNode && mSignedData) {
+            // This is necessary in case the original data contained CRLF's. Otherwise the signature will not match the data (since KMIME normalizes to LF)
+            *mDetachedSignature = {mNode->decodedContent(), KMime::LFtoCRLF(mSignedData->encodedContent())};
+        }
+    }
+    return *mDetachedSignature;
+}
+
 void SignedMessagePart::setVerificationResult(const VerificationResult &result, const QByteArray &signedData)
 {
     const auto signatures = result.signatures;
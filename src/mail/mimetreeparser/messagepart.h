@@ -11,6 +11,8 @@
 #include <QSharedPointer>
 #include <QString>
 
+#include <optional>
+
 namespace KMime
 {
 class Content;
@@ -314,12 +316,18 @@ public:
 
     void startVerification();
 
+    CryptoProtocol protocol() const;
+    /// The signature and the data it covers, empty for opaque signatures
+    const Crypto::DetachedSignature &detachedSignature() const;
+
     QString plaintextContent() const Q_DECL_OVERRIDE;
     QString htmlContent() const Q_DECL_OVERRIDE;
 
 private:
     void setVerificationResult(const Crypto::VerificationResult &result, const QByteArray &signedData);
     bool mParseAfterDecryption{true};
+    // Decoded and converted once, it is needed for verifying all parts in one go and again by startVerification()
+    mutable std::optional<Crypto::DetachedSignature> mDetachedSignature;
 
 protected:
     CryptoProtocol mProtocol;
@@ -23,6 +23,8 @@
 #include <QTextStream>
 #include <QUrl>
 
+#include <map>
+
 using namespace MimeTreeParser;
 
 /*
@@ -267,17 +269,37 @@ void ObjectTreeParser::decryptAndVerify()
             return false;
         });
     // And then verify the available signatures
+    // Not selecting any parts, nested signatures would keep their parents from being selected
+    QVector<MimeTreeParser::SignedMessagePart *> signedParts;
     ::collect(
         mParsedPart,
         [](const MessagePartPtr &) {
             return true;
         },
-        [](const MessagePartPtr &part) {
-            if (const auto enc = dynamic_cast<MimeTreeParser::SignedMessagePart *>(part.data())) {
-                enc->startVerification();
+        [&signedParts](const MessagePartPtr &part) {
+            if (const auto signedPart = dynamic_cast<MimeTreeParser::SignedMessagePart *>(part.data())) {
+                signedParts << signedPart;
             }
             return false;
         });
+
+    // Verify the detached signatures in one go per protocol, the individual parts then pick up the cached results
+    std::map<CryptoProtocol, std::vector<Crypto::DetachedSignature>> detachedSignatures;
+    for (const auto signedPart : std::as_const(signedParts)) {
+        auto detached = signedPart->detachedSignature();
+        if (!detached.signature.isEmpty()) {
+            detachedSignatures[signedPart->protocol()].push_back(std::move(detached));
+        }
+    }
+    for (const auto &signatures : detachedSignatures) {
+        if (signatures.second.size() > 1) {
+            Crypto::verifyDetachedSignatures(signatures.first, signatures.second);
+        }
+    }
+
+    for (const auto signedPart : std::as_const(signedParts)) {
+        signedPart->startVerification();
+    }
 }
 
 void ObjectTreeParser::importCertificates()
@@ -295,7 +317,7 @@ void ObjectTreeParser::importCertificates()
         });
 }
 
-QString ObjectTreeParser::resolveCidLinks(const QString &html)
+QString ObjectTreeParser::resolveCidLinks(const QString &html, const std::function<QByteArray(KMime::Content *)> &decodedContent)
 {
     auto text = html;
     static const auto regex = QRegularExpression(QLatin1String("(src)\\s*=\\s*(\"|')(cid:[^\"']+)\\2"));
@@ -320,9 +342,9 @@ QString ObjectTreeParser::resolveCidLinks(const QString &html)
             const auto mimetype = mimeDb.mimeTypeForName(QString::fromLatin1(contentType->mimeType())).name();
             if (mimetype.startsWith(QLatin1String("image/"))) {
                 // We reencode to base64 below.
-                const auto data = mailMime->decodedContent();
+                const auto data = decodedContent ? decodedContent(mailMime) : mailMime->decodedContent();
+                // Also empty while it is still being decoded
                 if (data.isEmpty()) {
-                    qWarning() << "Attachment is empty.";
                     continue;
                 }
                 text.replace(match.captured(0), QString::fromLatin1("src=\"data:%1;base64,%2\"").arg(mimetype, QString::fromLatin1(data.toBase64())));
@@ -73,8 +73,13 @@ public:
     /** Import any certificates found in the message */
     void importCertificates();
 
-    /** Embedd content referenced by cid by inlining */
-    QString resolveCidLinks(const QString &html);
+    /**
+     * Embedd content referenced by cid by inlining
+     *
+     * @p decodedContent can provide the decoded content of the referenced parts, instead of decoding them again.
+     * Parts it returns no content for are left as they are.
+     */
+    QString resolveCidLinks(const QString &html, const std::function<QByteArray(KMime::Content *)> &decodedContent = {});
 
 private:
     /**
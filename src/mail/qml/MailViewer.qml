@@ -142,6 +142,8 @@ QQC2.Page {
                     name: model.name
                     type: model.type
                     icon.name: model.iconName
+                    saving: model.saving
+                    saveProgress: model.saveProgress
 
                     clip: true
 
@@ -149,6 +151,7 @@ QQC2.Page {
                     actionTooltip: i18n("Save attachment")
                     onExecute: mailPartView.attachmentModel.saveAttachmentToDisk(mailPartView.attachmentModel.index(index, 0))
                     onClicked: mailPartView.attachmentModel.openAttachment(mailPartView.attachmentModel.index(index, 0))
+                    onCancelSave: mailPartView.attachmentModel.cancelSave(mailPartView.attachmentModel.index(index, 0))
                     onPublicKeyImport: mailPartView.attachmentModel.importPublicKey(mailPartView.attachmentModel.index(index, 0))
                 }
             }
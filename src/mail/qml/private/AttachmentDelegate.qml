@@ -12,9 +12,12 @@ QQC2.AbstractButton {
 
     property string name
     property string type
+    property bool saving: false
+    property real saveProgress: 0
     property alias actionIcon: actionButton.icon.name
     property alias actionTooltip: actionButtonTooltip.text
     signal execute;
+    signal cancelSave;
     signal publicKeyImport;
 
     Kirigami.Theme.colorSet: Kirigami.Theme.Button
@@ -49,6 +52,11 @@ QQC2.AbstractButton {
         QQC2.Label {
             text: root.name
         }
+        QQC2.ProgressBar {
+            visible: root.saving
+            value: root.saveProgress
+            Layout.preferredWidth: Kirigami.Units.gridUnit * 4
+        }
         QQC2.ToolButton {
             visible: root.type === "application/pgp-keys"
             icon.name: 'gpg'
@@ -57,8 +65,17 @@ QQC2.AbstractButton {
                 text: i18n("Import key")
             }
         }
+        QQC2.ToolButton {
+            visible: root.saving
+            icon.name: 'dialog-cancel'
+            onClicked: root.cancelSave()
+            QQC2.ToolTip {
+                text: i18n("Cancel")
+            }
+        }
         QQC2.ToolButton {
             id: actionButton
+            visible: !root.saving
             onClicked: root.execute()
             QQC2.ToolTip {
                 id: actionButtonTooltip
@@ -209,6 +209,19 @@ private Q_SLOTS:
         QCOMPARE(result.signatures.size(), 1);
         QVERIFY(result.signatures[0].fingerprint.contains(QByteArray{"8D9860C58F246DE6"}));
         QCOMPARE(result.signatures[0].result, Crypto::Signature::Ok);
+
+        // Verified in a batch, together with a signature that doesn't match its data
+        const auto results = Crypto::verifyDetachedSignatures(Crypto::OpenPGP, {{signature, signedData}, {signature, signedData + "tampered"}});
+        QCOMPARE(results.size(), 2);
+        QCOMPARE(results[0].signatures.size(), 1);
+        QCOMPARE(results[0].signatures[0].result, Crypto::Signature::Ok);
+        QCOMPARE(results[1].signatures.size(), 1);
+        QCOMPARE(results[1].signatures[0].result, Crypto::Signature::Invalid);
+
+        // Repeated verification is served from the cache and must not be affected by the batch
+        const auto cachedResult = Crypto::verifyDetachedSignature(Crypto::OpenPGP, signature, signedData);
+        QCOMPARE(cachedResult.signatures.size(), 1);
+        QCOMPARE(cachedResult.signatures[0].result, Crypto::Signature::Ok);
     }
 
     void testVerifyOpaqueSignature()
@@ -226,6 +239,12 @@ private Q_SLOTS:
         QVERIFY(result.signatures[0].fingerprint.contains(QByteArray{"8D9860C58F246DE6"}));
         QCOMPARE(result.signatures[0].result, Crypto::Signature::Ok);
         QCOMPARE(outdata, QByteArray{"ohno \xF6\xE4\xFC\n"});
+
+        QByteArray cachedOutdata;
+        const auto cachedResult = Crypto::verifyOpaqueSignature(Crypto::OpenPGP, signedData, cachedOutdata);
+        QCOMPARE(cachedResult.signatures.size(), 1);
+        QCOMPARE(cachedResult.signatures[0].result, Crypto::Signature::Ok);
+        QCOMPARE(cachedOutdata, outdata);
     }
 };
 
@@ -8,17 +8,14 @@
 
 #include "collectioncomboboxmodel.h"
 
-#include <Akonadi/CollectionFetchScope>
 #include <Akonadi/CollectionFilterProxyModel>
 #include <Akonadi/CollectionUtils>
 #include <Akonadi/EntityRightsFilterModel>
 #include <Akonadi/EntityTreeModel>
-#include <Akonadi/Monitor>
-#include <Akonadi/Session>
 
 #include <KDescendantsProxyModel>
 
-#include "colorproxymodel.h"
+#include "sharedcollectiontree.h"
 #include <QAbstractItemModel>
 
 using namespace Akonadi::Quick;
@@ -28,22 +25,9 @@ class Akonadi::Quick::CollectionComboBoxModelPrivate
 public:
     CollectionComboBoxModelPrivate(CollectionComboBoxModel *parent)
         : mParent(parent)
+        , mCollectionTree(SharedCollectionTree::instance())
     {
-        mMonitor = new Akonadi::Monitor(mParent);
-        mMonitor->setObjectName(QStringLiteral("CollectionComboBoxMonitor"));
-        mMonitor->fetchCollection(true);
-        mMonitor->setCollectionMonitored(Akonadi::Collection::root());
-
-        // This ETM will be set to only show collections with the wanted mimetype in setMimeTypeFilter
-        auto entityModel = new Akonadi::EntityTreeModel(mMonitor, mParent);
-        entityModel->setItemPopulationStrategy(Akonadi::EntityTreeModel::NoItemPopulation);
-        entityModel->setListFilter(Akonadi::CollectionFetchScope::Display);
-
-        // Display color
-        auto colorProxy = new ColorProxyModel(mParent);
-        colorProxy->setObjectName(QStringLiteral("Show collection colors"));
-        colorProxy->setDynamicSortFilter(true);
-        colorProxy->setSourceModel(entityModel);
+        // The shared tree has the collections of all mimetypes, they are filtered in setMimeTypeFilter
 
         // Flatten the tree, e.g.
         // Kolab
@@ -51,7 +35,7 @@ public:
         // Kolab / Inbox / Calendar
         auto proxyModel = new KDescendantsProxyModel(parent);
         proxyModel->setDisplayAncestorData(true);
-        proxyModel->setSourceModel(colorProxy);
+        proxyModel->setSourceModel(mCollectionTree->model());
 
         // Filter it by mimetype again, to only keep
         // Kolab / Inbox / Calendar
@@ -73,13 +57,11 @@ public:
         });
     }
 
-    ~CollectionComboBoxModelPrivate() = default;
-
     bool scanSubTree();
 
     CollectionComboBoxModel *const mParent;
 
-    Akonadi::Monitor *mMonitor = nullptr;
+    const SharedCollectionTree::Ptr mCollectionTree;
     Akonadi::CollectionFilterProxyModel *mMimeTypeFilterModel = nullptr;
     Akonadi::EntityRightsFilterModel *mRightsFilterModel = nullptr;
     qint64 mDefaultCollectionId = -1;
@@ -112,12 +94,6 @@ void CollectionComboBoxModel::setMimeTypeFilter(const QStringList &contentMimeTy
 {
     d->mMimeTypeFilterModel->clearFilters();
     d->mMimeTypeFilterModel->addMimeTypeFilters(contentMimeTypes);
-
-    if (d->mMonitor) {
-        for (const QString &mimeType : contentMimeTypes) {
-            d->mMonitor->setMimeTypeMonitored(mimeType, true);
-        }
-    }
 }
 
 QStringList CollectionComboBoxModel::mimeTypeFilter() const
@@ -7,15 +7,12 @@
 
 #include "collectionpickermodel.h"
 
-#include <Akonadi/CollectionFetchScope>
 #include <Akonadi/CollectionFilterProxyModel>
 #include <Akonadi/CollectionUtils>
 #include <Akonadi/EntityRightsFilterModel>
 #include <Akonadi/EntityTreeModel>
-#include <Akonadi/Monitor>
-#include <Akonadi/Session>
 
-#include "colorproxymodel.h"
+#include "sharedcollectiontree.h"
 #include "sortedcollectionproxymodel.h"
 #include <QAbstractItemModel>
 
@@ -26,28 +23,13 @@ class Akonadi::Quick::CollectionPickerModelPrivate
 public:
     CollectionPickerModelPrivate(CollectionPickerModel *parent)
         : mParent(parent)
+        , mCollectionTree(SharedCollectionTree::instance())
     {
-        mMonitor = new Akonadi::Monitor(mParent);
-        mMonitor->setObjectName(QStringLiteral("CollectionPickerMonitor"));
-        mMonitor->fetchCollection(true);
-        mMonitor->setCollectionMonitored(Akonadi::Collection::root());
-
-        // This ETM will be set to only show collections with the wanted mimetype in setMimeTypeFilter
-        mModel = new Akonadi::EntityTreeModel(mMonitor, mParent);
-        mModel->setItemPopulationStrategy(Akonadi::EntityTreeModel::NoItemPopulation);
-        mModel->setListFilter(Akonadi::CollectionFetchScope::Display);
-
-        mBaseModel = mModel;
-
-        // Display color
-        auto colorProxy = new ColorProxyModel(mParent);
-        colorProxy->setObjectName(QStringLiteral("Show collection colors"));
-        colorProxy->setDynamicSortFilter(true);
-        colorProxy->setSourceModel(mBaseModel);
+        // The shared tree has the collections of all mimetypes, they are filtered in setMimeTypeFilter
 
         // Filter by access rights. TODO: maybe this functionality could be provided by CollectionFilterProxyModel, to save one proxy?
         mRightsFilterModel = new Akonadi::EntityRightsFilterModel(parent);
-        mRightsFilterModel->setSourceModel(colorProxy);
+        mRightsFilterModel->setSourceModel(mCollectionTree->model());
 
         mMimeTypeFilterModel = new SortedCollectionProxModel(parent);
         mMimeTypeFilterModel->setSourceModel(mRightsFilterModel);
@@ -57,16 +39,12 @@ public:
         mParent->setSourceModel(mMimeTypeFilterModel);
     }
 
-    ~CollectionPickerModelPrivate() = default;
-
     void activated(int index);
     void activated(const QModelIndex &index);
 
     CollectionPickerModel *const mParent;
 
-    Akonadi::Monitor *mMonitor = nullptr;
-    Akonadi::EntityTreeModel *mModel = nullptr;
-    QAbstractItemModel *mBaseModel = nullptr;
+    const SharedCollectionTree::Ptr mCollectionTree;
     Akonadi::CollectionFilterProxyModel *mMimeTypeFilterModel = nullptr;
     Akonadi::EntityRightsFilterModel *mRightsFilterModel = nullptr;
 };
@@ -83,12 +61,6 @@ void CollectionPickerModel::setMimeTypeFilter(const QStringList &contentMimeType
 {
     d->mMimeTypeFilterModel->clearFilters();
     d->mMimeTypeFilterModel->addMimeTypeFilters(contentMimeTypes);
-
-    if (d->mMonitor) {
-        for (const QString &mimeType : contentMimeTypes) {
-            d->mMonitor->setMimeTypeMonitored(mimeType, true);
-        }
-    }
 }
 
 QStringList CollectionPickerModel::mimeTypeFilter() const
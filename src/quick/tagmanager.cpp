@@ -3,17 +3,19 @@
 
 #include "tagmanager.h"
 #include "akonadi_quick_debug.h"
+#include "deduplicatingproxymodel.h"
+#include "tagregistry.h"
 
 #include <Akonadi/TagCreateJob>
 #include <Akonadi/TagDeleteJob>
 #include <Akonadi/TagModifyJob>
 #include <KDescendantsProxyModel>
 
-class FlatTagModel : public QSortFilterProxyModel
+class FlatTagModel : public DeduplicatingProxyModel
 {
 public:
     explicit FlatTagModel(QObject *parent = nullptr)
-        : QSortFilterProxyModel(parent)
+        : DeduplicatingProxyModel(Akonadi::TagModel::NameRole, parent)
     {
         auto monitor = new Akonadi::Monitor(this);
         monitor->setObjectName(QStringLiteral("TagModelMonitor"));
@@ -39,19 +41,6 @@ public:
 
         return rolenames;
     }
-
-protected:
-    bool filterAcceptsRow(int row, const QModelIndex &sourceParent) const override
-    {
-        // Eliminate duplicate tag names
-        const QModelIndex sourceIndex = sourceModel()->index(row, 0, sourceParent);
-        Q_ASSERT(sourceIndex.isValid());
-
-        auto data = sourceIndex.data(Akonadi::TagModel::NameRole);
-        auto matches = match(index(0, 0), Akonadi::TagModel::NameRole, data, 2, Qt::MatchExactly | Qt::MatchWrap | Qt::MatchRecursive);
-
-        return matches.length() < 2;
-    }
 };
 
 TagManager::TagManager(QObject *parent)
@@ -65,6 +54,28 @@ TagManager::TagManager(QObject *parent)
     QObject::connect(m_tagModel, &QSortFilterProxyModel::rowsInserted, this, &TagManager::tagModelChanged);
     QObject::connect(m_tagModel, &QSortFilterProxyModel::rowsMoved, this, &TagManager::tagModelChanged);
     QObject::connect(m_tagModel, &QSortFilterProxyModel::rowsRemoved, this, &TagManager::tagModelChanged);
+
+    // Lets tag filters follow renamed tags
+    QObject::connect(m_tagModel, &QSortFilterProxyModel::rowsInserted, this, [this](const QModelIndex &, int first, int last) {
+        registerTags(first, last);
+    });
+    QObject::connect(m_tagModel, &QSortFilterProxyModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        registerTags(topLeft.row(), bottomRight.row());
+    });
+    QObject::connect(m_tagModel, &QSortFilterProxyModel::modelReset, this, [this]() {
+        registerTags(0, m_tagModel->rowCount() - 1);
+    });
+    registerTags(0, m_tagModel->rowCount() - 1);
+}
+
+void TagManager::registerTags(int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        const auto tag = m_tagModel->index(row, 0).data(Akonadi::TagModel::TagRole).value<Akonadi::Tag>();
+        if (tag.isValid()) {
+            TagRegistry::instance()->setAkonadiTag(tag);
+        }
+    }
 }
 
 QSortFilterProxyModel *TagManager::tagModel()
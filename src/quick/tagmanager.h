@@ -26,5 +26,7 @@ Q_SIGNALS:
     void tagModelChanged();
 
 private:
+    void registerTags(int first, int last);
+
     QSortFilterProxyModel *m_tagModel = nullptr;
 };